@@ -67,4 +67,6 @@
 
 #define FRUIT_HAS_BUILTIN_UNREACHABLE 1
 
+#define FRUIT_HAS_BUILTIN_PREFETCH 1
+
 #endif // FRUIT_CONFIG_BASE_H
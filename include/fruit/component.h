@@ -120,6 +120,24 @@ class Component {
  */
 PartialComponent<> createComponent();
 
+/**
+ * Injectors and NormalizedComponents remember the bindings of the component functions with no args that they install,
+ * so that installing the same function again (in any injector or NormalizedComponent, in any thread) doesn't call it
+ * again. Since the function is identified by its address, this must be called before unloading a shared library that
+ * contains a component function that was installed this way, or if the function might return different bindings the
+ * next time that it's called.
+ *
+ * This removes the bindings remembered for `getComponent', so that it will be called again the next time that it's
+ * installed.
+ */
+template <typename... Params>
+void evictComponentFromCache(Component<Params...>(*getComponent)());
+
+/**
+ * Same as evictComponentFromCache(), but for all component functions.
+ */
+void clearComponentCache();
+
 /**
  * A partially constructed component.
  * 
@@ -141,6 +159,45 @@ PartialComponent<> createComponent();
  * }
  * 
  * Note that no variable of type PartialComponent has been declared; this class should only be used for temporary values.
+ * 
+ * Injectors place the objects that they construct next to each other in memory, so two objects can share a cache line.
+ * If a type is written frequently from different threads (e.g. a stats object), you can avoid false sharing by
+ * specializing fruit::IsolatedInCacheLine for it:
+ * 
+ * namespace fruit {
+ * template <>
+ * struct IsolatedInCacheLine<Stats> : public std::true_type {};
+ * }
+ * 
+ * Injectors then place each Stats object that they construct on its own cache line(s), however it's bound. The
+ * specialization must be visible wherever the type is injected. The cache line size is FRUIT_CACHE_LINE_SIZE (64 by
+ * default). With FRUIT_EXTRA_DEBUG defined, each injector prints the objects that share a cache line to stderr when
+ * destroyed.
+ * 
+ * Similarly, injectors never destroy the objects of the types marked with fruit::ProcessLifetime, e.g. for singletons
+ * whose destructors only free memory and that live until the process exits anyway:
+ * 
+ * namespace fruit {
+ * template <>
+ * struct ProcessLifetime<Cache> : public std::true_type {};
+ * }
+ * 
+ * This also skips their registration for destruction, so destroying an injector with many such objects is cheaper.
+ * To leak all the objects of an injector instead, see Injector::setProcessLifetime().
+ * 
+ * Objects of small types that are read very often (e.g. a struct wrapping an int) can instead be stored by injectors
+ * next to their bookkeeping data for the type, so that getting them doesn't need a further memory access. This is
+ * opt-in, by specializing fruit::StoredInline for the type:
+ * 
+ * namespace fruit {
+ * template <>
+ * struct StoredInline<Port> : public std::true_type {};
+ * }
+ * 
+ * The type must be trivially copyable and trivially destructible, and at most as large (and aligned) as a pointer.
+ * This only affects the objects that injectors construct by calling the type's constructor (e.g. with INJECT or
+ * registerConstructor()); those are constructed in place, so the `this' seen by the constructor is the address
+ * returned by get().
  */
 template<typename... Bindings>
 class PartialComponent {
@@ -193,6 +250,30 @@ public:
   template<typename Signature>
   PartialComponent<fruit::impl::RegisterConstructor<Signature>, Bindings...> registerConstructor();
 
+  /**
+   * Similar to registerConstructor(), but the injector constructs a separate instance of the type for each thread that
+   * gets it (e.g. for counters, scratch buffers or random number generators, that must not be shared across threads).
+   * 
+   * Example usage:
+   * 
+   * fruit::createComponent()
+   *     .registerThreadLocal<Counter(Clock*)>() // Registers the constructor Counter::Counter(Clock*)
+   * 
+   * The instance for a thread is constructed the first time that thread gets it from the injector, and it's destroyed
+   * when the thread exits or when the injector is destroyed, whichever happens first.
+   * Once the dependencies of the type have been constructed (e.g. using Injector::eagerlyInjectAll()), the type can be
+   * injected concurrently from multiple threads, with no locking.
+   * 
+   * Note that an object that depends on a thread-local type (other than through bind<>()) is still constructed once per
+   * injector, and it gets the instance of the thread that constructed it. Inject a Provider<> instead to get the
+   * instance of the current thread each time.
+   * 
+   * This supports annotated injection, just wrap the desired types (return type and/or argument types of the signature)
+   * with fruit::Annotated<> if desired.
+   */
+  template<typename Signature>
+  PartialComponent<fruit::impl::RegisterThreadLocal<Signature>, Bindings...> registerThreadLocal();
+
   /**
    * Use this method to bind the type C to a specific instance.
    * The caller must ensure that the provided reference is valid for the entire lifetime of the component and of any components
@@ -268,7 +349,17 @@ public:
    * })
    * 
    * As in the previous example, it's not necessary to specify the type parameter, it will be inferred by the compiler.
-   * 
+   *
+   * The provider can also construct the C directly in the injector's storage (avoiding both the move and the allocation)
+   * by taking a fruit::Emplacer<C> as its first parameter and returning the result of calling it. The other parameters
+   * are injected as usual. See Emplacer for details. E.g.:
+   *
+   * registerProvider([](fruit::Emplacer<Foo> emplace, Bar* bar, Baz* baz) {
+   *    Foo* foo = emplace(bar, baz);
+   *    foo->initialize();
+   *    return foo;
+   * })
+   *
    * registerProvider() can't be called with a plain function, but you can write a lambda that wraps the function to achieve the
    * same result.
    * 
@@ -426,6 +517,9 @@ public:
    * 
    * C can NOT be a pointer type. If you don't want to return by value, return a std::unique_ptr instead of a naked pointer.
    * 
+   * If C is a class type (not a std::unique_ptr), injecting a std::function<fruit::PooledPtr<C>(...)> will create the C
+   * objects in a pool owned by the injector instead of allocating each of them with new. See PooledPtr for details.
+   * 
    * Example:
    * 
    * Component<std::function<std::unique_ptr<MyClass>(int)>> getMyClassComponent() {
@@ -524,6 +618,9 @@ public:
    *
    * These two install() calls are equivalent to the previous ones.
    *
+   * Component functions with no args are expected to always return the same bindings. Fruit calls each of them at most
+   * once per process, and reuses the resulting bindings when creating other injectors (or NormalizedComponents).
+   *
    * As in the example, the template parameters for this method will be inferred by the compiler, it's not necessary to
    * specify them explicitly.
    */
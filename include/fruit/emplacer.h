@@ -0,0 +1,66 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_EMPLACER_H
+#define FRUIT_EMPLACER_H
+
+#include <fruit/fruit_forward_decls.h>
+#include <fruit/impl/fruit_internal_forward_decls.h>
+
+namespace fruit {
+
+/**
+ * An Emplacer<C> is passed to providers that construct their C object directly in the injector's storage, instead of
+ * returning it by value (that would then be moved into the injector) or returning a C* allocated with new (that would
+ * require a separate heap allocation). Such a provider takes an Emplacer<C> as its first parameter and returns the
+ * result of calling it. For example:
+ *
+ * registerProvider([](fruit::Emplacer<Foo> emplace, Bar* bar, Baz* baz) {
+ *    Foo* foo = emplace(bar, baz);
+ *    foo->initialize();
+ *    return foo;
+ * })
+ *
+ * The Emplacer must be called exactly once, and the provider must return the resulting pointer (otherwise the program
+ * will abort). If the provider throws an exception after constructing the object, the object will not be destroyed.
+ */
+template <typename C>
+class Emplacer {
+public:
+  /**
+   * Constructs the C object with the specified arguments, as in:
+   *
+   * new C(args...)
+   *
+   * but in the storage reserved for it in the injector. The returned object is owned by the injector.
+   */
+  template <typename... Args>
+  C* operator()(Args&&... args);
+
+private:
+  // The storage for the object. This is NOT owned by the Emplacer.
+  C* storage;
+
+  explicit Emplacer(C* storage);
+
+  friend class fruit::impl::InjectorStorage;
+};
+
+} // namespace fruit
+
+#include <fruit/impl/emplacer.defn.h>
+
+#endif // FRUIT_EMPLACER_H
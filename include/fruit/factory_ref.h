@@ -0,0 +1,95 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_FACTORY_REF_H
+#define FRUIT_FACTORY_REF_H
+
+#include <fruit/fruit_forward_decls.h>
+#include <fruit/impl/fruit_internal_forward_decls.h>
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace fruit {
+
+/**
+ * A FactoryRef<C(Args...)> is a lightweight alternative to injecting a std::function<C(Args...)> factory (see
+ * PartialComponent::registerFactory). It can be injected wherever the corresponding std::function can, e.g.:
+ *
+ * class Foo {
+ * public:
+ *   INJECT(Foo(fruit::FactoryRef<std::unique_ptr<Bar>(int)> barFactory)) {
+ *     std::unique_ptr<Bar> bar = barFactory(42);
+ *     ...
+ *   }
+ * };
+ *
+ * Unlike a std::function, a FactoryRef doesn't own anything: it only holds a pointer to the factory's state (that's
+ * owned by the injector) and a pointer to the function that creates the objects, so it's cheap to copy and calls are
+ * dispatched directly to the factory. As a consequence, a FactoryRef must not be used after the injector that created
+ * it has been destroyed.
+ */
+template <typename C, typename... Args>
+class FactoryRef<C(Args...)> {
+public:
+  /**
+   * Creates an object using the factory, passing `args' as the assisted parameters.
+   */
+  C operator()(Args... args) const;
+
+  /**
+   * Creates n objects using the factory, and returns them in a single vector (so that they're stored contiguously, with
+   * a single allocation). The i-th object is created with the assisted parameters returned by args_for(i), as a
+   * std::tuple<Args...> (or just as the parameter, for factories with a single assisted parameter). E.g.:
+   *
+   * fruit::FactoryRef<Shard(int, std::string)> shardFactory = ...;
+   * std::vector<Shard> shards = shardFactory.createBatch(numShards, [&](std::size_t i) {
+   *   return std::make_tuple(int(i), names[i]);
+   * });
+   *
+   * The injected parameters of the factory are resolved once for the whole batch, and factories bound as a
+   * std::function (e.g. with bindInstance()) are called directly, without an extra indirection for each object.
+   * The factory returns each object by value, so C must be movable: each object is moved once, into the vector.
+   *
+   * There's no equivalent for an injected std::function<C(Args...)>, since std::function can't be extended. Inject a
+   * FactoryRef<C(Args...)> instead (it's available wherever the std::function is) to create batches of objects.
+   */
+  template <typename ArgsFunctor>
+  std::vector<C> createBatch(std::size_t n, ArgsFunctor args_for) const;
+
+private:
+  using invoke_t = C(*)(void*, Args...);
+
+  // The function that creates the objects, called with `state' as first argument.
+  invoke_t invoke;
+  // The state of the factory (e.g. the injected parameters). This is NOT owned by the FactoryRef.
+  void* state;
+
+  FactoryRef(invoke_t invoke, void* state);
+
+  // Used as `invoke' for factories that are just std::function objects (e.g. bound with bindInstance()), with the
+  // std::function as `state'.
+  static C invokeFunction(void* function, Args... args);
+
+  friend class fruit::impl::InjectorStorage;
+};
+
+} // namespace fruit
+
+#include <fruit/impl/factory_ref.defn.h>
+
+#endif // FRUIT_FACTORY_REF_H
@@ -29,6 +29,12 @@
 #include <fruit/normalized_component.h>
 #include <fruit/macro.h>
 #include <fruit/injector.h>
+#include <fruit/injector_reclaimer.h>
 #include <fruit/provider.h>
+#include <fruit/emplacer.h>
+#include <fruit/factory_ref.h>
+#include <fruit/pooled_ptr.h>
+#include <fruit/span.h>
+#include <fruit/memory_resource.h>
 
 #endif // FRUIT_FRUIT_H
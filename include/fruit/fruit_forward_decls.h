@@ -36,6 +36,42 @@ struct Assisted;
 template <typename Annotation, typename T>
 struct Annotated {};
 
+// Used to mark some types provided by a NormalizedComponent as shared singletons. See NormalizedComponent for details.
+template <typename... Types>
+struct SharedSingletons {};
+
+// Used as a tag to ask an Injector to allocate the storage for its objects lazily. See Injector for details.
+struct LazyObjectStorage {};
+
+// Specialize this for a type C (with a `value' field equal to true, e.g. by inheriting from std::true_type) to ask
+// injectors to place the C objects that they construct on their own cache line(s), e.g. for objects that are written
+// frequently from different threads. See PartialComponent for details.
+template <typename C>
+struct IsolatedInCacheLine {
+  static constexpr bool value = false;
+};
+
+// Specialize this for a type C (with a `value' field equal to true) to ask injectors to never destroy the C objects that
+// they construct, e.g. for singletons whose destructors only free memory. See PartialComponent for details.
+template <typename C>
+struct ProcessLifetime {
+  static constexpr bool value = false;
+};
+
+// Specialize this for a type C (with a `value' field equal to true) to ask injectors marked as process-lifetime to still
+// destroy the C objects that they constructed, e.g. for objects that flush files. See Injector for details.
+template <typename C>
+struct RunDestructorAtExit {
+  static constexpr bool value = false;
+};
+
+// Specialize this for a type C (with a `value' field equal to true) to ask injectors to construct the C objects in their
+// bookkeeping data for C, instead of in a separate memory area. See PartialComponent for details.
+template <typename C>
+struct StoredInline {
+  static constexpr bool value = false;
+};
+
 template <typename... Types>
 class Component;
 
@@ -50,9 +86,25 @@ class NormalizedComponent;
 template <typename C>
 class Provider;
 
+template <typename C>
+class Emplacer;
+
+template <typename Signature>
+class FactoryRef;
+
+template <typename C>
+class PoolDeleter;
+
+template <typename T>
+class Span;
+
 template <typename... P>
 class Injector;
 
+class InjectorReclaimer;
+
+class MemoryResource;
+
 } // namespace fruit
 
 #endif // FRUIT_FRUIT_FORWARD_DECLS_H
@@ -41,6 +41,13 @@ struct Bind {};
 template <typename Signature>
 struct RegisterConstructor {};
 
+/**
+ * Similar to RegisterConstructor, but the injector constructs a separate instance for each thread that gets it.
+ * The arguments and the return type can be annotated using fruit::Annotated<>.
+ */
+template <typename Signature>
+struct RegisterThreadLocal {};
+
 /**
  * Binds an instance (i.e., object) to the type C.
  * AnnotatedC may be annotated using fruit::Annotated<>.
@@ -21,6 +21,7 @@
 
 #include <fruit/impl/injection_errors.h>
 #include <fruit/impl/component_storage/component_storage.h>
+#include <fruit/impl/component_storage/lazy_component_with_no_args_cache.h>
 
 #include <memory>
 
@@ -62,7 +63,10 @@ inline Component<Params...>::Component(PartialComponent<Bindings...> component)
   (void)typename fruit::impl::meta::CheckIfError<fruit::impl::meta::Eval<fruit::impl::meta::CheckNoLoopInDeps(typename Op::Result)>>::type();
 #endif // !FRUIT_NO_LOOP_CHECK
 
-  std::size_t num_entries = component.storage.numBindings() + Op().numEntries();
+  // Only the bindings that add a vector of instances contribute a number of entries known only at runtime.
+  std::size_t num_entries = fruit::impl::PartialComponentStorage<Bindings...>::numStaticBindings()
+      + component.storage.numDynamicBindings()
+      + Op().numEntries();
   fruit::impl::FixedSizeVector<fruit::impl::ComponentStorageEntry> entries(num_entries);
 
   Op()(entries);
@@ -85,6 +89,16 @@ inline PartialComponent<> createComponent() {
   return {{}};
 }
 
+template <typename... Params>
+inline void evictComponentFromCache(Component<Params...>(*getComponent)()) {
+  fruit::impl::LazyComponentWithNoArgsCache::evict(
+      reinterpret_cast<fruit::impl::LazyComponentWithNoArgsCache::erased_fun_t>(getComponent));
+}
+
+inline void clearComponentCache() {
+  fruit::impl::LazyComponentWithNoArgsCache::clear();
+}
+
 template <typename... Bindings>
 template <typename AnnotatedI, typename AnnotatedC>
 inline PartialComponent<fruit::impl::Bind<AnnotatedI, AnnotatedC>, Bindings...>
@@ -105,6 +119,16 @@ PartialComponent<Bindings...>::registerConstructor() {
   return {{storage}};
 }
 
+template <typename... Bindings>
+template <typename AnnotatedSignature>
+inline PartialComponent<fruit::impl::RegisterThreadLocal<AnnotatedSignature>, Bindings...>
+PartialComponent<Bindings...>::registerThreadLocal() {
+  using Op = OpFor<fruit::impl::RegisterThreadLocal<AnnotatedSignature>>;
+  (void)typename fruit::impl::meta::CheckIfError<Op>::type();
+
+  return {{storage}};
+}
+
 template <typename... Bindings>
 template <typename C>
 inline PartialComponent<fruit::impl::BindInstance<C, C>, Bindings...>
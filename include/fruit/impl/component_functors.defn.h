@@ -24,6 +24,8 @@
 #include <fruit/impl/injector/injector_storage.h>
 
 #include <memory>
+#include <new>
+#include <utility>
 
 /*********************************************************************************************************************************
   This file contains functors that take a Comp and return a struct Op with the form:
@@ -249,30 +251,30 @@ struct AddInterfaceMultibinding {
   };
 };
 
-template <typename AnnotatedSignature, typename Lambda, typename OptionalAnnotatedI>
+// AnnotatedIs is a Vector<AnnotatedI1, ..., AnnotatedIn> with the chain of interfaces bound to the provided type (see
+// GetInterfaceBindingChain). A compressed binding is emitted for each of them, so that the whole chain can be
+// compressed into a single binding.
+template <typename AnnotatedSignature, typename Lambda, typename AnnotatedIs>
 struct PostProcessRegisterProviderHelper;
 
-template <typename AnnotatedSignature, typename Lambda, typename AnnotatedI>
-struct PostProcessRegisterProviderHelper;
+template <typename AnnotatedSignature, typename Lambda, typename AnnotatedI, typename... AnnotatedIs>
+struct PostProcessRegisterProviderHelper<AnnotatedSignature, Lambda, Vector<Type<AnnotatedI>, AnnotatedIs...>> {
+  using NextHelper = PostProcessRegisterProviderHelper<AnnotatedSignature, Lambda, Vector<AnnotatedIs...>>;
 
-template <typename AnnotatedSignature, typename Lambda, typename AnnotatedI>
-struct PostProcessRegisterProviderHelper<AnnotatedSignature, Lambda, Type<AnnotatedI>> {
   inline void operator()(FixedSizeVector<ComponentStorageEntry>& entries) {
     entries.push_back(
         InjectorStorage::createComponentStorageEntryForCompressedProvider<
             AnnotatedSignature, Lambda, AnnotatedI>());
-    entries.push_back(
-        InjectorStorage::createComponentStorageEntryForProvider<
-            AnnotatedSignature, Lambda>());
+    NextHelper()(entries);
   }
 
   std::size_t numEntries() {
-    return 2;
+    return 1 + NextHelper().numEntries();
   }
 };
 
 template <typename AnnotatedSignature, typename Lambda>
-struct PostProcessRegisterProviderHelper<AnnotatedSignature, Lambda, None> {
+struct PostProcessRegisterProviderHelper<AnnotatedSignature, Lambda, Vector<>> {
   inline void operator()(FixedSizeVector<ComponentStorageEntry>& entries) {
     entries.push_back(
         InjectorStorage::createComponentStorageEntryForProvider<
@@ -290,13 +292,13 @@ struct PostProcessRegisterProvider {
   template <typename Comp, typename AnnotatedSignature, typename Lambda>
   struct apply {
     using AnnotatedC = NormalizeType(SignatureType(AnnotatedSignature));
-    using OptionalAnnotatedI = FindValueInMap(typename Comp::InterfaceBindings, AnnotatedC);
+    using AnnotatedIs = GetInterfaceBindingChain(typename Comp::InterfaceBindings, AnnotatedC);
     struct Op {
       using Result = Comp;
 
       using Helper =
           PostProcessRegisterProviderHelper<
-              UnwrapType<AnnotatedSignature>, UnwrapType<Lambda>, Eval<OptionalAnnotatedI>>;
+              UnwrapType<AnnotatedSignature>, UnwrapType<Lambda>, Eval<AnnotatedIs>>;
       void operator()(FixedSizeVector<ComponentStorageEntry>& entries) {
         Helper()(entries);
       }
@@ -312,7 +314,7 @@ struct PreProcessRegisterProvider {
   template <typename Comp, typename AnnotatedSignature, typename Lambda>
   struct apply {
     using Signature = RemoveAnnotationsFromSignature(AnnotatedSignature);
-    using SignatureFromLambda = FunctionSignature(Lambda);
+    using SignatureFromLambda = ProviderSignature(Lambda);
     
     using AnnotatedC = NormalizeType(SignatureType(AnnotatedSignature));
     using AnnotatedCDeps = NormalizeTypeVector(SignatureArgs(AnnotatedSignature));
@@ -341,7 +343,7 @@ struct DeferredRegisterProviderWithAnnotations {
 struct DeferredRegisterProvider {
   template <typename Comp, typename Lambda>
   struct apply {
-    using type = DeferredRegisterProviderWithAnnotations(Comp, FunctionSignature(Lambda), Lambda);
+    using type = DeferredRegisterProviderWithAnnotations(Comp, ProviderSignature(Lambda), Lambda);
   };
 };
 
@@ -414,6 +416,15 @@ struct GetAssistedArg<numAssistedBefore, numNonAssistedBefore, Assisted<Arg>> {
   }
 };
 
+// The state of a factory registered with registerFactory(), i.e. its injected (non-assisted) arguments.
+// This is bound in the injector as a separate type, so that the std::function for the factory can just wrap a
+// FactoryRef that points to it (and therefore doesn't need to allocate any memory).
+// DecoratedSignature and Lambda are only there to ensure that each factory gets a distinct type.
+template <typename DecoratedSignature, typename Lambda, typename InjectedArgsTuple>
+struct FactoryState {
+  InjectedArgsTuple injected_args;
+};
+
 struct RegisterFactoryHelper {
   
   template <typename Comp,
@@ -449,32 +460,43 @@ struct RegisterFactoryHelper {
     using R = AddProvidedType(Comp, AnnotatedFunctor, Bool<true>, FunctorDeps, FunctorNonConstDeps);
     struct Op {
       using Result = Eval<R>;
+      using InjectedArgsTuple = decltype(std::make_tuple(std::declval<NakedInjectedArgs>()...));
+      using State = FactoryState<UnwrapType<DecoratedSignature>, UnwrapType<Lambda>, InjectedArgsTuple>;
+
+      static NakedC invoke(void* state, NakedUserProvidedArgs... params) {
+        InjectedArgsTuple& injected_args = static_cast<State*>(state)->injected_args;
+        auto user_provided_args = std::tie(params...);
+        // These are unused if they are 0-arg tuples. Silence the unused-variable warnings anyway.
+        (void) injected_args;
+        (void) user_provided_args;
+
+        return LambdaInvoker::invoke<UnwrapType<Lambda>, NakedAllArgs...>(
+            GetAssistedArg<
+              Eval<NumAssistedBefore(Indexes, DecoratedArgs)>::value,
+              Indexes::value - Eval<NumAssistedBefore(Indexes, DecoratedArgs)>::value,
+              // Note that the Assisted<> wrapper (if any) remains, we just remove any wrapping Annotated<>.
+              UnwrapType<Eval<RemoveAnnotations(GetNthType(Indexes, DecoratedArgs))>>
+            >()(injected_args, user_provided_args)...);
+      }
+
       void operator()(FixedSizeVector<ComponentStorageEntry>& entries) {
-        auto function_provider = [](NakedInjectedArgs... args) {
-          auto injected_args = std::make_tuple(args...);
-          auto object_provider = [injected_args](NakedUserProvidedArgs... params) mutable {
-            auto user_provided_args = std::tie(params...);
-			// These are unused if they are 0-arg tuples. Silence the unused-variable warnings anyway.
-			(void) injected_args;
-			(void) user_provided_args;
-
-			return LambdaInvoker::invoke<UnwrapType<Lambda>, NakedAllArgs...>(
-				GetAssistedArg<
-				  Eval<NumAssistedBefore(Indexes, DecoratedArgs)>::value,
-				  Indexes::value - Eval<NumAssistedBefore(Indexes, DecoratedArgs)>::value,
-				  // Note that the Assisted<> wrapper (if any) remains, we just remove any wrapping Annotated<>.
-				  UnwrapType<Eval<RemoveAnnotations(GetNthType(Indexes, DecoratedArgs))>>
-				>()(injected_args, user_provided_args)...);
-		  };
-          return NakedFunctor(object_provider);
+        auto state_provider = [](NakedInjectedArgs... args) {
+          return State{std::make_tuple(args...)};
+        };
+        auto function_provider = [](State* state) {
+          return NakedFunctor(InjectorStorage::createFactoryRef(&Op::invoke, static_cast<void*>(state)));
         };
         entries.push_back(
             InjectorStorage::createComponentStorageEntryForProvider<
-                UnwrapType<Eval<ConsSignatureWithVector(AnnotatedFunctor, Vector<InjectedAnnotatedArgs...>)>>,
+                UnwrapType<Eval<ConsSignatureWithVector(Type<State>, Vector<InjectedAnnotatedArgs...>)>>,
+                decltype(state_provider)>());
+        entries.push_back(
+            InjectorStorage::createComponentStorageEntryForProvider<
+                UnwrapType<Eval<ConsSignature(AnnotatedFunctor, Type<State*>)>>,
                 decltype(function_provider)>());
       }
       std::size_t numEntries() {
-        return 1;
+        return 2;
       }
     };
     // The first two IsValidSignature checks are a bit of a hack, they are needed to make the F2/RealF2 split
@@ -517,30 +539,28 @@ struct RegisterFactory {
 
 struct PostProcessRegisterConstructor;
 
-template <typename AnnotatedSignature, typename OptionalAnnotatedI>
+// AnnotatedIs is a Vector<AnnotatedI1, ..., AnnotatedIn>, see PostProcessRegisterProviderHelper.
+template <typename AnnotatedSignature, typename AnnotatedIs>
 struct PostProcessRegisterConstructorHelper;
 
-template <typename AnnotatedSignature, typename AnnotatedI>
-struct PostProcessRegisterConstructorHelper;
+template <typename AnnotatedSignature, typename AnnotatedI, typename... AnnotatedIs>
+struct PostProcessRegisterConstructorHelper<AnnotatedSignature, Vector<Type<AnnotatedI>, AnnotatedIs...>> {
+  using NextHelper = PostProcessRegisterConstructorHelper<AnnotatedSignature, Vector<AnnotatedIs...>>;
 
-template <typename AnnotatedSignature, typename AnnotatedI>
-struct PostProcessRegisterConstructorHelper<AnnotatedSignature, Type<AnnotatedI>> {
   inline void operator()(FixedSizeVector<ComponentStorageEntry>& entries) {
     entries.push_back(
         InjectorStorage::createComponentStorageEntryForCompressedConstructor<
             AnnotatedSignature,
             AnnotatedI>());
-    entries.push_back(
-        InjectorStorage::createComponentStorageEntryForConstructor<
-            AnnotatedSignature>());
+    NextHelper()(entries);
   }
   std::size_t numEntries() {
-    return 2;
+    return 1 + NextHelper().numEntries();
   }
 };
 
 template <typename AnnotatedSignature>
-struct PostProcessRegisterConstructorHelper<AnnotatedSignature, None> {
+struct PostProcessRegisterConstructorHelper<AnnotatedSignature, Vector<>> {
   inline void operator()(FixedSizeVector<ComponentStorageEntry>& entries) {
     entries.push_back(
         InjectorStorage::createComponentStorageEntryForConstructor<
@@ -560,7 +580,7 @@ struct PostProcessRegisterConstructor {
       using Helper =
           PostProcessRegisterConstructorHelper<
               UnwrapType<AnnotatedSignature>,
-              Eval<FindValueInMap(typename Comp::InterfaceBindings, AnnotatedC)>>;
+              Eval<GetInterfaceBindingChain(typename Comp::InterfaceBindings, AnnotatedC)>>;
       void operator()(FixedSizeVector<ComponentStorageEntry>& entries) {
         Helper()(entries);
       }
@@ -605,6 +625,34 @@ struct DeferredRegisterConstructor {
   };
 };
 
+struct PostProcessRegisterThreadLocal {
+  template <typename Comp, typename AnnotatedSignature>
+  struct apply {
+    struct type {
+      using Result = Comp;
+      // Unlike PostProcessRegisterConstructor, this never adds compressed bindings: if an interface bound to this type
+      // were compressed with it, the interface would be constructed once for the whole injector.
+      void operator()(FixedSizeVector<ComponentStorageEntry>& entries) {
+        entries.push_back(
+            InjectorStorage::createComponentStorageEntryForThreadLocal<UnwrapType<AnnotatedSignature>>());
+      }
+      std::size_t numEntries() {
+        return 1;
+      }
+    };
+  };
+};
+
+struct DeferredRegisterThreadLocal {
+  template <typename Comp, typename AnnotatedSignature>
+  struct apply {
+    using Comp1 = AddDeferredBinding(Comp,
+                                     ComponentFunctor(PostProcessRegisterThreadLocal, AnnotatedSignature));
+    // The checks and the type provided are the same as for registerConstructor().
+    using type = PreProcessRegisterConstructor(Comp1, AnnotatedSignature);
+  };
+};
+
 struct RegisterInstance {
   template <typename Comp, typename AnnotatedC, typename C, typename IsNonConst>
   struct apply {
@@ -877,6 +925,98 @@ struct AutoRegisterFactoryHelperErrorHandler {
   };
 };
 
+// The state of a factory of PooledPtr<C> objects, bound using the std::function<C(Args...)> factory of C (see
+// AutoRegisterPooledFactoryHelper). The std::function for the PooledPtr<C> factory just wraps a FactoryRef that points to
+// this object, and the C objects are constructed in slots of `pool'.
+// AnnotatedCPooledPtrFunctor is only there to ensure that each annotated factory gets a distinct type.
+template <typename AnnotatedCPooledPtrFunctor, typename C, typename... Args>
+struct PooledFactoryState {
+  FactoryRef<C(Args...)> factory;
+  ObjectPool pool;
+
+  explicit PooledFactoryState(FactoryRef<C(Args...)> factory)
+    : factory(factory), pool(sizeof(C), alignof(C)) {
+  }
+
+  static PooledPtr<C> invoke(void* state, Args... args) {
+    PooledFactoryState* self = static_cast<PooledFactoryState*>(state);
+    // If the construction fails (e.g. the constructor throws), nothing was constructed in the slot so it can be reused.
+    struct DeallocateUnlessConstructed {
+      ObjectPool& pool;
+      void* p;
+      bool constructed;
+
+      ~DeallocateUnlessConstructed() {
+        if (!constructed) {
+          pool.deallocate(p);
+        }
+      }
+    } guard{self->pool, self->pool.allocate(), false};
+    // The factory returns the C object by value all the way from the constructor (or the user's lambda), so the object
+    // is constructed directly in the slot instead of being moved there.
+    C* c = ::new (guard.p) C(self->factory(std::forward<Args>(args)...)); // LCOV_EXCL_BR_LINE
+    guard.constructed = true;
+    return InjectorStorage::createPooledPtr(c, &self->pool);
+  }
+};
+
+// Binds std::function<PooledPtr<C>(Args...)> to std::function<C(Args...)> (possibly with annotations).
+struct AutoRegisterPooledFactoryHelper {
+  template <typename Comp, typename TargetRequirements, typename TargetNonConstRequirements, typename AnnotatedCPooledPtr,
+            typename C, typename... Args>
+  struct apply {
+    using CFunctor          = ConsStdFunction(ConsSignature(C, Args...));
+    using CPooledPtrFunctor = ConsStdFunction(ConsSignature(RemoveAnnotations(AnnotatedCPooledPtr), Args...));
+    using AnnotatedCFunctor          = CopyAnnotation(AnnotatedCPooledPtr, CFunctor);
+    using AnnotatedCPooledPtrFunctor = CopyAnnotation(AnnotatedCPooledPtr, CPooledPtrFunctor);
+    using AnnotatedCFunctorRef       = CopyAnnotation(AnnotatedCPooledPtr, ConsConstReference(CFunctor));
+    
+    // As far as the checks done at compile time are concerned, this is a provider of the PooledPtr<C> factory that
+    // depends on the C factory. The actual bindings (see Op) go through the PooledFactoryState.
+    using ProvidedSignature = ConsSignature(AnnotatedCPooledPtrFunctor, AnnotatedCFunctorRef);
+    using LambdaSignature = ConsSignature(CPooledPtrFunctor, ConsConstReference(CFunctor));
+    
+    using F1 = ComponentFunctor(EnsureProvidedType,
+                                TargetRequirements, TargetNonConstRequirements, AnnotatedCFunctor, Bool<false>);
+    using F2 = ComponentFunctor(PreProcessRegisterProvider, ProvidedSignature, LambdaSignature);
+    using R = Call(ComposeFunctors(F1, F2), Comp);
+    struct Op {
+      using Result = Eval<GetResult(R)>;
+      using State = PooledFactoryState<UnwrapType<Eval<AnnotatedCPooledPtrFunctor>>, UnwrapType<C>, UnwrapType<Args>...>;
+      void operator()(FixedSizeVector<ComponentStorageEntry>& entries) {
+        auto state_provider = [](Emplacer<State> emplace, const UnwrapType<Eval<CFunctor>>& fun) {
+          return emplace(InjectorStorage::createFactoryRef(fun));
+        };
+        auto function_provider = [](State* state) {
+          return UnwrapType<Eval<CPooledPtrFunctor>>(
+              InjectorStorage::createFactoryRef(&State::invoke, static_cast<void*>(state)));
+        };
+        Eval<R>()(entries);
+        entries.push_back(
+            InjectorStorage::createComponentStorageEntryForProvider<
+                UnwrapType<Eval<ConsSignature(Type<State>, AnnotatedCFunctorRef)>>,
+                decltype(state_provider)>());
+        entries.push_back(
+            InjectorStorage::createComponentStorageEntryForProvider<
+                UnwrapType<Eval<ConsSignature(AnnotatedCPooledPtrFunctor, Type<State*>)>>,
+                decltype(function_provider)>());
+      }
+      std::size_t numEntries() {
+        return Eval<R>().numEntries() + 2;
+      }
+    };
+    
+    using ErrorHandler = AutoRegisterFactoryHelperErrorHandler<Eval<AnnotatedCFunctor>, Eval<AnnotatedCPooledPtrFunctor>>;
+    
+    // As in AutoRegisterFactoryHelper, report missing bindings for std::function<C(Args...)> as missing bindings for
+    // std::function<PooledPtr<C>(Args...)>, that's the type that the user expects.
+    using type = PropagateError(Catch(Catch(R,
+                                            NoBindingFoundErrorTag, ErrorHandler),
+                                      NoBindingFoundForAbstractClassErrorTag, ErrorHandler),
+                 Op);
+  };
+};
+
 struct AutoRegisterFactoryHelper {
   
   // General case, no way to bind it.
@@ -999,8 +1139,11 @@ struct AutoRegisterFactoryHelper {
       using Result = Eval<GetResult(R)>;
       void operator()(FixedSizeVector<ComponentStorageEntry>& entries) {
         auto provider = [](const UnwrapType<Eval<CFunctor>>& fun) {
+          // `fun' is owned by the injector, so we can capture a FactoryRef to it instead of a copy of the
+          // std::function. This is small enough to be stored inline in the returned std::function.
+          auto factory = InjectorStorage::createFactoryRef(fun);
           return UnwrapType<Eval<CUniquePtrFunctor>>([=](UnwrapType<Args>... args) {
-            NakedC* c = new NakedC(fun(args...));
+            NakedC* c = new NakedC(factory(args...));
             return std::unique_ptr<NakedC>(c);
           });
         };
@@ -1013,8 +1156,11 @@ struct AutoRegisterFactoryHelper {
       std::size_t numEntries() {
 #ifdef FRUIT_EXTRA_DEBUG
         auto provider = [](const UnwrapType<Eval<CFunctor>>& fun) {
+          // `fun' is owned by the injector, so we can capture a FactoryRef to it instead of a copy of the
+          // std::function. This is small enough to be stored inline in the returned std::function.
+          auto factory = InjectorStorage::createFactoryRef(fun);
           return UnwrapType<Eval<CUniquePtrFunctor>>([=](UnwrapType<Args>... args) {
-            NakedC* c = new NakedC(fun(args...));
+            NakedC* c = new NakedC(factory(args...));
             return std::unique_ptr<NakedC>(c);
           });
         };
@@ -1154,6 +1300,23 @@ struct AutoRegister {
                                            Id<RemoveAnnotations(Type<NakedArgs>)>...);
   };
 
+  template <typename Comp,
+            typename TargetRequirements,
+            typename TargetNonConstRequirements,
+            typename NakedC,
+            typename... NakedArgs>
+  struct apply<Comp,
+               TargetRequirements,
+               TargetNonConstRequirements,
+               Type<std::function<PooledPtr<NakedC>(NakedArgs...)>>> {
+    using type = AutoRegisterPooledFactoryHelper(Comp,
+                                                 TargetRequirements,
+                                                 TargetNonConstRequirements,
+                                                 Type<PooledPtr<NakedC>>,
+                                                 Type<NakedC>,
+                                                 Id<RemoveAnnotations(Type<NakedArgs>)>...);
+  };
+
   template <typename Comp,
             typename TargetRequirements,
             typename TargetNonConstRequirements,
@@ -1197,6 +1360,24 @@ struct AutoRegister {
                                            Type<fruit::Annotated<Annotation, std::unique_ptr<NakedC>>(NakedArgs...)>,
                                            Id<RemoveAnnotations(Type<NakedArgs>)>...);
   };
+
+  template <typename Comp,
+            typename TargetRequirements,
+            typename TargetNonConstRequirements,
+            typename Annotation,
+            typename NakedC,
+            typename... NakedArgs>
+  struct apply<Comp,
+               TargetRequirements,
+               TargetNonConstRequirements,
+               Type<fruit::Annotated<Annotation, std::function<PooledPtr<NakedC>(NakedArgs...)>>>> {
+    using type = AutoRegisterPooledFactoryHelper(Comp,
+                                                 TargetRequirements,
+                                                 TargetNonConstRequirements,
+                                                 Type<fruit::Annotated<Annotation, PooledPtr<NakedC>>>,
+                                                 Type<NakedC>,
+                                                 Id<RemoveAnnotations(Type<NakedArgs>)>...);
+  };
 };
 
 template <typename AnnotatedT>
@@ -1296,6 +1477,11 @@ struct ProcessBinding {
     using type = ComponentFunctor(DeferredRegisterConstructor, Type<Signature>);
   };
 
+  template <typename Signature>
+  struct apply<fruit::impl::RegisterThreadLocal<Signature>> {
+    using type = ComponentFunctor(DeferredRegisterThreadLocal, Type<Signature>);
+  };
+
   template <typename AnnotatedC, typename C>
   struct apply<fruit::impl::BindInstance<AnnotatedC, C>> {
     using type = ComponentFunctor(RegisterInstance, Type<AnnotatedC>, Type<C>, Bool<true>);
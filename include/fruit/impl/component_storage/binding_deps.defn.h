@@ -18,35 +18,49 @@
 #define FRUIT_BINDING_DEPS_DEFN_H
 
 #include <fruit/impl/component_storage/binding_deps.h>
+#include <fruit/fruit_forward_decls.h>
 
 namespace fruit {
 namespace impl {
 
-template <typename L>
+template <typename T>
+struct IsLazyDep : public std::false_type {};
+
+template <typename T>
+struct IsLazyDep<fruit::Provider<T>> : public std::true_type {};
+
+template <typename Annotation, typename T>
+struct IsLazyDep<fruit::Annotated<Annotation, T>> : public IsLazyDep<T> {};
+
+template <typename L, typename AnnotatedArgs, bool all_lazy>
 struct GetBindingDepsHelper;
 
-template <typename... Ts>
-struct GetBindingDepsHelper<fruit::impl::meta::Vector<fruit::impl::meta::Type<Ts>...>> {
+template <typename... Ts, typename... AnnotatedArgs, bool all_lazy>
+struct GetBindingDepsHelper<fruit::impl::meta::Vector<fruit::impl::meta::Type<Ts>...>,
+                            fruit::impl::meta::Vector<fruit::impl::meta::Type<AnnotatedArgs>...>,
+                            all_lazy> {
   inline const BindingDeps* operator()() {
     static const TypeId types[] = {getTypeId<Ts>()..., TypeId{nullptr}}; // LCOV_EXCL_BR_LINE
-    static const BindingDeps deps = {types, sizeof...(Ts)};
+    static const bool is_lazy[] = {(all_lazy || IsLazyDep<AnnotatedArgs>::value)..., false};
+    static const BindingDeps deps = {types, sizeof...(Ts), is_lazy};
     return &deps;
   }
 };
 
 // We specialize the "no Ts" case to avoid declaring types[] as an array of length 0.
-template <>
-struct GetBindingDepsHelper<fruit::impl::meta::Vector<>> {
+template <bool all_lazy>
+struct GetBindingDepsHelper<fruit::impl::meta::Vector<>, fruit::impl::meta::Vector<>, all_lazy> {
   inline const BindingDeps* operator()() {
     static const TypeId types[] = {TypeId{nullptr}};
-    static const BindingDeps deps = {types, 0};
+    static const bool is_lazy[] = {false};
+    static const BindingDeps deps = {types, 0, is_lazy};
     return &deps;
   }
 };
 
-template <typename Deps>
+template <typename Deps, typename AnnotatedArgs, bool all_lazy>
 inline const BindingDeps* getBindingDeps() {
-  return GetBindingDepsHelper<Deps>()();
+  return GetBindingDepsHelper<Deps, AnnotatedArgs, all_lazy>()();
 }
 
 } // namespace impl
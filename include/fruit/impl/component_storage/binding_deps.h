@@ -28,9 +28,15 @@ struct BindingDeps {
 
   // The size of the above array.
   std::size_t num_deps;
+
+  // A C-style array with num_deps elements. is_lazy[i] is true if deps[i] is not necessarily constructed together with
+  // the type, e.g. because it's injected through a Provider.
+  const bool* is_lazy;
 };
 
-template <typename Deps>
+// Deps are the normalized types of the deps. AnnotatedArgs are the corresponding types as injected (e.g. Provider<T>
+// instead of T), used to tell which deps are lazy. If all_lazy is true, all deps are marked as lazy.
+template <typename Deps, typename AnnotatedArgs = Deps, bool all_lazy = false>
 const BindingDeps* getBindingDeps();
 
 } // namespace impl
@@ -27,10 +27,6 @@ inline ComponentStorage::ComponentStorage(FixedSizeVector<ComponentStorageEntry>
   : entries(std::move(entries)) {
 }
 
-inline ComponentStorage::ComponentStorage(const ComponentStorage& other) {
-  *this = other;
-}
-
 inline ComponentStorage::ComponentStorage(ComponentStorage&& other) {
   *this = std::move(other);
 }
@@ -54,18 +50,9 @@ inline std::size_t ComponentStorage::numEntries() const {
   return entries.size();
 }
 
-inline ComponentStorage& ComponentStorage::operator=(const ComponentStorage& other) {
+inline ComponentStorage& ComponentStorage::operator=(ComponentStorage&& other) {
   destroy();
 
-  entries = FixedSizeVector<ComponentStorageEntry>(other.entries.size());
-  for (const ComponentStorageEntry& entry : other.entries) {
-    entries.push_back(entry.copy());
-  }
-
-  return *this;
-}
-
-inline ComponentStorage& ComponentStorage::operator=(ComponentStorage&& other) {
   entries = std::move(other.entries);
 
   // We don't want other to have any entries after this operation because we might otherwise end up destroying those
@@ -44,16 +44,19 @@ private:
 public:
   ComponentStorage() = default;
   ComponentStorage(FixedSizeVector<ComponentStorageEntry>&& entries);
-  ComponentStorage(const ComponentStorage&);
   ComponentStorage(ComponentStorage&&);
 
+  // Copying would require a deep copy of all entries (including lazy components' args), so it's forbidden.
+  // Component objects are only ever moved.
+  ComponentStorage(const ComponentStorage&) = delete;
+
   ~ComponentStorage();
 
   FixedSizeVector<ComponentStorageEntry> release() &&;
 
   std::size_t numEntries() const;
 
-  ComponentStorage& operator=(const ComponentStorage&);
+  ComponentStorage& operator=(const ComponentStorage&) = delete;
   ComponentStorage& operator=(ComponentStorage&&);
 };
 
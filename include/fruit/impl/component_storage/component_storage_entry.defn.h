@@ -18,23 +18,44 @@
 #define FRUIT_COMPONENT_STORAGE_ENTRY_DEFN_H
 
 #include <fruit/impl/component_storage/component_storage_entry.h>
+#include <fruit/impl/component_storage/lazy_component_with_no_args_cache.h>
 #include <fruit/impl/util/hash_codes.h>
 #include <fruit/impl/util/call_with_tuple.h>
 
+#include <new>
+
 namespace fruit {
 namespace impl {
 
+inline ComponentStorageEntry::Kind ComponentStorageEntry::getKind() const {
+  return Kind(kind_and_type_id & KIND_MASK);
+}
+
+inline void ComponentStorageEntry::setKind(Kind kind) {
+  FruitAssert((std::uintptr_t(kind) & ~KIND_MASK) == 0);
+  kind_and_type_id = (kind_and_type_id & ~KIND_MASK) | std::uintptr_t(kind);
+}
+
+inline TypeId ComponentStorageEntry::getTypeId() const {
+  return TypeId{reinterpret_cast<const TypeInfo*>(kind_and_type_id & ~KIND_MASK)};
+}
+
+inline void ComponentStorageEntry::setTypeId(TypeId type_id) {
+  std::uintptr_t type_info_as_int = reinterpret_cast<std::uintptr_t>(type_id.type_info);
+  FruitAssert((type_info_as_int & KIND_MASK) == 0);
+  kind_and_type_id = type_info_as_int | (kind_and_type_id & KIND_MASK);
+}
+
 // We use a custom method instead of a real copy constructor so that all copies are explicit (since copying is a
 // fairly expensive operation).
 inline ComponentStorageEntry ComponentStorageEntry::copy() const {
-  FruitAssert(kind != Kind::INVALID);
+  FruitAssert(getKind() != Kind::INVALID);
   ComponentStorageEntry result;
-  switch (kind) {
+  switch (getKind()) {
   case Kind::LAZY_COMPONENT_WITH_ARGS:
   case Kind::REPLACED_LAZY_COMPONENT_WITH_ARGS:
   case Kind::REPLACEMENT_LAZY_COMPONENT_WITH_ARGS:
-    result.kind = kind;
-    result.type_id = type_id;
+    result.kind_and_type_id = kind_and_type_id;
     result.lazy_component_with_args = lazy_component_with_args.copy();
     break;
 
@@ -47,14 +68,14 @@ inline ComponentStorageEntry ComponentStorageEntry::copy() const {
 // We use a custom method instead of a real destructor, so that we can hold these in a std::vector but still destroy
 // them when desired.
 inline void ComponentStorageEntry::destroy() const {
-  FruitAssert(kind != Kind::INVALID);
-  switch (kind) {
+  FruitAssert(getKind() != Kind::INVALID);
+  switch (getKind()) {
   case Kind::LAZY_COMPONENT_WITH_ARGS:
   case Kind::REPLACED_LAZY_COMPONENT_WITH_ARGS:
   case Kind::REPLACEMENT_LAZY_COMPONENT_WITH_ARGS:
     lazy_component_with_args.destroy();
 #ifdef FRUIT_EXTRA_DEBUG
-    kind = Kind::INVALID;
+    kind_and_type_id = (kind_and_type_id & ~KIND_MASK) | std::uintptr_t(Kind::INVALID);
 #endif
     break;
 
@@ -64,8 +85,11 @@ inline void ComponentStorageEntry::destroy() const {
 }
 
 inline ComponentStorageEntry::LazyComponentWithArgs::ComponentInterface::ComponentInterface(
-    erased_fun_t erased_fun)
-  : erased_fun(erased_fun) {
+    erased_fun_t erased_fun, const FunctionTable* function_table, std::size_t hash, bool allocated_in_memory_pool)
+  : erased_fun(erased_fun),
+    function_table(function_table),
+    hash(hash),
+    allocated_in_memory_pool(allocated_in_memory_pool) {
 }
 
 template <typename Component, typename... Args>
@@ -76,48 +100,109 @@ private:
   using fun_t = Component(*)(Args...);
   std::tuple<Args...> args_tuple;
 
-public:
-  inline ComponentInterfaceImpl(fun_t fun, std::tuple<Args...> args_tuple)
-      : ComponentInterface(reinterpret_cast<erased_fun_t>(fun)),
-        args_tuple(std::move(args_tuple)) {
-  }
-
-  inline bool areParamsEqual(
-      const ComponentStorageEntry::LazyComponentWithArgs::ComponentInterface& other) const final {
-    if (getFunTypeId() != other.getFunTypeId()) {
+  static bool areParamsEqual(const ComponentInterface& x, const ComponentInterface& y) {
+    // Different types can't have the same function table. The same type normally has a single function table, but
+    // there might be multiple ones (e.g. if the type is used in multiple shared libraries).
+    if (x.function_table != y.function_table && x.getFunTypeId() != y.getFunTypeId()) {
       return false;
     }
-    const auto& casted_other = static_cast<const ComponentInterfaceImpl<Component, Args...>&>(other);
-    return args_tuple == casted_other.args_tuple;
+    const auto& casted_x = static_cast<const ComponentInterfaceImpl&>(x);
+    const auto& casted_y = static_cast<const ComponentInterfaceImpl&>(y);
+    return casted_x.args_tuple == casted_y.args_tuple;
   }
 
-  inline void addBindings(entry_vector_t& entries) const final {
-    Component component = callWithTuple<Component, Args...>(reinterpret_cast<fun_t>(erased_fun), args_tuple);
+  static void addBindings(const ComponentInterface& x, entry_vector_t& entries) {
+    const auto& casted_x = static_cast<const ComponentInterfaceImpl&>(x);
+    Component component =
+        callWithTuple<Component, Args...>(reinterpret_cast<fun_t>(casted_x.erased_fun), casted_x.args_tuple);
     FixedSizeVector<ComponentStorageEntry> component_entries = std::move(component.storage).release();
     entries.insert(entries.end(), component_entries.begin(), component_entries.end());
   }
 
-  inline std::size_t hashCode() const final {
-    std::size_t fun_hash = std::hash<fun_t>()(reinterpret_cast<fun_t>(erased_fun));
-    std::size_t args_hash = hashTuple(args_tuple);
-    return combineHashes(fun_hash, args_hash);
+  static ComponentInterface* copy(const ComponentInterface& x, MemoryPool* memory_pool) {
+    const auto& casted_x = static_cast<const ComponentInterfaceImpl&>(x);
+    if (memory_pool == nullptr) {
+      return new ComponentInterfaceImpl(casted_x, false /* allocated_in_memory_pool */);
+    } else {
+      return new (memory_pool->allocate<ComponentInterfaceImpl>(1))
+          ComponentInterfaceImpl(casted_x, true /* allocated_in_memory_pool */);
+    }
   }
 
-  inline ComponentInterface* copy() const final {
-    return new ComponentInterfaceImpl{reinterpret_cast<fun_t>(erased_fun), args_tuple};
+  static void destroy(const ComponentInterface& x) {
+    const auto* casted_x = static_cast<const ComponentInterfaceImpl*>(&x);
+    if (casted_x->allocated_in_memory_pool) {
+      casted_x->~ComponentInterfaceImpl();
+    } else {
+      delete casted_x;
+    }
   }
 
-  inline TypeId getFunTypeId() const final {
+  static TypeId getFunTypeId() {
     return fruit::impl::getTypeId<Component(*)(Args...)>();
   }
+
+  static const FunctionTable function_table_for_type;
+
+  ComponentInterfaceImpl(const ComponentInterfaceImpl& other, bool allocated_in_memory_pool)
+      : ComponentInterface(other.erased_fun, &function_table_for_type, other.hash, allocated_in_memory_pool),
+        args_tuple(other.args_tuple) {
+  }
+
+public:
+  inline ComponentInterfaceImpl(fun_t fun, std::tuple<Args...> args_tuple)
+      : ComponentInterface(
+            reinterpret_cast<erased_fun_t>(fun),
+            &function_table_for_type,
+            combineHashes(std::hash<fun_t>()(fun), hashTuple(args_tuple)),
+            false /* allocated_in_memory_pool */),
+        args_tuple(std::move(args_tuple)) {
+  }
 };
 
+template <typename Component, typename... Args>
+const ComponentStorageEntry::LazyComponentWithArgs::ComponentInterface::FunctionTable
+    ComponentInterfaceImpl<Component, Args...>::function_table_for_type = {
+        ComponentInterfaceImpl<Component, Args...>::areParamsEqual,
+        ComponentInterfaceImpl<Component, Args...>::addBindings,
+        ComponentInterfaceImpl<Component, Args...>::copy,
+        ComponentInterfaceImpl<Component, Args...>::destroy,
+        ComponentInterfaceImpl<Component, Args...>::getFunTypeId,
+    };
+
+inline bool ComponentStorageEntry::LazyComponentWithArgs::ComponentInterface::areParamsEqual(
+    const ComponentInterface& other) const {
+  return function_table->are_params_equal(*this, other);
+}
+
+inline void ComponentStorageEntry::LazyComponentWithArgs::ComponentInterface::addBindings(
+    entry_vector_t& component_storage_entries) const {
+  function_table->add_bindings(*this, component_storage_entries);
+}
+
+inline std::size_t ComponentStorageEntry::LazyComponentWithArgs::ComponentInterface::hashCode() const {
+  return hash;
+}
+
+inline ComponentStorageEntry::LazyComponentWithArgs::ComponentInterface*
+ComponentStorageEntry::LazyComponentWithArgs::ComponentInterface::copy(MemoryPool* memory_pool) const {
+  return function_table->copy(*this, memory_pool);
+}
+
+inline void ComponentStorageEntry::LazyComponentWithArgs::ComponentInterface::destroy() const {
+  function_table->destroy(*this);
+}
+
+inline TypeId ComponentStorageEntry::LazyComponentWithArgs::ComponentInterface::getFunTypeId() const {
+  return function_table->get_fun_type_id();
+}
+
 template <typename Component, typename... Args>
 inline ComponentStorageEntry ComponentStorageEntry::LazyComponentWithArgs::create(
     Component(*fun)(Args...), std::tuple<Args...> args_tuple) {
   ComponentStorageEntry result;
-  result.type_id = getTypeId<Component(*)(Args...)>();
-  result.kind = ComponentStorageEntry::Kind::LAZY_COMPONENT_WITH_ARGS;
+  result.setTypeId(fruit::impl::getTypeId<Component(*)(Args...)>());
+  result.setKind(ComponentStorageEntry::Kind::LAZY_COMPONENT_WITH_ARGS);
   result.lazy_component_with_args.component =
       new ComponentInterfaceImpl<Component, Args...>(fun, std::move(args_tuple));
   return result;
@@ -127,8 +212,8 @@ template <typename Component, typename... Args>
 inline ComponentStorageEntry ComponentStorageEntry::LazyComponentWithArgs::createReplacedComponentEntry(
     Component(*fun)(Args...), std::tuple<Args...> args_tuple) {
   ComponentStorageEntry result;
-  result.type_id = getTypeId<Component(*)(Args...)>();
-  result.kind = ComponentStorageEntry::Kind::REPLACED_LAZY_COMPONENT_WITH_ARGS;
+  result.setTypeId(fruit::impl::getTypeId<Component(*)(Args...)>());
+  result.setKind(ComponentStorageEntry::Kind::REPLACED_LAZY_COMPONENT_WITH_ARGS);
   result.lazy_component_with_args.component =
       new ComponentInterfaceImpl<Component, Args...>(fun, std::move(args_tuple));
   return result;
@@ -138,45 +223,71 @@ template <typename Component, typename... Args>
 inline ComponentStorageEntry ComponentStorageEntry::LazyComponentWithArgs::createReplacementComponentEntry(
     Component(*fun)(Args...), std::tuple<Args...> args_tuple) {
   ComponentStorageEntry result;
-  result.type_id = getTypeId<Component(*)(Args...)>();
-  result.kind = ComponentStorageEntry::Kind::REPLACEMENT_LAZY_COMPONENT_WITH_ARGS;
+  result.setTypeId(fruit::impl::getTypeId<Component(*)(Args...)>());
+  result.setKind(ComponentStorageEntry::Kind::REPLACEMENT_LAZY_COMPONENT_WITH_ARGS);
   result.lazy_component_with_args.component =
       new ComponentInterfaceImpl<Component, Args...>(fun, std::move(args_tuple));
   return result;
 }
 
-inline ComponentStorageEntry::LazyComponentWithArgs ComponentStorageEntry::LazyComponentWithArgs::copy() const {
+inline ComponentStorageEntry::LazyComponentWithArgs ComponentStorageEntry::LazyComponentWithArgs::copy(
+    MemoryPool* memory_pool) const {
   LazyComponentWithArgs result;
-  result.component = component->copy();
+  result.component = component->copy(memory_pool);
   return result;
 }
 
 inline void ComponentStorageEntry::LazyComponentWithArgs::destroy() const {
-  delete component;
+  component->destroy();
 }
 
 inline bool ComponentStorageEntry::LazyComponentWithArgs::ComponentInterface::operator==(
     const ComponentInterface& other) const {
-  return erased_fun == other.erased_fun && areParamsEqual(other);
+  // Comparing the hashes first allows to skip the (indirect) comparison of the args in most cases.
+  return erased_fun == other.erased_fun && hash == other.hash && areParamsEqual(other);
 }
 
 template <typename Component>
 void ComponentStorageEntry::LazyComponentWithNoArgs::addBindings(
     erased_fun_t erased_fun, entry_vector_t& entries) {
+  if (LazyComponentWithNoArgsCache::appendCachedEntries(erased_fun, entries)) {
+    // This component function was already called (possibly for another injector), no need to call it again.
+    return;
+  }
   Component component = reinterpret_cast<Component(*)()>(erased_fun)();
   FixedSizeVector<ComponentStorageEntry> component_entries = std::move(component.storage).release();
+  LazyComponentWithNoArgsCache::storeEntries(erased_fun, component_entries.begin(), component_entries.end());
   entries.insert(entries.end(), component_entries.begin(), component_entries.end());
 }
 
+template <typename Component>
+inline TypeId ComponentStorageEntry::LazyComponentWithNoArgs::getFunTypeId() {
+#if defined(FRUIT_HAS_TYPEID) && !defined(FRUIT_HAS_CONSTEXPR_TYPEID)
+  // See getTypeId().
+  static const FunTypeInfo fun_type_info = {
+#else
+  static constexpr FunTypeInfo fun_type_info = {
+#endif
+      GetTypeInfoForType<Component(*)()>()(),
+      LazyComponentWithNoArgs::addBindings<Component>,
+  };
+  return TypeId{&fun_type_info.type_info};
+}
+
+inline ComponentStorageEntry::LazyComponentWithNoArgs::add_bindings_fun_t
+ComponentStorageEntry::LazyComponentWithNoArgs::getAddBindingsFun(TypeId fun_type_id) {
+  // This is valid because type_info is the first field of FunTypeInfo (and FunTypeInfo is a standard-layout type).
+  return reinterpret_cast<const FunTypeInfo*>(fun_type_id.type_info)->add_bindings_fun;
+}
+
 template <typename Component>
 inline ComponentStorageEntry
 ComponentStorageEntry::LazyComponentWithNoArgs::create(Component(*fun)()) {
   FruitAssert(fun != nullptr);
   ComponentStorageEntry result;
-  result.kind = ComponentStorageEntry::Kind::LAZY_COMPONENT_WITH_NO_ARGS;
-  result.type_id = getTypeId<Component(*)()>();
+  result.setKind(ComponentStorageEntry::Kind::LAZY_COMPONENT_WITH_NO_ARGS);
+  result.setTypeId(getFunTypeId<Component>());
   result.lazy_component_with_no_args.erased_fun = reinterpret_cast<erased_fun_t>(fun);
-  result.lazy_component_with_no_args.add_bindings_fun = LazyComponentWithNoArgs::addBindings<Component>;
   return result;
 }
 
@@ -185,10 +296,9 @@ inline ComponentStorageEntry
 ComponentStorageEntry::LazyComponentWithNoArgs::createReplacedComponentEntry(Component(*fun)()) {
   FruitAssert(fun != nullptr);
   ComponentStorageEntry result;
-  result.kind = ComponentStorageEntry::Kind::REPLACED_LAZY_COMPONENT_WITH_NO_ARGS;
-  result.type_id = getTypeId<Component(*)()>();
+  result.setKind(ComponentStorageEntry::Kind::REPLACED_LAZY_COMPONENT_WITH_NO_ARGS);
+  result.setTypeId(getFunTypeId<Component>());
   result.lazy_component_with_no_args.erased_fun = reinterpret_cast<erased_fun_t>(fun);
-  result.lazy_component_with_no_args.add_bindings_fun = LazyComponentWithNoArgs::addBindings<Component>;
   return result;
 }
 
@@ -197,10 +307,9 @@ inline ComponentStorageEntry
 ComponentStorageEntry::LazyComponentWithNoArgs::createReplacementComponentEntry(Component(*fun)()) {
   FruitAssert(fun != nullptr);
   ComponentStorageEntry result;
-  result.kind = ComponentStorageEntry::Kind::REPLACEMENT_LAZY_COMPONENT_WITH_NO_ARGS;
-  result.type_id = getTypeId<Component(*)()>();
+  result.setKind(ComponentStorageEntry::Kind::REPLACEMENT_LAZY_COMPONENT_WITH_NO_ARGS);
+  result.setTypeId(getFunTypeId<Component>());
   result.lazy_component_with_no_args.erased_fun = reinterpret_cast<erased_fun_t>(fun);
-  result.lazy_component_with_no_args.add_bindings_fun = LazyComponentWithNoArgs::addBindings<Component>;
   return result;
 }
 
@@ -210,20 +319,14 @@ inline bool ComponentStorageEntry::LazyComponentWithNoArgs::isValid() const {
 
 inline bool ComponentStorageEntry::LazyComponentWithNoArgs::operator==(
     const ComponentStorageEntry::LazyComponentWithNoArgs& other) const {
-  if (erased_fun == other.erased_fun) {
-    // These must be equal in this case, no need to compare them.
-    FruitAssert(add_bindings_fun == other.add_bindings_fun);
-    return true;
-  } else {
-    // type_id and add_bindings_fun may or may not be different from the ones in `other`.
-    return false;
-  }
+  // If the functions are equal the type_id of the entries must be equal too, no need to compare them.
+  return erased_fun == other.erased_fun;
 }
 
 inline void ComponentStorageEntry::LazyComponentWithNoArgs::addBindings(
-    entry_vector_t& entries) const {
+    TypeId fun_type_id, entry_vector_t& entries) const {
   FruitAssert(isValid());
-  add_bindings_fun(erased_fun, entries);
+  getAddBindingsFun(fun_type_id)(erased_fun, entries);
 }
 
 inline std::size_t ComponentStorageEntry::LazyComponentWithNoArgs::hashCode() const {
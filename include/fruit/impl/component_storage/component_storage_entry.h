@@ -33,7 +33,7 @@ namespace impl {
  * This way each ComponentStorage can hold a single vector and do a single allocation.
  */
 struct ComponentStorageEntry {
-  enum class Kind {
+  enum class Kind : std::uint8_t {
 #ifdef FRUIT_EXTRA_DEBUG
     INVALID,
 #endif
@@ -64,18 +64,33 @@ struct ComponentStorageEntry {
     // These markers are used in expandLazyComponents(), see the comments there for details.
     COMPONENT_WITH_ARGS_END_MARKER,
     COMPONENT_WITHOUT_ARGS_END_MARKER,
+
+    // This is not a real kind, it's only used to check that all kinds fit in NUM_KIND_BITS bits.
+    NUM_KINDS,
   };
 
+  // The number of low bits of a TypeInfo pointer that are always 0 (see the alignment of TypeInfo), and that we use
+  // to store the Kind.
+  static constexpr const std::size_t NUM_KIND_BITS = 5;
+  static constexpr const std::uintptr_t KIND_MASK = (std::uintptr_t(1) << NUM_KIND_BITS) - 1;
+
+  // The kind and the TypeId of this entry, packed in the space of a pointer: the kind is stored in the low bits of the
+  // TypeInfo pointer. Together with the single-word payloads below, this allows the whole entry to fit in 2 words.
+  // Don't access this directly, use getKind()/setKind() and getTypeId()/setTypeId() instead.
 #ifdef FRUIT_EXTRA_DEBUG
   mutable
 #endif
-  Kind kind;
+  std::uintptr_t kind_and_type_id = 0;
+
+  Kind getKind() const;
+  void setKind(Kind kind);
 
   // This is usually the TypeId for the bound type, except:
   // * when kind==COMPRESSED_BINDING, this is the interface's TypeId
   // * when kind==*LAZY_COMPONENT_*, this is the TypeId of the
   //       Component<...>-returning function.
-  TypeId type_id;
+  TypeId getTypeId() const;
+  void setTypeId(TypeId type_id);
 
   /**
    * This represents an entry in ComponentStorage for a binding (not a multibinding) that holds an already-constructed
@@ -105,12 +120,19 @@ struct ComponentStorageEntry {
     using create_t = object_t(*)(InjectorStorage&,
                                  SemistaticGraph<TypeId, NormalizedBinding>::node_iterator);
 
-    // The return value of this function is a pointer to the constructed object (guaranteed to be !=nullptr).
-    // Once the object is constructed (at injection time), the injector owns that object.
-    create_t create;
+    // The part of the binding that only depends on the binding's type. There's a single (static) instance of this for
+    // each binding type, so that the entry only needs to store a pointer to it.
+    struct Data {
+      // The return value of this function is a pointer to the constructed object (guaranteed to be !=nullptr).
+      // Once the object is constructed (at injection time), the injector owns that object.
+      create_t create;
 
-    // The type IDs that this type depends on.
-    const BindingDeps* deps;
+      // The type IDs that this type depends on. This is stored here (instead of a pointer to it) so that reaching the
+      // deps from the entry takes a single indirection.
+      BindingDeps deps;
+    };
+
+    const Data* data;
 
 #ifdef FRUIT_EXTRA_DEBUG
     bool is_nonconst;
@@ -137,12 +159,17 @@ struct ComponentStorageEntry {
     using object_t = void*;
     using create_t = object_t(*)(InjectorStorage&);
 
-    // The return value of this function is a pointer to the constructed object (guaranteed to be !=nullptr).
-    // Once the object is constructed (at injection time), the injector owns that object.
-    create_t create;
+    // As in BindingForObjectToConstruct, there's a single (static) instance of this for each multibinding type.
+    struct Data {
+      // The return value of this function is a pointer to the constructed object (guaranteed to be !=nullptr).
+      // Once the object is constructed (at injection time), the injector owns that object.
+      create_t create;
+
+      // The type IDs that this type depends on.
+      BindingDeps deps;
+    };
 
-    // The type IDs that this type depends on.
-    const BindingDeps* deps;
+    const Data* data;
   };
 
   /**
@@ -151,10 +178,10 @@ struct ComponentStorageEntry {
    */
   struct MultibindingVectorCreator {
 
-    using get_multibindings_vector_t = std::shared_ptr<char>(*)(InjectorStorage&);
+    using get_multibindings_vector_t = void*(*)(InjectorStorage&);
 
-    // Returns the std::vector<T*> of instances, or nullptr if none.
-    // Caches the result in the `v' member of NormalizedMultibindingData.
+    // Returns the (casted) array of T* instances, with one element for each multibinding.
+    // Caches the result in the `v' member of NormalizedMultibindingSet.
     get_multibindings_vector_t get_multibindings_vector;
   };
 
@@ -168,14 +195,16 @@ struct ComponentStorageEntry {
   // with just a binding for I, with BindingForObjectToConstruct(create, deps, needs_allocation).
   struct CompressedBinding {
 
-    using create_t = BindingForObjectToConstruct::create_t;
+    // There's a single (static) instance of this for each compressed binding type.
+    struct Data {
+      // TypeId for the implementation.
+      TypeId c_type_id;
 
-    // TypeId for the implementation.
-    TypeId c_type_id;
+      // The binding for I after the compression: it constructs a C (returning it as an I*) and it has the deps of C.
+      BindingForObjectToConstruct::Data i_binding_with_compression;
+    };
 
-    // The return value of this function is a pointer to the constructed object (guaranteed to be !=nullptr).
-    // Once the object is constructed (at injection time), the injector owns that object.
-    create_t create;
+    const Data* data;
   };
 
   /**
@@ -194,11 +223,25 @@ struct ComponentStorageEntry {
 
     // The function that allows to add this component's bindings to the given ComponentStorage.
     using add_bindings_fun_t = void(*)(erased_fun_t, entry_vector_t&);
-    add_bindings_fun_t add_bindings_fun;
+
+    // The TypeId of these entries points to the `type_info' field of a FunTypeInfo, so that the add_bindings_fun for
+    // the Component type can be found from the TypeId instead of being stored in each entry.
+    struct FunTypeInfo {
+      // The TypeInfo for Component(*)(). This must be the first field, see getAddBindingsFun().
+      TypeInfo type_info;
+      add_bindings_fun_t add_bindings_fun;
+    };
 
     template <typename Component>
     static void addBindings(erased_fun_t erased_fun, entry_vector_t& entries);
 
+    // Returns the TypeId to use for the entries of lazy components with no args returning a Component.
+    template <typename Component>
+    static TypeId getFunTypeId();
+
+    // `fun_type_id' must be the TypeId of a *LAZY_COMPONENT_WITH_NO_ARGS entry (returned by getFunTypeId()).
+    static add_bindings_fun_t getAddBindingsFun(TypeId fun_type_id);
+
     template <typename Component>
     static ComponentStorageEntry create(Component(*fun)());
 
@@ -210,7 +253,8 @@ struct ComponentStorageEntry {
 
     bool operator==(const LazyComponentWithNoArgs&) const;
 
-    void addBindings(entry_vector_t& entries) const;
+    // `fun_type_id' must be the TypeId of the entry that holds this object.
+    void addBindings(TypeId fun_type_id, entry_vector_t& entries) const;
 
     std::size_t hashCode() const;
 
@@ -221,38 +265,74 @@ struct ComponentStorageEntry {
    * This represents an entry in ComponentStorage for a lazy component with arguments.
    */
   struct LazyComponentWithArgs {
+    /**
+     * The common part of all lazy components with args. The args themselves are stored right after this object, by
+     * the ComponentInterfaceImpl<Component, Args...> subclass.
+     *
+     * This class has no virtual methods: the operations that depend on the type of the args are dispatched through
+     * `function_table' instead, and the hash is computed once (when the object is created) and then stored here, so
+     * that the hash sets/maps used during normalization can hash and compare these objects without any indirect call
+     * in the common case.
+     */
     class ComponentInterface {
     public:
       // An arbitrary function type, used as type for the field `erased_fun`.
       // Note that we can't use void* here, since data pointers might not have the same size as function pointers.
       using erased_fun_t = void(*)();
 
+      using entry_vector_t = std::vector<ComponentStorageEntry, ArenaAllocator<ComponentStorageEntry>>;
+
+      // The operations that depend on the actual type of the args. There's a single (static) instance of this for each
+      // ComponentInterfaceImpl<Component, Args...> type.
+      struct FunctionTable {
+        // Checks if the args of x and y are equal, assuming that x.erased_fun and y.erased_fun are equal.
+        bool (*are_params_equal)(const ComponentInterface& x, const ComponentInterface& y);
+        void (*add_bindings)(const ComponentInterface& x, entry_vector_t& component_storage_entries);
+        // If memory_pool is nullptr, the copy is allocated on the heap.
+        ComponentInterface* (*copy)(const ComponentInterface& x, MemoryPool* memory_pool);
+        void (*destroy)(const ComponentInterface& x);
+        TypeId (*get_fun_type_id)();
+      };
+
       // The function that will be invoked to create the Component.
       // Here we don't know the type, it's only known to the LazyComponent implementation.
       // We store this here instead of in the LazyComponent implementation so that we can do a quick comparison on the
-      // pointer without virtual calls (and we can then do the rest of the comparison via virtual call if needed).
+      // pointer without going through the function table (and we can then compare the args if needed).
       erased_fun_t erased_fun;
 
-      using entry_vector_t = std::vector<ComponentStorageEntry, ArenaAllocator<ComponentStorageEntry>>;
+      const FunctionTable* function_table;
+
+      // The hash of erased_fun and the args.
+      std::size_t hash;
 
-      ComponentInterface(erased_fun_t erased_fun);
+      // Whether this object was allocated in a MemoryPool (so it must be destroyed but not deallocated) or on the heap.
+      bool allocated_in_memory_pool;
 
-      virtual ~ComponentInterface() = default;
+      ComponentInterface(
+          erased_fun_t erased_fun, const FunctionTable* function_table, std::size_t hash, bool allocated_in_memory_pool);
 
       // Checks if *this and other are equal, assuming that this->fun and other.fun are equal.
-      virtual bool areParamsEqual(const ComponentInterface& other) const = 0;
+      bool areParamsEqual(const ComponentInterface& other) const;
 
       bool operator==(const ComponentInterface& other) const;
 
-      virtual void addBindings(entry_vector_t& component_storage_entries) const = 0;
-      virtual std::size_t hashCode() const = 0;
-      virtual ComponentInterface* copy() const = 0;
+      void addBindings(entry_vector_t& component_storage_entries) const;
+      std::size_t hashCode() const;
+
+      /**
+       * Returns a copy of this object. If memory_pool is not nullptr, the copy is allocated there instead of on the
+       * heap; in that case the copy must be destroyed (with destroy()) before the memory pool.
+       */
+      ComponentInterface* copy(MemoryPool* memory_pool = nullptr) const;
+
+      // Destroys this object, deallocating it unless it was allocated in a MemoryPool.
+      void destroy() const;
 
       /**
        * Returns the type ID of the real `fun` object stored by the implementation.
        * We use this instead of the `typeid` operator so that we don't require RTTI.
        */
-      virtual TypeId getFunTypeId() const = 0;
+      TypeId getFunTypeId() const;
     };
 
     template <typename Component, typename... Args>
@@ -275,7 +355,8 @@ struct ComponentStorageEntry {
     LazyComponentWithArgs(const LazyComponentWithArgs&) = default;
     LazyComponentWithArgs& operator=(const LazyComponentWithArgs&) = default;
 
-    LazyComponentWithArgs copy() const;
+    // See ComponentInterface::copy().
+    LazyComponentWithArgs copy(MemoryPool* memory_pool = nullptr) const;
     void destroy() const;
 
     ComponentInterface* component;
@@ -319,13 +400,20 @@ struct ComponentStorageEntry {
   void destroy() const;
 };
 
+static_assert(
+    std::size_t(ComponentStorageEntry::Kind::NUM_KINDS) <= (std::size_t(1) << ComponentStorageEntry::NUM_KIND_BITS),
+    "Error: the kinds of ComponentStorageEntry don't fit in NUM_KIND_BITS bits");
+static_assert(
+    alignof(TypeInfo) >= (std::size_t(1) << ComponentStorageEntry::NUM_KIND_BITS),
+    "Error: TypeInfo is not aligned enough to store a ComponentStorageEntry::Kind in the low bits of a TypeInfo*");
+
 // We can't have this assert in debug mode because we add debug-only fields that increase the size.
 #ifndef FRUIT_EXTRA_DEBUG
-// This is not required for correctness, but 4 64-bit words should be enough to hold this object, if not we'd end up
+// This is not required for correctness, but 2 pointers should be enough to hold this object, if not we'd end up
 // using more memory/CPU than expected.
 static_assert(
-    sizeof(ComponentStorageEntry) <= 4 * sizeof(std::uint64_t),
-    "Error: a ComponentStorageEntry doesn't fit in 32 bytes as we expected");
+    sizeof(ComponentStorageEntry) <= 2 * sizeof(void*),
+    "Error: a ComponentStorageEntry doesn't fit in 2 pointers as we expected");
 #endif
 
 
@@ -0,0 +1,75 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_LAZY_COMPONENT_WITH_NO_ARGS_CACHE_H
+#define FRUIT_LAZY_COMPONENT_WITH_NO_ARGS_CACHE_H
+
+#include <fruit/impl/fruit_internal_forward_decls.h>
+#include <fruit/impl/data_structures/arena_allocator.h>
+
+#include <vector>
+
+namespace fruit {
+namespace impl {
+
+/**
+ * A process-wide cache of the entries of lazy components with no args, keyed by the component function.
+ *
+ * A component function with no args always returns the same bindings, so once it has been called (when creating any
+ * injector or NormalizedComponent) its entries can be reused instead of calling the function (and re-building its
+ * PartialComponentStorage chain) again.
+ *
+ * This class is thread-safe. Lookups don't take any lock: they use an immutable snapshot of the cache, and the methods
+ * that modify the cache publish a modified copy of the snapshot instead (serialized by a mutex). The cache holds one
+ * vector of entries for each component function that has been expanded at least once, until it's evicted or cleared.
+ */
+class LazyComponentWithNoArgsCache {
+public:
+  // Same as ComponentStorageEntry::LazyComponentWithNoArgs::erased_fun_t.
+  using erased_fun_t = void(*)();
+
+  // Same as ComponentStorageEntry::LazyComponentWithNoArgs::entry_vector_t.
+  using entry_vector_t = std::vector<ComponentStorageEntry, ArenaAllocator<ComponentStorageEntry>>;
+
+  /**
+   * If the entries of the component function `erased_fun' are in the cache, appends a copy of them to `entries' and
+   * returns true. Otherwise returns false, without modifying `entries'.
+   */
+  static bool appendCachedEntries(erased_fun_t erased_fun, entry_vector_t& entries);
+
+  /**
+   * Stores a copy of the entries in [first, last) as the entries of the component function `erased_fun'.
+   * If the entries of this function were already stored (e.g. by another thread), this does nothing.
+   */
+  static void storeEntries(erased_fun_t erased_fun, const ComponentStorageEntry* first, const ComponentStorageEntry* last);
+
+  /**
+   * Removes the entries of the component function `erased_fun' from the cache (if present), so that the function will be
+   * called again the next time that it's expanded.
+   * Injectors and NormalizedComponents that are being created concurrently might still use the removed entries.
+   */
+  static void evict(erased_fun_t erased_fun);
+
+  /**
+   * Removes the entries of all component functions from the cache. See evict().
+   */
+  static void clear();
+};
+
+} // namespace impl
+} // namespace fruit
+
+#endif // FRUIT_LAZY_COMPONENT_WITH_NO_ARGS_CACHE_H
@@ -35,7 +35,11 @@ public:
     (void)entries;
   }
 
-  std::size_t numBindings() const {
+  static constexpr std::size_t numStaticBindings() {
+    return 0;
+  }
+
+  std::size_t numDynamicBindings() const {
     return 0;
   }
 };
@@ -55,8 +59,12 @@ public:
     previous_storage.addBindings(entries);
   }
 
-  std::size_t numBindings() const {
-    return previous_storage.numBindings();
+  static constexpr std::size_t numStaticBindings() {
+    return PartialComponentStorage<PreviousBindings...>::numStaticBindings();
+  }
+
+  std::size_t numDynamicBindings() const {
+    return previous_storage.numDynamicBindings();
   }
 };
 
@@ -74,8 +82,35 @@ public:
     previous_storage.addBindings(entries);
   }
 
-  std::size_t numBindings() const {
-    return previous_storage.numBindings();
+  static constexpr std::size_t numStaticBindings() {
+    return PartialComponentStorage<PreviousBindings...>::numStaticBindings();
+  }
+
+  std::size_t numDynamicBindings() const {
+    return previous_storage.numDynamicBindings();
+  }
+};
+
+template <typename Signature, typename... PreviousBindings>
+class PartialComponentStorage<RegisterThreadLocal<Signature>, PreviousBindings...> {
+private:
+  PartialComponentStorage<PreviousBindings...> &previous_storage;
+
+public:
+  PartialComponentStorage(PartialComponentStorage<PreviousBindings...>& previous_storage)
+      : previous_storage(previous_storage) {
+  }
+
+  void addBindings(FixedSizeVector<ComponentStorageEntry>& entries) const {
+    previous_storage.addBindings(entries);
+  }
+
+  static constexpr std::size_t numStaticBindings() {
+    return PartialComponentStorage<PreviousBindings...>::numStaticBindings();
+  }
+
+  std::size_t numDynamicBindings() const {
+    return previous_storage.numDynamicBindings();
   }
 };
 
@@ -97,8 +132,12 @@ public:
     previous_storage.addBindings(entries);
   }
 
-  std::size_t numBindings() const {
-    return previous_storage.numBindings() + 1;
+  static constexpr std::size_t numStaticBindings() {
+    return PartialComponentStorage<PreviousBindings...>::numStaticBindings() + 1;
+  }
+
+  std::size_t numDynamicBindings() const {
+    return previous_storage.numDynamicBindings();
   }
 };
 
@@ -120,8 +159,12 @@ public:
     previous_storage.addBindings(entries);
   }
 
-  std::size_t numBindings() const {
-    return previous_storage.numBindings() + 1;
+  static constexpr std::size_t numStaticBindings() {
+    return PartialComponentStorage<PreviousBindings...>::numStaticBindings() + 1;
+  }
+
+  std::size_t numDynamicBindings() const {
+    return previous_storage.numDynamicBindings();
   }
 };
 
@@ -144,8 +187,12 @@ public:
     previous_storage.addBindings(entries);
   }
 
-  std::size_t numBindings() const {
-    return previous_storage.numBindings() + 1;
+  static constexpr std::size_t numStaticBindings() {
+    return PartialComponentStorage<PreviousBindings...>::numStaticBindings() + 1;
+  }
+
+  std::size_t numDynamicBindings() const {
+    return previous_storage.numDynamicBindings();
   }
 };
 
@@ -168,8 +215,12 @@ public:
     previous_storage.addBindings(entries);
   }
 
-  std::size_t numBindings() const {
-    return previous_storage.numBindings() + 1;
+  static constexpr std::size_t numStaticBindings() {
+    return PartialComponentStorage<PreviousBindings...>::numStaticBindings() + 1;
+  }
+
+  std::size_t numDynamicBindings() const {
+    return previous_storage.numDynamicBindings();
   }
 };
 
@@ -187,8 +238,12 @@ public:
     previous_storage.addBindings(entries);
   }
 
-  std::size_t numBindings() const {
-    return previous_storage.numBindings();
+  static constexpr std::size_t numStaticBindings() {
+    return PartialComponentStorage<PreviousBindings...>::numStaticBindings();
+  }
+
+  std::size_t numDynamicBindings() const {
+    return previous_storage.numDynamicBindings();
   }
 };
 
@@ -211,8 +266,12 @@ public:
     previous_storage.addBindings(entries);
   }
 
-  std::size_t numBindings() const {
-    return previous_storage.numBindings() + 2;
+  static constexpr std::size_t numStaticBindings() {
+    return PartialComponentStorage<PreviousBindings...>::numStaticBindings() + 2;
+  }
+
+  std::size_t numDynamicBindings() const {
+    return previous_storage.numDynamicBindings();
   }
 };
 
@@ -235,8 +294,12 @@ public:
     previous_storage.addBindings(entries);
   }
 
-  std::size_t numBindings() const {
-    return previous_storage.numBindings() + 2;
+  static constexpr std::size_t numStaticBindings() {
+    return PartialComponentStorage<PreviousBindings...>::numStaticBindings() + 2;
+  }
+
+  std::size_t numDynamicBindings() const {
+    return previous_storage.numDynamicBindings();
   }
 };
 
@@ -264,8 +327,12 @@ public:
     previous_storage.addBindings(entries);
   }
 
-  std::size_t numBindings() const {
-    return previous_storage.numBindings() + instances.size()*2;
+  static constexpr std::size_t numStaticBindings() {
+    return PartialComponentStorage<PreviousBindings...>::numStaticBindings();
+  }
+
+  std::size_t numDynamicBindings() const {
+    return previous_storage.numDynamicBindings() + instances.size()*2;
   }
 };
 
@@ -294,8 +361,12 @@ public:
     previous_storage.addBindings(entries);
   }
 
-  std::size_t numBindings() const {
-    return previous_storage.numBindings() + instances.size()*2;
+  static constexpr std::size_t numStaticBindings() {
+    return PartialComponentStorage<PreviousBindings...>::numStaticBindings();
+  }
+
+  std::size_t numDynamicBindings() const {
+    return previous_storage.numDynamicBindings() + instances.size()*2;
   }
 };
 
@@ -313,8 +384,12 @@ public:
     previous_storage.addBindings(entries);
   }
 
-  std::size_t numBindings() const {
-    return previous_storage.numBindings();
+  static constexpr std::size_t numStaticBindings() {
+    return PartialComponentStorage<PreviousBindings...>::numStaticBindings();
+  }
+
+  std::size_t numDynamicBindings() const {
+    return previous_storage.numDynamicBindings();
   }
 };
 
@@ -332,8 +407,12 @@ public:
     previous_storage.addBindings(entries);
   }
 
-  std::size_t numBindings() const {
-    return previous_storage.numBindings();
+  static constexpr std::size_t numStaticBindings() {
+    return PartialComponentStorage<PreviousBindings...>::numStaticBindings();
+  }
+
+  std::size_t numDynamicBindings() const {
+    return previous_storage.numDynamicBindings();
   }
 };
 
@@ -351,8 +430,12 @@ public:
     previous_storage.addBindings(entries);
   }
 
-  std::size_t numBindings() const {
-    return previous_storage.numBindings();
+  static constexpr std::size_t numStaticBindings() {
+    return PartialComponentStorage<PreviousBindings...>::numStaticBindings();
+  }
+
+  std::size_t numDynamicBindings() const {
+    return previous_storage.numDynamicBindings();
   }
 };
 
@@ -376,8 +459,12 @@ public:
     previous_storage.addBindings(entries);
   }
 
-  std::size_t numBindings() const {
-    return previous_storage.numBindings() + 1;
+  static constexpr std::size_t numStaticBindings() {
+    return PartialComponentStorage<PreviousBindings...>::numStaticBindings() + 1;
+  }
+
+  std::size_t numDynamicBindings() const {
+    return previous_storage.numDynamicBindings();
   }
 };
 
@@ -403,8 +490,12 @@ public:
     previous_storage.addBindings(entries);
   }
 
-  std::size_t numBindings() const {
-    return previous_storage.numBindings() + 1;
+  static constexpr std::size_t numStaticBindings() {
+    return PartialComponentStorage<PreviousBindings...>::numStaticBindings() + 1;
+  }
+
+  std::size_t numDynamicBindings() const {
+    return previous_storage.numDynamicBindings();
   }
 };
 
@@ -428,8 +519,12 @@ public:
     previous_storage.addBindings(entries);
   }
 
-  std::size_t numBindings() const {
-    return previous_storage.numBindings() + 1;
+  static constexpr std::size_t numStaticBindings() {
+    return PartialComponentStorage<PreviousBindings...>::numStaticBindings() + 1;
+  }
+
+  std::size_t numDynamicBindings() const {
+    return previous_storage.numDynamicBindings();
   }
 };
 
@@ -458,8 +553,12 @@ public:
     previous_storage.addBindings(entries);
   }
 
-  std::size_t numBindings() const {
-    return previous_storage.numBindings() + 1;
+  static constexpr std::size_t numStaticBindings() {
+    return PartialComponentStorage<PreviousBindings...>::numStaticBindings() + 1;
+  }
+
+  std::size_t numDynamicBindings() const {
+    return previous_storage.numDynamicBindings();
   }
 };
 
@@ -490,8 +589,12 @@ public:
     previous_storage.addBindings(entries);
   }
 
-  std::size_t numBindings() const {
-    return previous_storage.numBindings() + 1;
+  static constexpr std::size_t numStaticBindings() {
+    return previous_storage_t::numStaticBindings() + 1;
+  }
+
+  std::size_t numDynamicBindings() const {
+    return previous_storage.numDynamicBindings();
   }
 };
 
@@ -525,8 +628,12 @@ public:
     previous_storage.addBindings(entries);
   }
 
-  std::size_t numBindings() const {
-    return previous_storage.numBindings() + 1;
+  static constexpr std::size_t numStaticBindings() {
+    return previous_storage_t::numStaticBindings() + 1;
+  }
+
+  std::size_t numDynamicBindings() const {
+    return previous_storage.numDynamicBindings();
   }
 };
 
@@ -35,7 +35,13 @@ class PartialComponentStorage; /* {
 All specializations support the following methods:
 
   void addBindings(FixedSizeVector<ComponentStorageEntry>& entries);
-  std::size_t numBindings();
+
+  // The number of entries that addBindings() will add, excluding the ones that depend on runtime data (e.g. the size
+  // of a vector passed to addInstanceMultibindings()). This only depends on Bindings..., so it's known at compile time.
+  static constexpr std::size_t numStaticBindings();
+
+  // The number of additional entries that addBindings() will add, that depend on runtime data.
+  std::size_t numDynamicBindings() const;
 };*/
 
 template <typename... Bindings>
@@ -58,26 +58,86 @@ inline void FixedSizeAllocator::FixedSizeAllocatorData::addExternallyAllocatedTy
   num_types_to_destroy++;
 }
 
+inline void FixedSizeAllocator::FixedSizeAllocatorData::removeExternallyAllocatedType(TypeId typeId) {
+  (void)typeId;
+  FruitAssert(num_types_to_destroy > 0);
+  num_types_to_destroy--;
+}
+
+inline void FixedSizeAllocator::FixedSizeAllocatorData::removeType(TypeId typeId) {
+#ifdef FRUIT_EXTRA_DEBUG
+  FruitAssert(types[typeId] > 0);
+  types[typeId]--;
+#endif
+  if (!typeId.type_info->isTriviallyDestructible()) {
+    FruitAssert(num_types_to_destroy > 0);
+    num_types_to_destroy--;
+  }
+  FruitAssert(total_size >= maximumRequiredSpace(typeId));
+  total_size -= maximumRequiredSpace(typeId);
+}
+
+inline void FixedSizeAllocator::FixedSizeAllocatorData::addPointerArray() {
+  total_size += alignof(void*) - 1;
+}
+
+inline void FixedSizeAllocator::FixedSizeAllocatorData::addPointerArrayElement() {
+  total_size += sizeof(void*);
+}
+
 inline std::size_t FixedSizeAllocator::FixedSizeAllocatorData::maximumRequiredSpace(TypeId type) {
   return type.type_info->alignment() + type.type_info->size() - 1;
 }
 
-template <typename AnnotatedT, typename... Args>
+template <typename AnnotatedT>
 FRUIT_ALWAYS_INLINE
 inline fruit::impl::meta::UnwrapType<fruit::impl::meta::Eval<fruit::impl::meta::RemoveAnnotations(fruit::impl::meta::Type<AnnotatedT>)>>*
-FixedSizeAllocator::constructObject(Args&&... args) {
+FixedSizeAllocator::allocateObject() {
   using T = fruit::impl::meta::UnwrapType<fruit::impl::meta::Eval<fruit::impl::meta::RemoveAnnotations(fruit::impl::meta::Type<AnnotatedT>)>>;
   
-  char* p = storage_last_used;
-  size_t misalignment = std::uintptr_t(p) % alignof(T);
+  // These are the same as the size and alignment in T's TypeInfo, used to reserve the space for this object.
+  constexpr std::size_t alignment = AllocationSizeAndAlignment<T>::alignment;
+  constexpr std::size_t size = AllocationSizeAndAlignment<T>::size;
+  
+  std::uintptr_t last_used = std::uintptr_t(storage_last_used);
+  std::uintptr_t begin = last_used + alignment - last_used % alignment;
+  if (begin + size > std::uintptr_t(storage_end)) {
+    // This can only happen when allocating lazily.
+    allocateChunk(alignment + size - 1);
+    last_used = std::uintptr_t(storage_last_used);
+    begin = last_used + alignment - last_used % alignment;
+  }
+  char* p = reinterpret_cast<char*>(begin);
 #ifdef FRUIT_EXTRA_DEBUG
   FruitAssert(remaining_types[getTypeId<AnnotatedT>()] != 0);
   remaining_types[getTypeId<AnnotatedT>()]--;
+  constructed_objects.push_back(ConstructedObject{getTypeId<AnnotatedT>(), p, sizeof(T)});
 #endif
-  p += alignof(T) - misalignment;
-  FruitAssert(std::uintptr_t(p) % alignof(T) == 0);
-  T* x = reinterpret_cast<T*>(p);
-  storage_last_used = p + sizeof(T) - 1;
+  FruitAssert(std::uintptr_t(p) % alignment == 0);
+  FruitAssert(p + size <= storage_end);
+  storage_last_used = p + size - 1;
+  return reinterpret_cast<T*>(p);
+}
+
+template <typename T>
+FRUIT_ALWAYS_INLINE
+inline void FixedSizeAllocator::registerConstructedObject(T* p) {
+  if (!std::is_trivially_destructible<T>::value && !fruit::ProcessLifetime<T>::value) {
+    on_destruction.push_back(
+        std::pair<destroy_t, void*>{destroyObject<T>, p});
+    if (fruit::RunDestructorAtExit<T>::value) {
+      on_destruction_at_exit.push_back(std::pair<destroy_t, void*>{destroyObject<T>, p});
+    }
+  }
+}
+
+template <typename AnnotatedT, typename... Args>
+FRUIT_ALWAYS_INLINE
+inline fruit::impl::meta::UnwrapType<fruit::impl::meta::Eval<fruit::impl::meta::RemoveAnnotations(fruit::impl::meta::Type<AnnotatedT>)>>*
+FixedSizeAllocator::constructObject(Args&&... args) {
+  using T = fruit::impl::meta::UnwrapType<fruit::impl::meta::Eval<fruit::impl::meta::RemoveAnnotations(fruit::impl::meta::Type<AnnotatedT>)>>;
+  
+  T* x = allocateObject<AnnotatedT>();
   
   // This runs arbitrary code (T's constructor), which might end up calling
   // constructObject recursively. We must make sure all invariants are satisfied before
@@ -86,23 +146,55 @@ FixedSizeAllocator::constructObject(Args&&... args) {
   
   // We still run this later though, since if T's constructor throws we don't want to
   // destruct this object in FixedSizeAllocator's destructor.
-  if (!std::is_trivially_destructible<T>::value) {
-    on_destruction.push_back(
-        std::pair<destroy_t, void*>{destroyObject<T>, x});
-  }
+  registerConstructedObject(x);
   return x;
 }
 
 template <typename T>
 inline void FixedSizeAllocator::registerExternallyAllocatedObject(T* p) {
-  on_destruction.push_back(std::pair<destroy_t, void*>{destroyExternalObject<T>, p});
+  if (!fruit::ProcessLifetime<T>::value) {
+    on_destruction.push_back(std::pair<destroy_t, void*>{destroyExternalObject<T>, p});
+    if (fruit::RunDestructorAtExit<T>::value) {
+      on_destruction_at_exit.push_back(std::pair<destroy_t, void*>{destroyExternalObject<T>, p});
+    }
+  }
+}
+
+template <typename T>
+inline T** FixedSizeAllocator::allocatePointerArray(std::size_t n) {
+  static_assert(alignof(T*) == alignof(void*), "");
+  static_assert(sizeof(T*) == sizeof(void*), "");
+  
+  // Unlike constructObject(), here storage_last_used+1 might already be suitably aligned, since we only reserve
+  // alignof(void*)-1 bytes of padding per array.
+  std::uintptr_t begin = std::uintptr_t(storage_last_used) + 1;
+  begin += (alignof(T*) - begin % alignof(T*)) % alignof(T*);
+  if (begin + n * sizeof(T*) > std::uintptr_t(storage_end)) {
+    // This can only happen when allocating lazily.
+    allocateChunk(alignof(T*) - 1 + n * sizeof(T*));
+    begin = std::uintptr_t(storage_last_used) + 1;
+    begin += (alignof(T*) - begin % alignof(T*)) % alignof(T*);
+  }
+  char* p = reinterpret_cast<char*>(begin);
+  FruitAssert(std::uintptr_t(p) % alignof(T*) == 0);
+  T** array = reinterpret_cast<T**>(p);
+  if (n != 0) {
+    storage_last_used = p + n * sizeof(T*) - 1;
+  }
+  return array;
 }
 
-inline FixedSizeAllocator::FixedSizeAllocator(FixedSizeAllocatorData allocator_data)
-  : on_destruction(allocator_data.num_types_to_destroy) {
-  // The +1 is because we waste the first byte (storage_last_used points to the beginning of storage).
-  storage_begin = new char[allocator_data.total_size + 1];
-  storage_last_used = storage_begin;
+inline FixedSizeAllocator::FixedSizeAllocator(FixedSizeAllocatorData allocator_data, MemoryResource* memory_resource,
+                                              bool allocate_lazily)
+  : remaining_size(allocator_data.total_size),
+    memory_resource(memory_resource),
+    on_destruction(allocator_data.num_types_to_destroy,
+                   ResourceAllocator<std::pair<destroy_t, void*>>(memory_resource)),
+    on_destruction_at_exit(ResourceAllocator<std::pair<destroy_t, void*>>(memory_resource)) {
+  if (!allocate_lazily) {
+    // Objects are aligned within the storage (and the space needed for that is included in total_size).
+    allocateChunk(allocator_data.total_size);
+  }
 #ifdef FRUIT_EXTRA_DEBUG
   remaining_types = allocator_data.types;
   std::cerr << "Constructing allocator for types:";
@@ -113,22 +205,36 @@ inline FixedSizeAllocator::FixedSizeAllocator(FixedSizeAllocatorData allocator_d
 #endif
 }
 
+inline MemoryResource* FixedSizeAllocator::getMemoryResource() const {
+  return memory_resource;
+}
+
 inline FixedSizeAllocator::FixedSizeAllocator(FixedSizeAllocator&& x)
   : FixedSizeAllocator() {
-  std::swap(storage_begin, x.storage_begin);
   std::swap(storage_last_used, x.storage_last_used);
+  std::swap(storage_end, x.storage_end);
+  std::swap(last_chunk, x.last_chunk);
+  std::swap(remaining_size, x.remaining_size);
+  std::swap(memory_resource, x.memory_resource);
   std::swap(on_destruction, x.on_destruction);
+  std::swap(on_destruction_at_exit, x.on_destruction_at_exit);
 #ifdef FRUIT_EXTRA_DEBUG
   std::swap(remaining_types, x.remaining_types);
+  std::swap(constructed_objects, x.constructed_objects);
 #endif
 }
 
 inline FixedSizeAllocator& FixedSizeAllocator::operator=(FixedSizeAllocator&& x) {
-  std::swap(storage_begin, x.storage_begin);
   std::swap(storage_last_used, x.storage_last_used);
+  std::swap(storage_end, x.storage_end);
+  std::swap(last_chunk, x.last_chunk);
+  std::swap(remaining_size, x.remaining_size);
+  std::swap(memory_resource, x.memory_resource);
   std::swap(on_destruction, x.on_destruction);
+  std::swap(on_destruction_at_exit, x.on_destruction_at_exit);
 #ifdef FRUIT_EXTRA_DEBUG
   std::swap(remaining_types, x.remaining_types);
+  std::swap(constructed_objects, x.constructed_objects);
 #endif
   return *this;
 }
@@ -20,6 +20,10 @@
 #include <fruit/impl/util/type_info.h>
 #include <fruit/impl/data_structures/fixed_size_vector.h>
 #include <fruit/impl/meta/component.h>
+#include <fruit/impl/data_structures/resource_allocator.h>
+
+#include <cstddef>
+#include <vector>
 
 #ifdef FRUIT_EXTRA_DEBUG
 #include <unordered_map>
@@ -36,20 +40,68 @@ public:
   using destroy_t = void(*)(void*);  
   
 private:
-  // A pointer to the last used byte in the allocated memory chunk starting at storage_begin.
+  // The header at the beginning of each chunk of storage. Chunks form a linked list, from the most recent one.
+  struct ChunkHeader {
+    ChunkHeader* previous;
+    // The size of the whole chunk, including this header.
+    std::size_t size;
+  };
+
+  // The size of the ChunkHeader rounded up, so that the storage in the chunk starts at a suitably aligned address.
+  static constexpr std::size_t CHUNK_HEADER_SIZE =
+      (sizeof(ChunkHeader) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+
+  // When allocating lazily, the storage is allocated in chunks of (at least) this size, including the header.
+  static constexpr std::size_t LAZY_CHUNK_SIZE = 4096 - 64;
+
+  // A pointer to the last used byte in the current chunk (or a value that makes the next allocation overflow
+  // storage_end, if there's no chunk yet).
   char* storage_last_used = nullptr;
-  
-  // The chunk of memory that will be used for all allocations.
-  char* storage_begin = nullptr;
-  
+
+  // A pointer to one-past-the-end of the current chunk.
+  char* storage_end = nullptr;
+
+  // The most recently allocated chunk, i.e. the one that contains storage_last_used.
+  ChunkHeader* last_chunk = nullptr;
+
+  // An upper bound on the storage that will still be needed in new chunks: the space reserved for all types, minus the
+  // space used in the chunks allocated so far.
+  // Only used when allocating lazily; in the eager case the first chunk has room for everything.
+  std::size_t remaining_size = 0;
+
+  // The resource used for the chunks (and for on_destruction and on_destruction_at_exit), or nullptr to use the global
+  // operator new.
+  MemoryResource* memory_resource = nullptr;
+
+  // Allocates a new chunk that has room for at least `required_space' bytes and makes it the current one.
+  // This is the slow path of constructObject() and allocatePointerArray(), only reached when allocating lazily.
+  void allocateChunk(std::size_t required_space);
+
 #ifdef FRUIT_EXTRA_DEBUG
    std::unordered_map<TypeId, std::size_t> remaining_types;
+
+   struct ConstructedObject {
+     TypeId type;
+     char* begin;
+     std::size_t size;
+   };
+
+   // The objects constructed with constructObject(), in construction (and address) order.
+   std::vector<ConstructedObject> constructed_objects;
+
+   // Prints the pairs of objects in constructed_objects that share a cache line (see fruit::IsolatedInCacheLine).
+   void printObjectsSharingCacheLines() const;
 #endif
   
   // This vector contains the destroy operations that have to be performed at destruction, and
   // the pointers that they must be invoked with. Allows destruction in the correct order.
   // These must be called in reverse order.
   FixedSizeVector<std::pair<destroy_t, void*>> on_destruction;
+
+  // The elements of on_destruction for the objects whose types are marked with fruit::RunDestructorAtExit, in the same
+  // order. These are the only ones performed by runAtExitDestructors().
+  // This is usually empty, so unlike on_destruction it's not reserved upfront.
+  std::vector<std::pair<destroy_t, void*>, ResourceAllocator<std::pair<destroy_t, void*>>> on_destruction_at_exit;
   
   // Destroys an object previously created using constructObject().
   template <typename C>
@@ -81,13 +133,32 @@ public:
     // Each call to this method with getTypeId<T>() allows 1 registerExternallyAllocatedType<T>(...) call on the resulting
     // allocator.
     void addExternallyAllocatedType(TypeId typeId);
+    
+    // Undoes a previous call to addExternallyAllocatedType(typeId).
+    void removeExternallyAllocatedType(TypeId typeId);
+
+    // Undoes a previous call to addType(typeId).
+    void removeType(TypeId typeId);
+    
+    // Each call to this method allows 1 allocatePointerArray<T>(...) call on the resulting allocator. The space for the
+    // elements must be reserved separately, using addPointerArrayElement().
+    void addPointerArray();
+    
+    // Reserves space for 1 element of an array allocated with allocatePointerArray<T>(...).
+    void addPointerArrayElement();
   };
   
   // Constructs an empty allocator (no allocations are allowed).
   FixedSizeAllocator() = default;
   
   // Constructs an allocator for the type set in FixedSizeAllocatorData.
-  FixedSizeAllocator(FixedSizeAllocatorData allocator_data);
+  // The memory is allocated from `memory_resource' (or using the global operator new, if memory_resource is nullptr),
+  // that must outlive this object.
+  // If `allocate_lazily' is false, the storage for all the types is allocated upfront, in a single chunk. Otherwise
+  // it's allocated in smaller chunks as objects are constructed, so that injectors that only construct a few of their
+  // types don't pay for the others. Either way, the constructed objects never move.
+  FixedSizeAllocator(FixedSizeAllocatorData allocator_data, MemoryResource* memory_resource = nullptr,
+                     bool allocate_lazily = false);
   
   FixedSizeAllocator(FixedSizeAllocator&&);
   FixedSizeAllocator& operator=(FixedSizeAllocator&&);
@@ -96,16 +167,40 @@ public:
   FixedSizeAllocator& operator=(const FixedSizeAllocator&) = delete;
   
   // On destruction, all objects allocated with constructObject() and all externally-allocated objects registered with
-  // registerExternallyAllocatedObject() are destroyed.
+  // registerExternallyAllocatedObject() are destroyed, except the ones of types marked with fruit::ProcessLifetime.
   ~FixedSizeAllocator();
+
+  // Destroys (in reverse order) the objects of the types marked with fruit::RunDestructorAtExit, and only those.
+  // This is meant for allocators that are then leaked instead of being destroyed: destroying the allocator after
+  // calling this would destroy these objects again.
+  void runAtExitDestructors();
+
+  // Returns the resource used by this allocator, or nullptr if it uses the global operator new.
+  MemoryResource* getMemoryResource() const;
   
   // Allocates an object of type T, constructing it with the specified arguments. Similar to:
   // new C(args...)
   template <typename AnnotatedT, typename... Args>
   fruit::impl::meta::UnwrapType<fruit::impl::meta::Eval<fruit::impl::meta::RemoveAnnotations(fruit::impl::meta::Type<AnnotatedT>)>>* constructObject(Args&&... args);
   
+  // Reserves the space for an object of type T, without constructing it. The caller must then construct a T there (e.g.
+  // with placement new) and call registerConstructedObject() on it. This is a lower-level alternative to
+  // constructObject(), for when the object is constructed by user code.
+  template <typename AnnotatedT>
+  fruit::impl::meta::UnwrapType<fruit::impl::meta::Eval<fruit::impl::meta::RemoveAnnotations(fruit::impl::meta::Type<AnnotatedT>)>>* allocateObject();
+  
+  // Registers an object constructed in the space returned by allocateObject(), so that it's destroyed together with this
+  // allocator.
+  template <typename T>
+  void registerConstructedObject(T* p);
+  
   template <typename T>
   void registerExternallyAllocatedObject(T* p);
+  
+  // Allocates an uninitialized array of `n' T* pointers. Pointers are trivially destructible, so nothing will be registered
+  // for destruction; the memory is released together with the allocator's storage.
+  template <typename T>
+  T** allocatePointerArray(std::size_t n);
 };
 
 } // namespace impl
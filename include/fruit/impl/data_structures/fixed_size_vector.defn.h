@@ -42,7 +42,9 @@ inline FixedSizeVector<T, Allocator>::FixedSizeVector(std::size_t capacity, Allo
 template <typename T, typename Allocator>
 inline FixedSizeVector<T, Allocator>::~FixedSizeVector() {
   clear();
-  allocator.deallocate(v_begin, capacity);
+  if (capacity != 0) {
+    allocator.deallocate(v_begin, capacity);
+  }
 }
 
 template <typename T, typename Allocator>
@@ -77,10 +79,9 @@ inline const T& FixedSizeVector<T, Allocator>::operator[](std::size_t i) const {
 template <typename T, typename Allocator>
 inline void FixedSizeVector<T, Allocator>::swap(FixedSizeVector& x) {
   std::swap(v_end, x.v_end);
-  std::swap(v_begin, x.v_begin); 
-#ifdef FRUIT_EXTRA_DEBUG
+  std::swap(v_begin, x.v_begin);
   std::swap(capacity, x.capacity);
-#endif
+  std::swap(allocator, x.allocator);
 }
 
 template <typename T, typename Allocator>
@@ -17,6 +17,8 @@
 #ifndef FRUIT_FIXED_SIZE_VECTOR_H
 #define FRUIT_FIXED_SIZE_VECTOR_H
 
+#include <fruit/impl/data_structures/resource_allocator.h>
+
 #include <cstdlib>
 #include <memory>
 
@@ -27,7 +29,7 @@ namespace impl {
  * Similar to std::vector<T>, but the capacity is fixed at construction time, and no reallocations ever happen.
  * The type T must be trivially copyable.
  */
-template <typename T, typename Allocator = std::allocator<T>>
+template <typename T, typename Allocator = ResourceAllocator<T>>
 class FixedSizeVector {
 private:
   // This is not yet implemented in libstdc++ (the STL implementation) shipped with GCC (checked until version 4.9.1).
@@ -52,6 +54,8 @@ public:
   // Copy construction is not allowed, you need to specify the capacity in order to construct the copy.
   FixedSizeVector(const FixedSizeVector& other) = delete;
   FixedSizeVector(const FixedSizeVector& other, std::size_t capacity);
+  // Similar to the constructor above, but the copy uses the specified allocator instead of other's allocator.
+  FixedSizeVector(const FixedSizeVector& other, std::size_t capacity, Allocator allocator);
   
   FixedSizeVector(FixedSizeVector&& other);
   
@@ -30,7 +30,13 @@ namespace impl {
 
 template <typename T, typename Allocator>
 FixedSizeVector<T, Allocator>::FixedSizeVector(const FixedSizeVector& other, std::size_t capacity)
-  : FixedSizeVector(capacity, other.allocator) {
+  : FixedSizeVector(other, capacity, other.allocator) {
+}
+
+template <typename T, typename Allocator>
+FixedSizeVector<T, Allocator>::FixedSizeVector(
+    const FixedSizeVector& other, std::size_t capacity, Allocator allocator)
+  : FixedSizeVector(capacity, allocator) {
   FruitAssert(other.size() <= capacity);
   // This is not just an optimization, we also want to make sure that other.capacity (and therefore
   // also this.capacity) is >0, or we'd pass nullptr to memcpy (although with a size of 0).
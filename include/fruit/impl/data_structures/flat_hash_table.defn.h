@@ -0,0 +1,466 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_FLAT_HASH_TABLE_DEFN_H
+#define FRUIT_FLAT_HASH_TABLE_DEFN_H
+
+#include <fruit/impl/data_structures/flat_hash_table.h>
+#include <fruit/impl/fruit_assert.h>
+#include <fruit/impl/fruit-config.h>
+
+#include <climits>
+#include <new>
+
+namespace fruit {
+namespace impl {
+
+template <typename T>
+inline const T& FlatHashTableIdentityKeyOf::operator()(const T& x) const {
+  return x;
+}
+
+template <typename Pair>
+inline const typename Pair::first_type& FlatHashTableFirstKeyOf::operator()(const Pair& x) const {
+  return x.first;
+}
+
+template <typename Key, typename Element, typename KeyOf, typename Hasher, typename EqualityComparator>
+inline std::size_t FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>::numSlotsForCapacity(
+    std::size_t capacity) {
+  if (capacity == 0) {
+    return 0;
+  }
+  // We keep the load factor (including tombstones) below 3/4, so that probe sequences stay short.
+  std::size_t result = 16;
+  while (result / 4 * 3 < capacity + 1) {
+    result *= 2;
+  }
+  return result;
+}
+
+template <typename Key, typename Element, typename KeyOf, typename Hasher, typename EqualityComparator>
+FRUIT_ALWAYS_INLINE
+inline std::size_t FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>::firstSlotFor(
+    const Key& key) const {
+  FruitAssert(num_slots != 0);
+  // Fibonacci hashing: the multiplication spreads the entropy of the hash into the high bits, so this also works with
+  // identity hashes of aligned pointers (where the low bits are always 0).
+  std::size_t scrambled_hash = std::size_t(hasher(key)) * std::size_t(0x9E3779B97F4A7C15ULL);
+  return scrambled_hash >> hash_shift;
+}
+
+template <typename Key, typename Element, typename KeyOf, typename Hasher, typename EqualityComparator>
+inline std::size_t FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>::findSlot(const Key& key) const {
+  if (num_elements == 0) {
+    return num_slots;
+  }
+  std::size_t mask = num_slots - 1;
+  for (std::size_t i = firstSlotFor(key); ; i = (i + 1) & mask) {
+    switch (states[i]) { // LCOV_EXCL_BR_LINE
+    case EMPTY:
+      return num_slots;
+    case FULL:
+      if (equality_comparator(KeyOf()(elements[i]), key)) {
+        return i;
+      }
+      break;
+    case DELETED:
+      break;
+    }
+  }
+}
+
+template <typename Key, typename Element, typename KeyOf, typename Hasher, typename EqualityComparator>
+inline std::pair<std::size_t, bool>
+FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>::findSlotForInsertion(const Key& key) const {
+  FruitAssert(num_slots != 0);
+  std::size_t mask = num_slots - 1;
+  std::size_t first_deleted_slot = num_slots;
+  for (std::size_t i = firstSlotFor(key); ; i = (i + 1) & mask) {
+    switch (states[i]) { // LCOV_EXCL_BR_LINE
+    case EMPTY:
+      // The key is not in the table. We re-use the first tombstone we found (if any).
+      return {first_deleted_slot == num_slots ? i : first_deleted_slot, false};
+    case FULL:
+      if (equality_comparator(KeyOf()(elements[i]), key)) {
+        return {i, true};
+      }
+      break;
+    case DELETED:
+      if (first_deleted_slot == num_slots) {
+        first_deleted_slot = i;
+      }
+      break;
+    }
+  }
+}
+
+template <typename Key, typename Element, typename KeyOf, typename Hasher, typename EqualityComparator>
+void FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>::rehash(std::size_t new_num_slots) {
+  FruitAssert(new_num_slots != 0);
+  FruitAssert((new_num_slots & (new_num_slots - 1)) == 0);
+  FruitAssert(num_elements < new_num_slots);
+
+  Element* old_elements = elements;
+  SlotState* old_states = states;
+  std::size_t old_num_slots = num_slots;
+
+  ArenaAllocator<SlotState> states_allocator(allocator);
+  elements = allocator.allocate(new_num_slots);
+  states = states_allocator.allocate(new_num_slots);
+  for (std::size_t i = 0; i < new_num_slots; ++i) {
+    states[i] = EMPTY;
+  }
+  num_slots = new_num_slots;
+  num_used_slots = num_elements;
+  hash_shift = sizeof(std::size_t) * CHAR_BIT;
+  for (std::size_t n = new_num_slots; n > 1; n /= 2) {
+    --hash_shift;
+  }
+
+  std::size_t mask = num_slots - 1;
+  for (std::size_t i = 0; i < old_num_slots; ++i) {
+    if (old_states[i] == FULL) {
+      std::size_t j = firstSlotFor(KeyOf()(old_elements[i]));
+      while (states[j] != EMPTY) {
+        j = (j + 1) & mask;
+      }
+      new (&elements[j]) Element(std::move(old_elements[i]));
+      states[j] = FULL;
+      old_elements[i].~Element();
+    }
+  }
+
+  if (old_num_slots != 0) {
+    allocator.deallocate(old_elements, old_num_slots);
+    states_allocator.deallocate(old_states, old_num_slots);
+  }
+}
+
+template <typename Key, typename Element, typename KeyOf, typename Hasher, typename EqualityComparator>
+inline void FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>::destroyElements() {
+  if (!std::is_trivially_destructible<Element>::value) {
+    for (std::size_t i = 0; i < num_slots; ++i) {
+      if (states[i] == FULL) {
+        elements[i].~Element();
+      }
+    }
+  }
+}
+
+template <typename Key, typename Element, typename KeyOf, typename Hasher, typename EqualityComparator>
+inline FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>::FlatHashTable(
+    std::size_t capacity, Hasher hasher, EqualityComparator equality_comparator, allocator_type allocator)
+  : elements(nullptr),
+    states(nullptr),
+    num_slots(0),
+    num_elements(0),
+    num_used_slots(0),
+    hash_shift(0),
+    hasher(hasher),
+    equality_comparator(equality_comparator),
+    allocator(allocator) {
+  reserve(capacity);
+}
+
+template <typename Key, typename Element, typename KeyOf, typename Hasher, typename EqualityComparator>
+FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>::FlatHashTable(const FlatHashTable& other)
+  : FlatHashTable(other.num_elements, other.hasher, other.equality_comparator, other.allocator) {
+  for (const Element& element : other) {
+    insert(element);
+  }
+}
+
+template <typename Key, typename Element, typename KeyOf, typename Hasher, typename EqualityComparator>
+inline FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>::FlatHashTable(FlatHashTable&& other)
+  : elements(other.elements),
+    states(other.states),
+    num_slots(other.num_slots),
+    num_elements(other.num_elements),
+    num_used_slots(other.num_used_slots),
+    hash_shift(other.hash_shift),
+    hasher(other.hasher),
+    equality_comparator(other.equality_comparator),
+    allocator(other.allocator) {
+  other.elements = nullptr;
+  other.states = nullptr;
+  other.num_slots = 0;
+  other.num_elements = 0;
+  other.num_used_slots = 0;
+}
+
+template <typename Key, typename Element, typename KeyOf, typename Hasher, typename EqualityComparator>
+inline FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>&
+FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>::operator=(const FlatHashTable& other) {
+  FlatHashTable copy(other);
+  swap(copy);
+  return *this;
+}
+
+template <typename Key, typename Element, typename KeyOf, typename Hasher, typename EqualityComparator>
+inline FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>&
+FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>::operator=(FlatHashTable&& other) {
+  swap(other);
+  return *this;
+}
+
+template <typename Key, typename Element, typename KeyOf, typename Hasher, typename EqualityComparator>
+inline FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>::~FlatHashTable() {
+  destroyElements();
+  if (num_slots != 0) {
+    allocator.deallocate(elements, num_slots);
+    ArenaAllocator<SlotState>(allocator).deallocate(states, num_slots);
+  }
+}
+
+template <typename Key, typename Element, typename KeyOf, typename Hasher, typename EqualityComparator>
+inline void FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>::swap(FlatHashTable& other) {
+  std::swap(elements, other.elements);
+  std::swap(states, other.states);
+  std::swap(num_slots, other.num_slots);
+  std::swap(num_elements, other.num_elements);
+  std::swap(num_used_slots, other.num_used_slots);
+  std::swap(hash_shift, other.hash_shift);
+  std::swap(hasher, other.hasher);
+  std::swap(equality_comparator, other.equality_comparator);
+  std::swap(allocator, other.allocator);
+}
+
+template <typename Key, typename Element, typename KeyOf, typename Hasher, typename EqualityComparator>
+inline typename FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>::iterator
+FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>::begin() {
+  iterator result(this, 0);
+  result.skipNonFullSlots();
+  return result;
+}
+
+template <typename Key, typename Element, typename KeyOf, typename Hasher, typename EqualityComparator>
+inline typename FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>::iterator
+FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>::end() {
+  return iterator(this, num_slots);
+}
+
+template <typename Key, typename Element, typename KeyOf, typename Hasher, typename EqualityComparator>
+inline typename FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>::const_iterator
+FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>::begin() const {
+  const_iterator result(this, 0);
+  result.skipNonFullSlots();
+  return result;
+}
+
+template <typename Key, typename Element, typename KeyOf, typename Hasher, typename EqualityComparator>
+inline typename FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>::const_iterator
+FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>::end() const {
+  return const_iterator(this, num_slots);
+}
+
+template <typename Key, typename Element, typename KeyOf, typename Hasher, typename EqualityComparator>
+inline std::size_t FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>::size() const {
+  return num_elements;
+}
+
+template <typename Key, typename Element, typename KeyOf, typename Hasher, typename EqualityComparator>
+inline bool FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>::empty() const {
+  return num_elements == 0;
+}
+
+template <typename Key, typename Element, typename KeyOf, typename Hasher, typename EqualityComparator>
+inline typename FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>::iterator
+FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>::find(const Key& key) {
+  return iterator(this, findSlot(key));
+}
+
+template <typename Key, typename Element, typename KeyOf, typename Hasher, typename EqualityComparator>
+inline typename FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>::const_iterator
+FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>::find(const Key& key) const {
+  return const_iterator(this, findSlot(key));
+}
+
+template <typename Key, typename Element, typename KeyOf, typename Hasher, typename EqualityComparator>
+inline std::size_t FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>::count(const Key& key) const {
+  return findSlot(key) == num_slots ? 0 : 1;
+}
+
+template <typename Key, typename Element, typename KeyOf, typename Hasher, typename EqualityComparator>
+inline std::pair<typename FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>::iterator, bool>
+FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>::insert(const Element& element) {
+  return emplace(element);
+}
+
+template <typename Key, typename Element, typename KeyOf, typename Hasher, typename EqualityComparator>
+inline std::pair<typename FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>::iterator, bool>
+FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>::insert(Element&& element) {
+  return emplace(std::move(element));
+}
+
+template <typename Key, typename Element, typename KeyOf, typename Hasher, typename EqualityComparator>
+template <typename... Args>
+inline std::pair<typename FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>::iterator, bool>
+FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>::emplace(Args&&... args) {
+  // The elements stored in these tables are small, so it's fine to construct the element before checking if it's
+  // already present.
+  Element element(std::forward<Args>(args)...);
+  if (num_slots == 0) {
+    rehash(numSlotsForCapacity(1));
+  }
+  std::pair<std::size_t, bool> slot_and_found = findSlotForInsertion(KeyOf()(element));
+  if (slot_and_found.second) {
+    return {iterator(this, slot_and_found.first), false};
+  }
+  if (states[slot_and_found.first] == EMPTY && (num_used_slots + 1) > num_slots / 4 * 3) {
+    // We're about to use a new slot and we'd exceed the maximum load factor, we need to rehash first.
+    // If most used slots are tombstones we rehash to the same size, to clean them up.
+    rehash(numSlotsForCapacity(num_elements + 1));
+    slot_and_found = findSlotForInsertion(KeyOf()(element));
+    FruitAssert(!slot_and_found.second);
+  }
+  std::size_t slot = slot_and_found.first;
+  if (states[slot] == EMPTY) {
+    ++num_used_slots;
+  }
+  new (&elements[slot]) Element(std::move(element));
+  states[slot] = FULL;
+  ++num_elements;
+  return {iterator(this, slot), true};
+}
+
+template <typename Key, typename Element, typename KeyOf, typename Hasher, typename EqualityComparator>
+inline typename FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>::iterator
+FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>::erase(const_iterator itr) {
+  FruitAssert(itr.table == this);
+  FruitAssert(itr.index < num_slots);
+  FruitAssert(states[itr.index] == FULL);
+  elements[itr.index].~Element();
+  states[itr.index] = DELETED;
+  --num_elements;
+  iterator result(this, itr.index + 1);
+  result.skipNonFullSlots();
+  return result;
+}
+
+template <typename Key, typename Element, typename KeyOf, typename Hasher, typename EqualityComparator>
+inline std::size_t FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>::erase(const Key& key) {
+  std::size_t slot = findSlot(key);
+  if (slot == num_slots) {
+    return 0;
+  }
+  erase(const_iterator(this, slot));
+  return 1;
+}
+
+template <typename Key, typename Element, typename KeyOf, typename Hasher, typename EqualityComparator>
+inline void FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>::clear() {
+  destroyElements();
+  for (std::size_t i = 0; i < num_slots; ++i) {
+    states[i] = EMPTY;
+  }
+  num_elements = 0;
+  num_used_slots = 0;
+}
+
+template <typename Key, typename Element, typename KeyOf, typename Hasher, typename EqualityComparator>
+inline void FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>::reserve(std::size_t capacity) {
+  std::size_t new_num_slots = numSlotsForCapacity(capacity);
+  if (new_num_slots > num_slots) {
+    rehash(new_num_slots);
+  }
+}
+
+template <typename Key, typename Element, typename KeyOf, typename Hasher, typename EqualityComparator>
+template <bool is_const>
+inline FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>::Iterator<is_const>::Iterator(
+    table_t* table, std::size_t index)
+  : table(table), index(index) {
+}
+
+template <typename Key, typename Element, typename KeyOf, typename Hasher, typename EqualityComparator>
+template <bool is_const>
+template <bool other_is_const, typename>
+inline FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>::Iterator<is_const>::Iterator(
+    const Iterator<other_is_const>& other)
+  : table(other.table), index(other.index) {
+}
+
+template <typename Key, typename Element, typename KeyOf, typename Hasher, typename EqualityComparator>
+template <bool is_const>
+FRUIT_ALWAYS_INLINE
+inline void FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>::Iterator<is_const>::skipNonFullSlots() {
+  while (index < table->num_slots && table->states[index] != FULL) {
+    ++index;
+  }
+}
+
+template <typename Key, typename Element, typename KeyOf, typename Hasher, typename EqualityComparator>
+template <bool is_const>
+inline typename FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>::template Iterator<is_const>::reference
+FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>::Iterator<is_const>::operator*() const {
+  FruitAssert(index < table->num_slots);
+  FruitAssert(table->states[index] == FULL);
+  return table->elements[index];
+}
+
+template <typename Key, typename Element, typename KeyOf, typename Hasher, typename EqualityComparator>
+template <bool is_const>
+inline typename FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>::template Iterator<is_const>::pointer
+FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>::Iterator<is_const>::operator->() const {
+  return &**this;
+}
+
+template <typename Key, typename Element, typename KeyOf, typename Hasher, typename EqualityComparator>
+template <bool is_const>
+inline typename FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>::template Iterator<is_const>&
+FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>::Iterator<is_const>::operator++() {
+  ++index;
+  skipNonFullSlots();
+  return *this;
+}
+
+template <typename Key, typename Element, typename KeyOf, typename Hasher, typename EqualityComparator>
+template <bool is_const>
+inline typename FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>::template Iterator<is_const>
+FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>::Iterator<is_const>::operator++(int) {
+  Iterator result = *this;
+  ++*this;
+  return result;
+}
+
+template <typename Key, typename Element, typename KeyOf, typename Hasher, typename EqualityComparator>
+template <bool is_const>
+inline bool FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>::Iterator<is_const>::operator==(
+    const Iterator& other) const {
+  return index == other.index;
+}
+
+template <typename Key, typename Element, typename KeyOf, typename Hasher, typename EqualityComparator>
+template <bool is_const>
+inline bool FlatHashTable<Key, Element, KeyOf, Hasher, EqualityComparator>::Iterator<is_const>::operator!=(
+    const Iterator& other) const {
+  return index != other.index;
+}
+
+template <typename Key, typename Value, typename Hasher, typename EqualityComparator>
+inline Value& FlatHashMap<Key, Value, Hasher, EqualityComparator>::operator[](const Key& key) {
+  auto itr = this->find(key);
+  if (itr == this->end()) {
+    itr = this->emplace(key, Value()).first;
+  }
+  return itr->second;
+}
+
+} // namespace impl
+} // namespace fruit
+
+#endif // FRUIT_FLAT_HASH_TABLE_DEFN_H
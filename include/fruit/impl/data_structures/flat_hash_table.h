@@ -0,0 +1,219 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_FLAT_HASH_TABLE_H
+#define FRUIT_FLAT_HASH_TABLE_H
+
+#include <fruit/impl/data_structures/arena_allocator.h>
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace fruit {
+namespace impl {
+
+/**
+ * An open-addressing hash table (with linear probing) that stores the elements inline, in a single array allocated
+ * with an ArenaAllocator. Unlike std::unordered_{set,map}, inserting an element doesn't allocate anything unless the
+ * table needs to grow, and lookups don't chase pointers.
+ *
+ * The hash values are scrambled before use, so an identity hash (e.g. std::hash of a pointer, or of a TypeId) is fine.
+ *
+ * Erasing an element leaves a tombstone in its slot, so erase() never moves other elements: iterators to the other
+ * elements stay valid and it's safe to erase elements while iterating. Inserting an element might grow the table,
+ * invalidating all iterators.
+ *
+ * This is not meant to be used directly, use FlatHashSet and FlatHashMap instead.
+ * - KeyOf should have a const Key& operator()(const Element&) that returns the key of an element.
+ */
+template <typename Key, typename Element, typename KeyOf, typename Hasher, typename EqualityComparator>
+class FlatHashTable {
+private:
+  enum SlotState : unsigned char {
+    EMPTY = 0,
+    FULL,
+    DELETED,
+  };
+
+  // Arrays with num_slots elements. Only the elements whose state is FULL are constructed.
+  Element* elements;
+  SlotState* states;
+
+  // Always 0 or a power of 2.
+  std::size_t num_slots;
+  // Number of FULL slots.
+  std::size_t num_elements;
+  // Number of FULL or DELETED slots.
+  std::size_t num_used_slots;
+  // The number of bits that must be discarded from the scrambled hash to get a slot index.
+  std::size_t hash_shift;
+
+  Hasher hasher;
+  EqualityComparator equality_comparator;
+  ArenaAllocator<Element> allocator;
+
+  // Returns the number of slots needed to store `capacity' elements without growing.
+  static std::size_t numSlotsForCapacity(std::size_t capacity);
+
+  // Returns the first slot that should be probed for this key.
+  std::size_t firstSlotFor(const Key& key) const;
+
+  // Returns the index of the slot with this key, or num_slots if the key is not in the table.
+  std::size_t findSlot(const Key& key) const;
+
+  // Returns the index of the slot with this key (and true) if present. Otherwise returns the index of the slot where
+  // the key should be inserted (and false). Must only be called when num_slots > 0.
+  std::pair<std::size_t, bool> findSlotForInsertion(const Key& key) const;
+
+  // Allocates a new array of new_num_slots slots and moves the elements there.
+  void rehash(std::size_t new_num_slots);
+
+  void destroyElements();
+
+  template <bool is_const>
+  class Iterator {
+  private:
+    using table_t = typename std::conditional<is_const, const FlatHashTable, FlatHashTable>::type;
+    table_t* table;
+    std::size_t index;
+
+    friend class FlatHashTable;
+
+    template <bool>
+    friend class Iterator;
+
+    // Moves index forward until it points to a FULL slot (or to the end).
+    void skipNonFullSlots();
+
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Element;
+    using difference_type = std::ptrdiff_t;
+    using pointer = typename std::conditional<is_const, const Element*, Element*>::type;
+    using reference = typename std::conditional<is_const, const Element&, Element&>::type;
+
+    Iterator() = default;
+    Iterator(table_t* table, std::size_t index);
+
+    // Allows converting an iterator to a const_iterator.
+    template <bool other_is_const, typename = typename std::enable_if<is_const || !other_is_const>::type>
+    Iterator(const Iterator<other_is_const>& other);
+
+    reference operator*() const;
+    pointer operator->() const;
+
+    Iterator& operator++();
+    Iterator operator++(int);
+
+    bool operator==(const Iterator& other) const;
+    bool operator!=(const Iterator& other) const;
+  };
+
+public:
+  using key_type = Key;
+  using value_type = Element;
+  using size_type = std::size_t;
+  using allocator_type = ArenaAllocator<Element>;
+  using iterator = Iterator<false>;
+  using const_iterator = Iterator<true>;
+
+  // Constructs a table that can hold `capacity' elements without growing.
+  FlatHashTable(std::size_t capacity, Hasher hasher, EqualityComparator equality_comparator, allocator_type allocator);
+
+  FlatHashTable(const FlatHashTable& other);
+  FlatHashTable(FlatHashTable&& other);
+
+  FlatHashTable& operator=(const FlatHashTable& other);
+  FlatHashTable& operator=(FlatHashTable&& other);
+
+  ~FlatHashTable();
+
+  void swap(FlatHashTable& other);
+
+  iterator begin();
+  iterator end();
+  const_iterator begin() const;
+  const_iterator end() const;
+
+  std::size_t size() const;
+  bool empty() const;
+
+  iterator find(const Key& key);
+  const_iterator find(const Key& key) const;
+  std::size_t count(const Key& key) const;
+
+  // If an element with the same key is already present, returns an iterator to that element and false (the table is
+  // not modified). Otherwise inserts the element and returns an iterator to it and true.
+  std::pair<iterator, bool> insert(const Element& element);
+  std::pair<iterator, bool> insert(Element&& element);
+
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(Args&&... args);
+
+  // Returns an iterator to the element after the erased one.
+  iterator erase(const_iterator itr);
+  // Returns the number of erased elements (0 or 1).
+  std::size_t erase(const Key& key);
+
+  // Removes all elements, but keeps the allocated slots.
+  void clear();
+
+  // Makes sure that the table can hold `capacity' elements without growing.
+  void reserve(std::size_t capacity);
+};
+
+// Used as KeyOf in FlatHashSet.
+struct FlatHashTableIdentityKeyOf {
+  template <typename T>
+  const T& operator()(const T& x) const;
+};
+
+// Used as KeyOf in FlatHashMap.
+struct FlatHashTableFirstKeyOf {
+  template <typename Pair>
+  const typename Pair::first_type& operator()(const Pair& x) const;
+};
+
+// A hash set with the same interface as std::unordered_set (or at least the subset used in Fruit).
+// See FlatHashTable for the differences.
+template <typename T, typename Hasher, typename EqualityComparator>
+using FlatHashSet = FlatHashTable<T, T, FlatHashTableIdentityKeyOf, Hasher, EqualityComparator>;
+
+// A hash map with the same interface as std::unordered_map (or at least the subset used in Fruit).
+// See FlatHashTable for the differences.
+template <typename Key, typename Value, typename Hasher, typename EqualityComparator>
+class FlatHashMap
+    : public FlatHashTable<Key, std::pair<const Key, Value>, FlatHashTableFirstKeyOf, Hasher, EqualityComparator> {
+private:
+  using Base = FlatHashTable<Key, std::pair<const Key, Value>, FlatHashTableFirstKeyOf, Hasher, EqualityComparator>;
+
+public:
+  using mapped_type = Value;
+
+  using Base::Base;
+
+  // Returns the value for `key', inserting a value-initialized one if `key' is not in the map.
+  Value& operator[](const Key& key);
+};
+
+} // namespace impl
+} // namespace fruit
+
+#include <fruit/impl/data_structures/flat_hash_table.defn.h>
+
+#endif // FRUIT_FLAT_HASH_TABLE_H
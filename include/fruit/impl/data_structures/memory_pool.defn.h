@@ -27,26 +27,38 @@ namespace fruit {
 namespace impl {
 
 inline MemoryPool::MemoryPool()
-  : first_free(nullptr), capacity(0) {
+  : MemoryPool(nullptr) {
+}
+
+inline MemoryPool::MemoryPool(MemoryResource* memory_resource)
+  : memory_resource(memory_resource),
+    last_chunk(nullptr),
+    num_chunks(0),
+    first_free(nullptr),
+    capacity(0) {
 }
 
 inline MemoryPool::MemoryPool(MemoryPool&& other)
-  : allocated_chunks(std::move(other.allocated_chunks)),
+  : memory_resource(other.memory_resource),
+    last_chunk(other.last_chunk),
+    num_chunks(other.num_chunks),
     first_free(other.first_free),
     capacity(other.capacity) {
   // This is to be sure that we don't double-deallocate.
-  other.allocated_chunks.clear();
+  other.last_chunk = nullptr;
 }
 
 inline MemoryPool& MemoryPool::operator=(MemoryPool&& other) {
   destroy();
 
-  allocated_chunks = std::move(other.allocated_chunks);
+  memory_resource = other.memory_resource;
+  last_chunk = other.last_chunk;
+  num_chunks = other.num_chunks;
   first_free = other.first_free;
   capacity = other.capacity;
 
   // This is to be sure that we don't double-deallocate.
-  other.allocated_chunks.clear();
+  other.last_chunk = nullptr;
 
   return *this;
 }
@@ -55,40 +67,31 @@ inline MemoryPool::~MemoryPool() {
   destroy();
 }
 
+inline constexpr std::size_t MemoryPool::chunkSize(std::size_t size_class) {
+  return (std::size_t(4 * 1024) << size_class) - 64;
+}
+
 template <typename T>
 FRUIT_ALWAYS_INLINE
 inline T* MemoryPool::allocate(std::size_t n) {
 #ifdef FRUIT_DISABLE_ARENA_ALLOCATION
-  void* p = operator new(n * sizeof(T));
-  allocated_chunks.push_back(p);
-  return static_cast<T*>(p);
+  return static_cast<T*>(allocateChunk(n * sizeof(T)));
 #else
 
   if (n == 0) {
     n = 1;
   }
+  // sizeof(T) is always a multiple of alignof(T), so we only need to align the first element.
   std::size_t misalignment = std::uintptr_t(first_free) % alignof(T);
-  std::size_t padding = alignof(T) - (sizeof(T) % alignof(T));
-  std::size_t required_space = n*(sizeof(T) + padding);
-  std::size_t required_space_in_chunk = required_space + (alignof(T) - misalignment);
+  std::size_t padding = (alignof(T) - misalignment) % alignof(T);
+  std::size_t required_space = n * sizeof(T);
+  std::size_t required_space_in_chunk = required_space + padding;
   if (required_space_in_chunk > capacity) {
-    // This is to make sure that the push_back below won't throw.
-    if (allocated_chunks.size() == allocated_chunks.capacity()) {
-      allocated_chunks.reserve(1 + 2*allocated_chunks.size());
-    }
-    void* p;
-    if (required_space > CHUNK_SIZE) {
-      p = operator new(required_space); // LCOV_EXCL_BR_LINE
-    } else {
-      p = operator new(CHUNK_SIZE);
-      first_free = static_cast<char*>(p) + required_space;
-      capacity = CHUNK_SIZE - required_space;
-    }
-    allocated_chunks.push_back(p);
-    return static_cast<T*>(p);
+    // The memory returned by allocateChunk() is suitably aligned for any type.
+    return static_cast<T*>(allocateChunk(required_space)); // LCOV_EXCL_BR_LINE
   } else {
     FruitAssert(first_free != nullptr);
-    void* p = first_free + misalignment;
+    void* p = first_free + padding;
     first_free += required_space_in_chunk;
     capacity -= required_space_in_chunk;
     return static_cast<T*>(p);
@@ -96,6 +99,10 @@ inline T* MemoryPool::allocate(std::size_t n) {
 #endif
 }
 
+inline MemoryResource* MemoryPool::getMemoryResource() const {
+  return memory_resource;
+}
+
 } // namespace impl
 } // namespace fruit
 
@@ -17,32 +17,85 @@
 #ifndef FRUIT_MEMORY_POOL_H
 #define FRUIT_MEMORY_POOL_H
 
-#include <vector>
+#include <fruit/impl/data_structures/resource_allocator.h>
+
+#include <cstddef>
 
 namespace fruit {
 namespace impl {
 
 /**
  * A pool of memory that never shrinks and is only deallocated on destruction.
+ * The memory is allocated in chunks from a MemoryResource (or using the global operator new, if none is specified).
  * See also ArenaAllocator, an Allocator backed by a MemoryPool object.
+ *
+ * MemoryPool objects are typically short-lived (e.g. one is used for each injector construction), so when no
+ * MemoryResource is specified the chunks are taken from (and returned to) a small thread-local cache instead of
+ * calling operator new/delete each time.
  */
 class MemoryPool {
 private:
-  // 4KB - 64B.
-  // We don't use the full 4KB because malloc also needs to store some metadata for each block, and we want
-  // malloc to request <=4KB from the OS.
-  constexpr static const std::size_t CHUNK_SIZE = 4 * 1024 - 64;
+  // The number of chunk sizes. The i-th chunk allocated by a pool has size chunkSize(min(i, NUM_CHUNK_SIZE_CLASSES-1)),
+  // i.e. 4KB - 64B, 8KB - 64B, 16KB - 64B and then 32KB - 64B for all the following chunks. This way pools that only
+  // need a bit of memory use small chunks, while the ones that need a lot of memory don't need too many chunks.
+  // We don't use the full 4KB (8KB, etc.) because malloc also needs to store some metadata for each block, and we want
+  // malloc to request <=4KB (8KB, etc.) from the OS.
+  constexpr static const std::size_t NUM_CHUNK_SIZE_CLASSES = 4;
+
+  // The maximum number of free chunks of each size class kept in the thread-local cache.
+  constexpr static const std::size_t MAX_CACHED_CHUNKS_PER_SIZE_CLASS = 4;
+
+  // Stored at the beginning of each chunk.
+  struct ChunkHeader {
+    // The previously-allocated chunk of this pool, or nullptr if this is the first one.
+    ChunkHeader* previous;
+    // The size of the chunk, including this header.
+    std::size_t size;
+    // NUM_CHUNK_SIZE_CLASSES for chunks that are bigger than the chunk size classes (these are never cached).
+    std::size_t size_class;
+  };
+
+  // The space reserved for the ChunkHeader, rounded up so that the memory after it is suitably aligned for any type.
+  constexpr static const std::size_t CHUNK_HEADER_SIZE =
+      (sizeof(ChunkHeader) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+
+  // The thread-local cache of free chunks. Defined in memory_pool.cpp.
+  struct ChunkCache;
+
+  // This is nullptr when the global operator new should be used.
+  MemoryResource* memory_resource;
+
+  // The most recently allocated chunk (the others can be reached following the `previous' pointers), or nullptr if no
+  // chunks have been allocated.
+  ChunkHeader* last_chunk;
+
+  // The number of chunks allocated so far, used to pick the size of the next chunk.
+  std::size_t num_chunks;
 
-  std::vector<void*> allocated_chunks;
   // The memory block [first_free, first_free + capacity) is available for allocation
   char* first_free;
   std::size_t capacity;
 
   void destroy();
 
+  // Returns the total size of the chunks in the specified size class (including the ChunkHeader).
+  static constexpr std::size_t chunkSize(std::size_t size_class);
+
+  // Allocates a chunk with at least `required_space' bytes available (after the ChunkHeader), and returns a pointer to
+  // the first available byte. If the chunk has some space left after the first `required_space' bytes, that space is
+  // used for the following allocations.
+  void* allocateChunk(std::size_t required_space);
+
+  // Returns the cache of the current thread, or nullptr if it was already destroyed because this thread is exiting.
+  static ChunkCache* getChunkCache();
+
 public:
   MemoryPool();
 
+  // Constructs a MemoryPool that allocates memory from `memory_resource' (or using the global operator new, if
+  // memory_resource is nullptr). The MemoryResource must outlive this object.
+  explicit MemoryPool(MemoryResource* memory_resource);
+
   MemoryPool(const MemoryPool&) = delete;
   MemoryPool(MemoryPool&&);
   MemoryPool& operator=(const MemoryPool&) = delete;
@@ -55,6 +108,10 @@ public:
    */
   template <typename T>
   T* allocate(std::size_t n);
+
+  // Returns the MemoryResource used by this pool, or nullptr if it uses the global operator new.
+  // The data structures built using this pool that must outlive it can allocate their memory from the same resource.
+  MemoryResource* getMemoryResource() const;
 };
 
 } // namespace impl
@@ -0,0 +1,66 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_OBJECT_POOL_DEFN_H
+#define FRUIT_OBJECT_POOL_DEFN_H
+
+#include <fruit/impl/data_structures/object_pool.h>
+#include <fruit/impl/fruit_assert.h>
+#include <fruit/impl/fruit-config.h>
+
+namespace fruit {
+namespace impl {
+
+inline ObjectPool::ObjectPool(std::size_t object_size, std::size_t object_alignment)
+  : slot_alignment(object_alignment < alignof(FreeSlot) ? alignof(FreeSlot) : object_alignment),
+    num_slots_in_next_slab(NUM_SLOTS_IN_FIRST_SLAB),
+    last_slab(nullptr),
+    free_list(nullptr),
+    first_unused(nullptr),
+    unused_end(nullptr) {
+  // Each slot must also be able to hold a FreeSlot, and the size must be a multiple of the alignment so that all slots
+  // in a slab are aligned.
+  std::size_t size = object_size < sizeof(FreeSlot) ? sizeof(FreeSlot) : object_size;
+  slot_size = (size + slot_alignment - 1) / slot_alignment * slot_alignment;
+}
+
+FRUIT_ALWAYS_INLINE
+inline void* ObjectPool::allocate() {
+  if (free_list != nullptr) {
+    FreeSlot* slot = free_list;
+    free_list = slot->next;
+    return slot;
+  }
+  if (first_unused == unused_end) {
+    return allocateSlab(); // LCOV_EXCL_BR_LINE
+  }
+  void* p = first_unused;
+  first_unused += slot_size;
+  return p;
+}
+
+FRUIT_ALWAYS_INLINE
+inline void ObjectPool::deallocate(void* p) {
+  FruitAssert(p != nullptr);
+  FreeSlot* slot = static_cast<FreeSlot*>(p);
+  slot->next = free_list;
+  free_list = slot;
+}
+
+} // namespace impl
+} // namespace fruit
+
+#endif // FRUIT_OBJECT_POOL_DEFN_H
@@ -0,0 +1,107 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_OBJECT_POOL_H
+#define FRUIT_OBJECT_POOL_H
+
+#include <cstddef>
+
+namespace fruit {
+namespace impl {
+
+/**
+ * A pool of fixed-size slots, used to store the objects returned by pooled factories (see fruit::PooledPtr).
+ * Unlike MemoryPool, the slots can be deallocated individually; deallocated slots are kept in a free list and reused by
+ * the following allocations. The memory is allocated in slabs of increasing size (using the global operator new), and
+ * it's only returned to the system when the pool is destroyed.
+ *
+ * This class is not thread-safe.
+ */
+class ObjectPool {
+private:
+  // The number of slots in the first slab. Each following slab has twice as many slots as the previous one, up to
+  // MAX_SLAB_SIZE bytes (but slabs always have at least 1 slot).
+  constexpr static const std::size_t NUM_SLOTS_IN_FIRST_SLAB = 8;
+  constexpr static const std::size_t MAX_SLAB_SIZE = 64 * 1024 - 64;
+
+  // Stored at the beginning of each slab.
+  struct SlabHeader {
+    // The previously-allocated slab of this pool, or nullptr if this is the first one.
+    SlabHeader* previous;
+    // The size of the slab, including this header.
+    std::size_t size;
+  };
+
+  // Stored in the slots that are currently free.
+  struct FreeSlot {
+    FreeSlot* next;
+  };
+
+  // The space reserved for the SlabHeader, rounded up so that the memory after it is suitably aligned for any type.
+  constexpr static const std::size_t SLAB_HEADER_SIZE =
+      (sizeof(SlabHeader) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+
+  std::size_t slot_size;
+  std::size_t slot_alignment;
+
+  // The number of slots in the next slab.
+  std::size_t num_slots_in_next_slab;
+
+  // The most recently allocated slab (the others can be reached following the `previous' pointers), or nullptr if no
+  // slabs have been allocated.
+  SlabHeader* last_slab;
+
+  // The slots that were deallocated and can be reused.
+  FreeSlot* free_list;
+
+  // The slots in [first_unused, unused_end) have never been allocated.
+  char* first_unused;
+  char* unused_end;
+
+  // Allocates a new slab and returns its first slot. The other slots in the slab are used for the following allocations.
+  void* allocateSlab();
+
+public:
+  // Constructs a pool of slots that can each hold an object with the specified size and alignment.
+  ObjectPool(std::size_t object_size, std::size_t object_alignment);
+
+  ObjectPool(const ObjectPool&) = delete;
+  ObjectPool(ObjectPool&&) = delete;
+  ObjectPool& operator=(const ObjectPool&) = delete;
+  ObjectPool& operator=(ObjectPool&&) = delete;
+
+  // Deallocates all slabs. Any objects still stored in the slots are NOT destroyed.
+  ~ObjectPool();
+
+  /**
+   * Returns a slot that can hold an object of the size and alignment specified at construction.
+   * Note that this does *not* construct any object at that location.
+   */
+  void* allocate();
+
+  /**
+   * Makes the slot `p' (previously returned by allocate()) available for the following allocations.
+   * Any object stored in the slot must have already been destroyed.
+   */
+  void deallocate(void* p);
+};
+
+} // namespace impl
+} // namespace fruit
+
+#include <fruit/impl/data_structures/object_pool.defn.h>
+
+#endif // FRUIT_OBJECT_POOL_H
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef FRUIT_RESOURCE_ALLOCATOR_DEFN_H
+#define FRUIT_RESOURCE_ALLOCATOR_DEFN_H
+
+#include <fruit/impl/data_structures/resource_allocator.h>
+#include <fruit/memory_resource.h>
+
+#include <new>
+
+namespace fruit {
+namespace impl {
+
+inline void* allocateFromResource(MemoryResource* memory_resource, std::size_t bytes, std::size_t alignment) {
+  if (memory_resource == nullptr) {
+    return operator new(bytes);
+  } else {
+    return memory_resource->allocate(bytes, alignment);
+  }
+}
+
+inline void deallocateFromResource(MemoryResource* memory_resource, void* p, std::size_t bytes, std::size_t alignment) {
+  if (memory_resource == nullptr) {
+    operator delete(p);
+  } else {
+    memory_resource->deallocate(p, bytes, alignment);
+  }
+}
+
+template <typename T>
+inline ResourceAllocator<T>::ResourceAllocator()
+  : memory_resource(nullptr) {
+}
+
+template <typename T>
+inline ResourceAllocator<T>::ResourceAllocator(MemoryResource* memory_resource)
+  : memory_resource(memory_resource) {
+}
+
+template <typename T>
+template <typename U>
+inline ResourceAllocator<T>::ResourceAllocator(const ResourceAllocator<U>& other)
+    : memory_resource(other.memory_resource) {
+}
+
+template <typename T>
+inline MemoryResource* ResourceAllocator<T>::getMemoryResource() const {
+  return memory_resource;
+}
+
+template <typename T>
+inline T* ResourceAllocator<T>::allocate(std::size_t n) {
+  return static_cast<T*>(allocateFromResource(memory_resource, n * sizeof(T), alignof(T)));
+}
+
+template <typename T>
+inline void ResourceAllocator<T>::deallocate(T* p, std::size_t n) {
+  deallocateFromResource(memory_resource, p, n * sizeof(T), alignof(T));
+}
+
+template <class T, class U>
+inline bool operator==(const ResourceAllocator<T>& x, const ResourceAllocator<U>& y) {
+  return x.memory_resource == y.memory_resource;
+}
+
+template <class T, class U>
+inline bool operator!=(const ResourceAllocator<T>& x, const ResourceAllocator<U>& y) {
+  return x.memory_resource != y.memory_resource;
+}
+
+} // namespace impl
+} // namespace fruit
+
+#endif // FRUIT_RESOURCE_ALLOCATOR_DEFN_H
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef FRUIT_RESOURCE_ALLOCATOR_H
+#define FRUIT_RESOURCE_ALLOCATOR_H
+
+#include <fruit/fruit_forward_decls.h>
+
+#include <cstddef>
+#include <type_traits>
+
+namespace fruit {
+namespace impl {
+
+/**
+ * Allocates `bytes' bytes aligned to `alignment' from `memory_resource', or using the global operator new if
+ * `memory_resource' is nullptr.
+ */
+void* allocateFromResource(MemoryResource* memory_resource, std::size_t bytes, std::size_t alignment);
+
+/**
+ * Deallocates memory previously allocated with allocateFromResource(memory_resource, bytes, alignment).
+ */
+void deallocateFromResource(MemoryResource* memory_resource, void* p, std::size_t bytes, std::size_t alignment);
+
+/**
+ * An allocator that allocates memory from a fruit::MemoryResource, or using the global operator new (like
+ * std::allocator) if no MemoryResource is specified.
+ * Unlike ArenaAllocator, this is used for data that outlives the construction of the injector (or normalized component).
+ * The allocator is propagated when the container that uses it is move-assigned or swapped, so that the memory is always
+ * deallocated using the MemoryResource it was allocated with.
+ */
+template <typename T>
+class ResourceAllocator {
+private:
+  // This is nullptr when the global operator new should be used.
+  MemoryResource* memory_resource;
+
+  template <class U>
+  friend class ResourceAllocator;
+
+  template <class U, class V>
+  friend bool operator==(const ResourceAllocator<U>& x, const ResourceAllocator<V>& y);
+
+  template <class U, class V>
+  friend bool operator!=(const ResourceAllocator<U>& x, const ResourceAllocator<V>& y);
+
+public:
+  using value_type = T;
+
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+  template <typename U>
+  struct rebind {
+    using other = ResourceAllocator<U>;
+  };
+
+  // Constructs an allocator that uses the global operator new.
+  ResourceAllocator();
+
+  /**
+   * Constructs an allocator that uses the specified memory resource (or the global operator new, if memory_resource is
+   * nullptr). The MemoryResource object must outlive all the allocated objects.
+   */
+  explicit ResourceAllocator(MemoryResource* memory_resource);
+
+  template <typename U>
+  ResourceAllocator(const ResourceAllocator<U>&);
+
+  // Returns the MemoryResource used by this allocator, or nullptr if it uses the global operator new.
+  MemoryResource* getMemoryResource() const;
+
+  T* allocate(std::size_t n);
+  void deallocate(T* p, std::size_t n);
+};
+
+template <class T, class U>
+bool operator==(const ResourceAllocator<T>&, const ResourceAllocator<U>&);
+
+template <class T, class U>
+bool operator!=(const ResourceAllocator<T>&, const ResourceAllocator<U>&);
+
+} // namespace impl
+} // namespace fruit
+
+#include <fruit/impl/data_structures/resource_allocator.defn.h>
+
+#endif // FRUIT_RESOURCE_ALLOCATOR_H
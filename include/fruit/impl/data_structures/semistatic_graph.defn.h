@@ -18,6 +18,7 @@
 #define SEMISTATIC_GRAPH_DEFN_H
 
 #include <fruit/impl/data_structures/semistatic_graph.h>
+#include <fruit/impl/fruit-config.h>
 
 namespace fruit {
 namespace impl {
@@ -41,10 +42,17 @@ inline Node& SemistaticGraph<NodeId, Node>::node_iterator::getNode() {
   return itr->node;
 }
 
+template <typename NodeId, typename Node>
+inline void SemistaticGraph<NodeId, Node>::node_iterator::prefetch() {
+  // The node might span 2 cache lines, and we need both edges_begin and the node (e.g. for the object pointer).
+  FRUIT_PREFETCH(&itr->edges_begin);
+  FRUIT_PREFETCH(&itr->node);
+}
+
 template <typename NodeId, typename Node>
 inline bool SemistaticGraph<NodeId, Node>::node_iterator::isTerminal() {
   FruitAssert(itr->edges_begin != 1);
-  return itr->edges_begin == 0;
+  return itr->edges_begin == 0 || itr->edges_begin == 2;
 }
 
 template <typename NodeId, typename Node>
@@ -53,6 +61,18 @@ inline void SemistaticGraph<NodeId, Node>::node_iterator::setTerminal() {
   itr->edges_begin = 0;
 }
 
+template <typename NodeId, typename Node>
+inline void SemistaticGraph<NodeId, Node>::node_iterator::setInlineTerminal() {
+  FruitAssert(itr->edges_begin != 1);
+  itr->edges_begin = 2;
+}
+
+template <typename NodeId, typename Node>
+inline bool SemistaticGraph<NodeId, Node>::node_iterator::isInlineTerminal() {
+  FruitAssert(itr->edges_begin != 1);
+  return itr->edges_begin == 2;
+}
+
 template <typename NodeId, typename Node>
 inline bool SemistaticGraph<NodeId, Node>::node_iterator::operator==(const node_iterator& other) const {
   return itr == other.itr;
@@ -72,7 +92,7 @@ inline const Node& SemistaticGraph<NodeId, Node>::const_node_iterator::getNode()
 template <typename NodeId, typename Node>
 inline bool SemistaticGraph<NodeId, Node>::const_node_iterator::isTerminal() {
   FruitAssert(itr->edges_begin != 1);
-  return itr->edges_begin == 0;
+  return itr->edges_begin == 0 || itr->edges_begin == 2;
 }
 
 template <typename NodeId, typename Node>
@@ -85,6 +105,7 @@ template <typename NodeId, typename Node>
 inline typename SemistaticGraph<NodeId, Node>::edge_iterator SemistaticGraph<NodeId, Node>::node_iterator::neighborsBegin() {
   FruitAssert(itr->edges_begin != 0);
   FruitAssert(itr->edges_begin != 1);
+  FruitAssert(itr->edges_begin != 2);
   return edge_iterator{reinterpret_cast<InternalNodeId*>(itr->edges_begin)};
 }
 
@@ -188,6 +209,23 @@ inline const typename SemistaticGraph<NodeId, Node>::NodeData* SemistaticGraph<N
   return p;
 }
 
+template <typename NodeId, typename Node>
+inline std::size_t SemistaticGraph<NodeId, Node>::numNodes() const {
+  return nodes.size();
+}
+
+template <typename NodeId, typename Node>
+inline std::size_t SemistaticGraph<NodeId, Node>::getNodeIndex(node_iterator itr) {
+  return itr.itr - nodes.data();
+}
+
+template <typename NodeId, typename Node>
+inline typename SemistaticGraph<NodeId, Node>::node_iterator SemistaticGraph<NodeId, Node>::atNodeIndex(
+    std::size_t index) {
+  FruitAssert(index < nodes.size());
+  return node_iterator{nodes.data() + index};
+}
+
 } // namespace impl
 } // namespace fruit
 
@@ -69,6 +69,7 @@ private:
   public:
     // If edges_begin==0, this is a terminal node.
     // If edges_begin==1, this node doesn't exist, it's just referenced by another node.
+    // If edges_begin==2, this is a terminal node marked with setInlineTerminal().
     // Otherwise, reinterpret_cast<InternalNodeId*>(edges_begin) is the beginning of the edges range.
     std::uintptr_t edges_begin;
   
@@ -111,12 +112,27 @@ public:
     node_iterator(NodeData* itr);
     
   public:
+    // Constructs an invalid iterator, that can only be assigned to. This is only provided so that arrays of iterators
+    // can be filled later (e.g. by atAll()).
+    node_iterator() = default;
+
     Node& getNode();
     
     bool isTerminal();
     
     // Turns the node into a terminal node, also removing all the deps.
     void setTerminal();
+
+    // Similar to setTerminal(), but also marks the node, so that the client code can tell that the Node stores a value
+    // inline (instead of e.g. a pointer to it). isTerminal() returns true for these nodes too.
+    void setInlineTerminal();
+
+    // Returns true iff setInlineTerminal() was called on this node.
+    bool isInlineTerminal();
+
+    // Starts loading this node into the CPU cache, so that a later access (e.g. to isTerminal() or getNode()) doesn't
+    // have to wait for it. This is just a hint, it has no observable effect.
+    void prefetch();
   
     // Assumes !isTerminal().
     // neighborsEnd() is NOT provided/stored for efficiency, the client code is expected to know the number of neighbors.
@@ -209,11 +225,26 @@ public:
   // Precondition: `nodeId' must exist in the graph.
   // Unlike std::map::at(), this yields undefined behavior if the precondition isn't satisfied (instead of throwing).
   node_iterator at(NodeId nodeId);
+
+  // Equivalent to calling at() for each of the n node IDs (storing the result in results[i]), but faster for multiple
+  // nodes since the lookups are interleaved. The found nodes are also prefetched.
+  // Precondition: all nodes must exist.
+  void atAll(const NodeId* node_ids, std::size_t n, node_iterator* results);
   
   // Prefer using at() when possible, this is slightly slower.
   // Returns end() if the node ID was not found.
   node_iterator find(NodeId nodeId);
   const_node_iterator find(NodeId nodeId) const;
+
+  // The number of nodes, including the ones that are only referenced by other nodes.
+  std::size_t numNodes() const;
+
+  // Returns a number in [0, numNodes()) that identifies the node. A node has the same index in the graphs constructed
+  // from this one with the copy constructor above, so this can be used to refer to the same node in those graphs.
+  std::size_t getNodeIndex(node_iterator itr);
+
+  // The inverse of getNodeIndex().
+  node_iterator atNodeIndex(std::size_t index);
   
 #ifdef FRUIT_EXTRA_DEBUG
   // Emits a runtime error if some node was not created but there is an edge pointing to it.
@@ -103,15 +103,19 @@ SemistaticGraph<NodeId, Node>::SemistaticGraph(NodeIter first, NodeIter last, Me
   // Step 2: fill `nodes' and edges_storage.
   
   // Note that not all of these will be assigned in the loop below.
-  nodes = FixedSizeVector<NodeData>(first_unused_index, NodeData{
+  nodes = FixedSizeVector<NodeData>(
+      first_unused_index,
+      NodeData{
 #ifdef FRUIT_EXTRA_DEBUG
-    NodeId(),
+          NodeId(),
 #endif
-    1,
-    Node()});
+          1,
+          Node()},
+      ResourceAllocator<NodeData>(memory_pool.getMemoryResource()));
   
   // edges_storage[0] is unused, that's the reason for the +1
-  edges_storage = FixedSizeVector<InternalNodeId>(num_edges + 1);
+  edges_storage = FixedSizeVector<InternalNodeId>(
+      num_edges + 1, ResourceAllocator<InternalNodeId>(memory_pool.getMemoryResource()));
   edges_storage.push_back(InternalNodeId());
   
   for (NodeIter i = first; i != last; ++i) {
@@ -175,10 +179,11 @@ SemistaticGraph<NodeId, Node>::SemistaticGraph(
   }
   
   // Step 1d: actually populate node_index_map.
-  node_index_map = SemistaticMap<NodeId, InternalNodeId>(x.node_index_map, std::move(node_ids));
+  node_index_map = SemistaticMap<NodeId, InternalNodeId>(x.node_index_map, std::move(node_ids), memory_pool);
   
   // Step 2: fill `nodes' and `edges_storage'
-  nodes = FixedSizeVector<NodeData>(x.nodes, first_unused_index);
+  nodes = FixedSizeVector<NodeData>(
+      x.nodes, first_unused_index, ResourceAllocator<NodeData>(memory_pool.getMemoryResource()));
   // Note that the loop below does not necessarily assign all of these.
   for (std::size_t i = x.nodes.size(); i < first_unused_index; ++i) {
     nodes.push_back(NodeData{
@@ -190,7 +195,8 @@ SemistaticGraph<NodeId, Node>::SemistaticGraph(
   }
   
   // edges_storage[0] is unused, that's the reason for the +1
-  edges_storage = FixedSizeVector<InternalNodeId>(num_new_edges + 1);
+  edges_storage = FixedSizeVector<InternalNodeId>(
+      num_new_edges + 1, ResourceAllocator<InternalNodeId>(memory_pool.getMemoryResource()));
   edges_storage.push_back(InternalNodeId());
   
   for (NodeIter i = first; i != last; ++i) {
@@ -212,6 +218,21 @@ SemistaticGraph<NodeId, Node>::SemistaticGraph(
 #endif  
 }
 
+template <typename NodeId, typename Node>
+void SemistaticGraph<NodeId, Node>::atAll(const NodeId* node_ids, std::size_t n, node_iterator* results) {
+  // The lookups are done in batches, so that the internal IDs fit in a fixed-size buffer.
+  constexpr std::size_t batch_size = 16;
+  const InternalNodeId* internal_node_ids[batch_size];
+  for (std::size_t batch_begin = 0; batch_begin < n; batch_begin += batch_size) {
+    std::size_t num_in_batch = std::min(batch_size, n - batch_begin);
+    node_index_map.atAll(node_ids + batch_begin, num_in_batch, internal_node_ids);
+    for (std::size_t i = 0; i < num_in_batch; ++i) {
+      results[batch_begin + i] = node_iterator{nodeAtId(*internal_node_ids[i])};
+      results[batch_begin + i].prefetch();
+    }
+  }
+}
+
 #ifdef FRUIT_EXTRA_DEBUG
 template <typename NodeId, typename Node>
 void SemistaticGraph<NodeId, Node>::checkFullyConstructed() {
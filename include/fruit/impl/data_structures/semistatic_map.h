@@ -95,9 +95,11 @@ public:
   // The new map will share data with `map', so must be destroyed before `map' is destroyed.
   // NOTE: If more than O(1) elements are added, calls to at() and find() on the result will *not* be O(1).
   // This is O(new_elements.size()*log(new_elements.size())).
+  // The MemoryPool is only used during construction, the constructed object *can* outlive the memory pool.
   SemistaticMap(
       const SemistaticMap<Key, Value>& map,
-      std::vector<value_type, ArenaAllocator<value_type>>&& new_elements);
+      std::vector<value_type, ArenaAllocator<value_type>>&& new_elements,
+      MemoryPool& memory_pool);
   
   SemistaticMap(SemistaticMap&&) = default;
   SemistaticMap(const SemistaticMap&) = delete;
@@ -110,6 +112,11 @@ public:
   // Precondition: `key' must exist in the map.
   // Unlike std::map::at(), this yields undefined behavior if the precondition isn't satisfied (instead of throwing).
   const Value& at(Key key) const;
+
+  // Equivalent to calling at() for each of the n keys (storing a pointer to the i-th value in results[i]), but the
+  // lookups are interleaved, so that their memory accesses can overlap.
+  // Precondition: all keys must exist in the map.
+  void atAll(const Key* keys, std::size_t n, const Value** results) const;
   
   // Prefer using at() when possible, this is slightly slower.
   // Returns nullptr if the key was not found.
@@ -32,6 +32,7 @@
 #include <fruit/impl/data_structures/semistatic_map.h>
 
 #include <fruit/impl/fruit_assert.h>
+#include <fruit/impl/fruit-config.h>
 #include <fruit/impl/data_structures/fixed_size_vector.templates.h>
 #include <fruit/impl/data_structures/arena_allocator.h>
 
@@ -72,10 +73,12 @@ pick_another:
     }
   }
   
-  values = FixedSizeVector<value_type>(num_values, value_type());
+  values = FixedSizeVector<value_type>(
+      num_values, value_type(), ResourceAllocator<value_type>(memory_pool.getMemoryResource()));
   
   std::partial_sum(count.begin(), count.end(), count.begin());
-  lookup_table = FixedSizeVector<CandidateValuesRange>(count.size());
+  lookup_table = FixedSizeVector<CandidateValuesRange>(
+      count.size(), ResourceAllocator<CandidateValuesRange>(memory_pool.getMemoryResource()));
   for (Unsigned n : count) {
     lookup_table.push_back(CandidateValuesRange{values.data() + n, values.data() + n});
   }
@@ -95,8 +98,12 @@ pick_another:
 
 template <typename Key, typename Value>
 SemistaticMap<Key, Value>::SemistaticMap(const SemistaticMap<Key, Value>& map,
-                                         std::vector<value_type, ArenaAllocator<value_type>>&& new_elements)
-  : hash_function(map.hash_function), lookup_table(map.lookup_table, map.lookup_table.size()) {
+                                         std::vector<value_type, ArenaAllocator<value_type>>&& new_elements,
+                                         MemoryPool& memory_pool)
+  : hash_function(map.hash_function),
+    lookup_table(map.lookup_table,
+                 map.lookup_table.size(),
+                 ResourceAllocator<CandidateValuesRange>(memory_pool.getMemoryResource())) {
     
   // Sort by hash.
   std::sort(new_elements.begin(), new_elements.end(), [this](const value_type& x, const value_type& y) {
@@ -113,7 +120,8 @@ SemistaticMap<Key, Value>::SemistaticMap(const SemistaticMap<Key, Value>& map,
     }
   }
   
-  values = FixedSizeVector<value_type>(num_additional_values);
+  values = FixedSizeVector<value_type>(
+      num_additional_values, ResourceAllocator<value_type>(memory_pool.getMemoryResource()));
   
   // Now actually perform the insertions.
 
@@ -170,6 +178,22 @@ const Value& SemistaticMap<Key, Value>::at(Key key) const {
   }
 }
 
+template <typename Key, typename Value>
+void SemistaticMap<Key, Value>::atAll(const Key* keys, std::size_t n, const Value** results) const {
+  // Step 1: start loading the lookup table entries.
+  for (std::size_t i = 0; i < n; ++i) {
+    FRUIT_PREFETCH(&lookup_table[hash(keys[i])]);
+  }
+  // Step 2: start loading the candidate values. Computing the hashes again is cheaper than storing them.
+  for (std::size_t i = 0; i < n; ++i) {
+    FRUIT_PREFETCH(lookup_table[hash(keys[i])].begin);
+  }
+  // Step 3: the actual lookups, that should now (mostly) hit the cache.
+  for (std::size_t i = 0; i < n; ++i) {
+    results[i] = &at(keys[i]);
+  }
+}
+
 template <typename Key, typename Value>
 const Value* SemistaticMap<Key, Value>::find(Key key) const {
   Unsigned h = hash(key);
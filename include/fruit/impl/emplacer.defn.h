@@ -0,0 +1,41 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_EMPLACER_DEFN_H
+#define FRUIT_EMPLACER_DEFN_H
+
+#include <new>
+#include <utility>
+
+// Redundant, but makes KDevelop happy.
+#include <fruit/emplacer.h>
+
+namespace fruit {
+
+template <typename C>
+inline Emplacer<C>::Emplacer(C* storage)
+  : storage(storage) {
+}
+
+template <typename C>
+template <typename... Args>
+inline C* Emplacer<C>::operator()(Args&&... args) {
+  return new (storage) C(std::forward<Args>(args)...); // LCOV_EXCL_BR_LINE
+}
+
+} // namespace fruit
+
+#endif // FRUIT_EMPLACER_DEFN_H
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_FACTORY_REF_DEFN_H
+#define FRUIT_FACTORY_REF_DEFN_H
+
+#include <fruit/impl/meta/vector.h>
+
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Redundant, but makes KDevelop happy.
+#include <fruit/factory_ref.h>
+
+namespace fruit {
+namespace impl {
+
+// Calls invoke(state, args...) with the elements of an args tuple.
+template <typename IntVector>
+struct InvokeFactoryWithTuple;
+
+template <typename... Ints>
+struct InvokeFactoryWithTuple<fruit::impl::meta::Vector<Ints...>> {
+  template <typename C, typename... Args, typename ArgsTuple>
+  C operator()(C(*invoke)(void*, Args...), void* state, ArgsTuple& args) {
+    // This parameter *is* used, but when the tuple is empty some compilers report is as unused.
+    (void)args;
+    return invoke(state, std::forward<Args>(std::get<Ints::value>(args))...);
+  }
+};
+
+// Calls function(args...) with the elements of an args tuple.
+template <typename IntVector>
+struct InvokeFunctionWithTuple;
+
+template <typename... Ints>
+struct InvokeFunctionWithTuple<fruit::impl::meta::Vector<Ints...>> {
+  template <typename C, typename... Args, typename ArgsTuple>
+  C operator()(const std::function<C(Args...)>& function, ArgsTuple& args) {
+    // This parameter *is* used, but when the tuple is empty some compilers report is as unused.
+    (void)args;
+    return function(std::forward<Args>(std::get<Ints::value>(args))...);
+  }
+};
+
+} // namespace impl
+
+template <typename C, typename... Args>
+inline FactoryRef<C(Args...)>::FactoryRef(invoke_t invoke, void* state)
+  : invoke(invoke), state(state) {
+}
+
+template <typename C, typename... Args>
+inline C FactoryRef<C(Args...)>::operator()(Args... args) const {
+  return invoke(state, std::forward<Args>(args)...);
+}
+
+template <typename C, typename... Args>
+template <typename ArgsFunctor>
+std::vector<C> FactoryRef<C(Args...)>::createBatch(std::size_t n, ArgsFunctor args_for) const {
+  using IntVector = fruit::impl::meta::Eval<fruit::impl::meta::GenerateIntSequence(fruit::impl::meta::Int<sizeof...(Args)>)>;
+  // The args are stored by value, so that args_for(i) can return a temporary even if some of the Args are references.
+  using ArgsTuple = std::tuple<typename std::decay<Args>::type...>;
+  std::vector<C> result;
+  result.reserve(n);
+  if (invoke == &invokeFunction) {
+    // Call the std::function directly, instead of going through invokeFunction() for each object.
+    const std::function<C(Args...)>& function = *static_cast<const std::function<C(Args...)>*>(state);
+    for (std::size_t i = 0; i < n; ++i) {
+      ArgsTuple args(args_for(i));
+      result.emplace_back(fruit::impl::InvokeFunctionWithTuple<IntVector>()(function, args));
+    }
+  } else {
+    for (std::size_t i = 0; i < n; ++i) {
+      ArgsTuple args(args_for(i));
+      result.emplace_back(fruit::impl::InvokeFactoryWithTuple<IntVector>()(invoke, state, args));
+    }
+  }
+  return result;
+}
+
+template <typename C, typename... Args>
+C FactoryRef<C(Args...)>::invokeFunction(void* function, Args... args) {
+  return (*static_cast<const std::function<C(Args...)>*>(function))(std::forward<Args>(args)...);
+}
+
+} // namespace fruit
+
+#endif // FRUIT_FACTORY_REF_DEFN_H
@@ -72,10 +72,23 @@
 #define FRUIT_DEPRECATED_DEFINITION(...) __VA_ARGS__
 #endif
 
+// The cache line size used for the types marked with fruit::IsolatedInCacheLine.
+#ifndef FRUIT_CACHE_LINE_SIZE
+#define FRUIT_CACHE_LINE_SIZE 64
+#endif
+
 #if FRUIT_HAS_MSVC_ASSUME
 #define FRUIT_UNREACHABLE FruitAssert(false); __assume(0)
 #elif FRUIT_HAS_BUILTIN_UNREACHABLE
 #define FRUIT_UNREACHABLE FruitAssert(false); __builtin_unreachable()
 #endif
 
+// Hints the CPU to start loading the cache line at the given address. This is only a hint, so it's a no-op if not
+// supported.
+#if FRUIT_HAS_BUILTIN_PREFETCH
+#define FRUIT_PREFETCH(address) __builtin_prefetch(address)
+#else
+#define FRUIT_PREFETCH(address) (void)(address)
+#endif
+
 #endif // FRUIT_CONFIG_H
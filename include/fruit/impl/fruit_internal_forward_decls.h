@@ -26,6 +26,7 @@ namespace impl {
 class ComponentStorage;
 class NormalizedComponentStorage;
 class InjectorStorage;
+class ObjectPool;
 struct TypeId;
 struct ComponentStorageEntry;
 struct NormalizedBinding;
@@ -188,6 +188,22 @@ struct UnsatisfiedRequirementsInNormalizedComponentError {
     "not provided by the Component (second parameter of the Injector constructor).");
 };
 
+template <typename... UnsatisfiedRequirements>
+struct UnsatisfiedRequirementsInChildInjectorError {
+  static_assert(
+    AlwaysFalse<UnsatisfiedRequirements...>::value,
+    "The requirements in UnsatisfiedRequirements are required by the component passed to createChild() but are "
+    "not provided by the parent injector.");
+};
+
+template <typename... TypesNotProvided>
+struct SharedSingletonsNotProvidedError {
+  static_assert(
+    AlwaysFalse<TypesNotProvided...>::value,
+    "The types in TypesNotProvided are marked as shared singletons of a NormalizedComponent, but the "
+    "NormalizedComponent doesn't provide them.");
+};
+
 template <typename... TypesNotProvided>
 struct TypesInInjectorNotProvidedError {
   static_assert(
@@ -436,6 +452,16 @@ struct UnsatisfiedRequirementsInNormalizedComponentErrorTag {
   using apply = UnsatisfiedRequirementsInNormalizedComponentError<UnsatisfiedRequirements...>;
 };
 
+struct UnsatisfiedRequirementsInChildInjectorErrorTag {
+  template <typename... UnsatisfiedRequirements>
+  using apply = UnsatisfiedRequirementsInChildInjectorError<UnsatisfiedRequirements...>;
+};
+
+struct SharedSingletonsNotProvidedErrorTag {
+  template <typename... TypesNotProvided>
+  using apply = SharedSingletonsNotProvidedError<TypesNotProvided...>;
+};
+
 struct TypesInInjectorNotProvidedErrorTag {
   template <typename... TypesNotProvided>
   using apply = TypesInInjectorNotProvidedError<TypesNotProvided...>;
@@ -26,21 +26,47 @@ namespace fruit {
 
 template <typename... P>
 template <typename... FormalArgs, typename... Args>
-inline Injector<P...>::Injector(Component<P...>(*getComponent)(FormalArgs...), Args&&... args) {
+inline Injector<P...>::Injector(Component<P...>(*getComponent)(FormalArgs...), Args&&... args)
+  : Injector(fruit::impl::MemoryPool(), false, getComponent, std::forward<Args>(args)...) {
+}
+
+template <typename... P>
+template <typename... FormalArgs, typename... Args>
+inline Injector<P...>::Injector(
+    MemoryResource& memory_resource, Component<P...>(*getComponent)(FormalArgs...), Args&&... args)
+  : Injector(fruit::impl::MemoryPool(&memory_resource), false, getComponent, std::forward<Args>(args)...) {
+}
+
+template <typename... P>
+template <typename... FormalArgs, typename... Args>
+inline Injector<P...>::Injector(
+    LazyObjectStorage, Component<P...>(*getComponent)(FormalArgs...), Args&&... args)
+  : Injector(fruit::impl::MemoryPool(), true, getComponent, std::forward<Args>(args)...) {
+}
+
+template <typename... P>
+template <typename... FormalArgs, typename... Args>
+inline Injector<P...>::Injector(
+    fruit::impl::MemoryPool memory_pool, bool lazy_object_storage,
+    Component<P...>(*getComponent)(FormalArgs...), Args&&... args) {
   Component<P...> component = fruit::createComponent().install(getComponent, std::forward<Args>(args)...);
 
-  fruit::impl::MemoryPool memory_pool;
+  // These are the normalized types (e.g. X instead of const X), since these are used as roots when removing unreachable
+  // bindings.
   using exposed_types_t = std::vector<fruit::impl::TypeId, fruit::impl::ArenaAllocator<fruit::impl::TypeId>>;
   exposed_types_t exposed_types =
-      exposed_types_t(
-          std::initializer_list<fruit::impl::TypeId>{fruit::impl::getTypeId<P>()...},
-          fruit::impl::ArenaAllocator<fruit::impl::TypeId>(memory_pool));
+      fruit::impl::getTypeIdsForList<
+          typename fruit::impl::meta::Eval<fruit::impl::meta::SetToVector(
+              typename fruit::impl::meta::Eval<
+                  fruit::impl::meta::ConstructComponentImpl(fruit::impl::meta::Type<P>...)
+              >::Ps)>>(memory_pool);
   storage =
       std::unique_ptr<fruit::impl::InjectorStorage>(
           new fruit::impl::InjectorStorage(
               std::move(component.storage),
               exposed_types,
-              memory_pool));
+              memory_pool,
+              lazy_object_storage));
 }
 
 namespace impl {
@@ -77,6 +103,32 @@ struct InjectorImplHelper {
         None))))>;
   };
   
+  // This performs all checks needed in Injector::createChild().
+  template <typename ParentComp, typename Comp>
+  struct CheckCreateChild {
+    using Op = InstallComponent(Comp, ParentComp);
+
+    // The calculation of MergedComp will also do some checks, e.g. multiple bindings for the same type.
+    using MergedComp = GetResult(Op);
+
+    using TypesNotProvided = SetDifference(RemoveConstFromTypes(Vector<Type<P>...>),
+                                           GetComponentPs(MergedComp));
+    using MergedCompRs = SetDifference(GetComponentRsSuperset(MergedComp),
+                                       GetComponentPs(MergedComp));
+
+    using type = Eval<
+        If(Not(IsEmptySet(MergedCompRs)),
+           ConstructErrorWithArgVector(UnsatisfiedRequirementsInChildInjectorErrorTag, SetToVector(MergedCompRs)),
+        If(Not(IsContained(VectorToSetUnchecked(RemoveConstFromTypes(Vector<Type<P>...>)), GetComponentPs(MergedComp))),
+           ConstructErrorWithArgVector(TypesInInjectorNotProvidedErrorTag, SetToVector(TypesNotProvided)),
+        If(Not(IsContained(VectorToSetUnchecked(RemoveConstTypes(Vector<Type<P>...>)),
+                           GetComponentNonConstRsPs(MergedComp))),
+           ConstructErrorWithArgVector(TypesInInjectorProvidedAsConstOnlyErrorTag,
+               SetToVector(SetDifference(VectorToSetUnchecked(RemoveConstTypes(Vector<Type<P>...>)),
+                                         GetComponentNonConstRsPs(MergedComp)))),
+        None)))>;
+  };
+
   template <typename T>
   struct CheckGet {
     using Comp = ConstructComponentImpl(Type<P>...);
@@ -98,24 +150,131 @@ struct InjectorImplHelper {
 template <typename... P>
 template <typename... NormalizedComponentParams, typename... ComponentParams, typename... FormalArgs, typename... Args>
 inline Injector<P...>::Injector(const NormalizedComponent<NormalizedComponentParams...>& normalized_component,
+                                Component<ComponentParams...>(*getComponent)(FormalArgs...), Args&&... args)
+  : Injector(fruit::impl::MemoryPool(), false, normalized_component, getComponent, std::forward<Args>(args)...) {
+
+  using NormalizedComp = fruit::impl::meta::ConstructComponentImpl(fruit::impl::meta::Type<NormalizedComponentParams>...);
+  using Comp1 = fruit::impl::meta::ConstructComponentImpl(fruit::impl::meta::Type<ComponentParams>...);
+  // We don't check whether the construction of NormalizedComp or Comp resulted in errors here; if they did, the instantiation
+  // of NormalizedComponent<NormalizedComponentParams...> or Component<ComponentParams...> would have resulted in an error already.
+  
+  using E = typename fruit::impl::meta::InjectorImplHelper<P...>::template CheckConstructionFromNormalizedComponent<NormalizedComp, Comp1>::type;
+  (void)typename fruit::impl::meta::CheckIfError<E>::type();
+}
+
+template <typename... P>
+template <typename... NormalizedComponentParams, typename... ComponentParams, typename... FormalArgs, typename... Args>
+inline Injector<P...>::Injector(MemoryResource& memory_resource,
+                                const NormalizedComponent<NormalizedComponentParams...>& normalized_component,
+                                Component<ComponentParams...>(*getComponent)(FormalArgs...), Args&&... args)
+  : Injector(fruit::impl::MemoryPool(&memory_resource), false, normalized_component, getComponent, std::forward<Args>(args)...) {
+
+  // Same checks as in the constructor above.
+  using NormalizedComp = fruit::impl::meta::ConstructComponentImpl(fruit::impl::meta::Type<NormalizedComponentParams>...);
+  using Comp1 = fruit::impl::meta::ConstructComponentImpl(fruit::impl::meta::Type<ComponentParams>...);
+  using E = typename fruit::impl::meta::InjectorImplHelper<P...>::template CheckConstructionFromNormalizedComponent<NormalizedComp, Comp1>::type;
+  (void)typename fruit::impl::meta::CheckIfError<E>::type();
+}
+
+template <typename... P>
+template <typename... NormalizedComponentParams, typename... ComponentParams, typename... FormalArgs, typename... Args>
+inline Injector<P...>::Injector(LazyObjectStorage,
+                                const NormalizedComponent<NormalizedComponentParams...>& normalized_component,
+                                Component<ComponentParams...>(*getComponent)(FormalArgs...), Args&&... args)
+  : Injector(fruit::impl::MemoryPool(), true, normalized_component, getComponent, std::forward<Args>(args)...) {
+
+  // Same checks as in the constructor that doesn't take a LazyObjectStorage.
+  using NormalizedComp = fruit::impl::meta::ConstructComponentImpl(fruit::impl::meta::Type<NormalizedComponentParams>...);
+  using Comp1 = fruit::impl::meta::ConstructComponentImpl(fruit::impl::meta::Type<ComponentParams>...);
+  using E = typename fruit::impl::meta::InjectorImplHelper<P...>::template CheckConstructionFromNormalizedComponent<NormalizedComp, Comp1>::type;
+  (void)typename fruit::impl::meta::CheckIfError<E>::type();
+}
+
+template <typename... P>
+template <typename... NormalizedComponentParams, typename... ComponentParams, typename... FormalArgs, typename... Args>
+inline Injector<P...>::Injector(fruit::impl::MemoryPool memory_pool, bool lazy_object_storage,
+                                const NormalizedComponent<NormalizedComponentParams...>& normalized_component,
                                 Component<ComponentParams...>(*getComponent)(FormalArgs...), Args&&... args) {
   Component<ComponentParams...> component = fruit::createComponent().install(getComponent, std::forward<Args>(args)...);
 
-  fruit::impl::MemoryPool memory_pool;
   storage =
       std::unique_ptr<fruit::impl::InjectorStorage>(
           new fruit::impl::InjectorStorage(
               *(normalized_component.storage.storage),
               std::move(component.storage),
-              memory_pool));
+              memory_pool,
+              lazy_object_storage));
+}
 
-  using NormalizedComp = fruit::impl::meta::ConstructComponentImpl(fruit::impl::meta::Type<NormalizedComponentParams>...);
+template <typename... P>
+inline Injector<P...>::Injector(std::unique_ptr<fruit::impl::InjectorStorage> storage)
+  : storage(std::move(storage)) {
+}
+
+template <typename... P>
+inline Injector<P...>::~Injector() {
+  fruit::impl::InjectorStorage::destroy(std::move(storage));
+}
+
+template <typename... P>
+template <typename... ChildP, typename... ComponentParams, typename... FormalArgs, typename... Args>
+inline Injector<ChildP...> Injector<P...>::createChild(
+    Component<ComponentParams...>(*getComponent)(FormalArgs...), Args&&... args) {
+  return createChildWithMemoryResource<ChildP...>(storage->getMemoryResource(), getComponent,
+                                                  std::forward<Args>(args)...);
+}
+
+template <typename... P>
+template <typename... ChildP, typename... ComponentParams, typename... FormalArgs, typename... Args>
+inline Injector<ChildP...> Injector<P...>::createChild(
+    MemoryResource& memory_resource, Component<ComponentParams...>(*getComponent)(FormalArgs...), Args&&... args) {
+  return createChildWithMemoryResource<ChildP...>(&memory_resource, getComponent, std::forward<Args>(args)...);
+}
+
+template <typename... P>
+template <typename... ChildP, typename... ComponentParams, typename... FormalArgs, typename... Args>
+inline Injector<ChildP...> Injector<P...>::createChildWithMemoryResource(
+    fruit::MemoryResource* memory_resource,
+    Component<ComponentParams...>(*getComponent)(FormalArgs...), Args&&... args) {
+  using ParentComp = fruit::impl::meta::ConstructComponentImpl(fruit::impl::meta::Type<P>...);
   using Comp1 = fruit::impl::meta::ConstructComponentImpl(fruit::impl::meta::Type<ComponentParams>...);
-  // We don't check whether the construction of NormalizedComp or Comp resulted in errors here; if they did, the instantiation
-  // of NormalizedComponent<NormalizedComponentParams...> or Component<ComponentParams...> would have resulted in an error already.
-  
-  using E = typename fruit::impl::meta::InjectorImplHelper<P...>::template CheckConstructionFromNormalizedComponent<NormalizedComp, Comp1>::type;
+
+  using E = typename fruit::impl::meta::InjectorImplHelper<ChildP...>::template CheckCreateChild<ParentComp, Comp1>::type;
   (void)typename fruit::impl::meta::CheckIfError<E>::type();
+
+  Component<ComponentParams...> component = fruit::createComponent().install(getComponent, std::forward<Args>(args)...);
+
+  fruit::impl::MemoryPool memory_pool(memory_resource);
+  using type_ids_t = std::vector<fruit::impl::TypeId, fruit::impl::ArenaAllocator<fruit::impl::TypeId>>;
+  // These are the normalized types (e.g. X instead of const X), like in the 1-argument constructor.
+  type_ids_t exposed_types =
+      fruit::impl::getTypeIdsForList<
+          typename fruit::impl::meta::Eval<fruit::impl::meta::SetToVector(
+              typename fruit::impl::meta::Eval<
+                  fruit::impl::meta::ConstructComponentImpl(fruit::impl::meta::Type<ChildP>...)
+              >::Ps)>>(memory_pool);
+  // A binding for each type that the child gets from this injector: the requirements of the child's component and the
+  // types exposed by the child that its component doesn't provide.
+  std::vector<fruit::impl::ComponentStorageEntry, fruit::impl::ArenaAllocator<fruit::impl::ComponentStorageEntry>>
+      entries_from_parent =
+      fruit::impl::GetComponentStorageEntriesForParentObjectsHelper<
+          typename fruit::impl::meta::Eval<fruit::impl::meta::SetToVector(
+              fruit::impl::meta::SetDifference(
+                  fruit::impl::meta::SetUnion(
+                      fruit::impl::meta::GetComponentRsSuperset(Comp1),
+                      fruit::impl::meta::VectorToSetUnchecked(
+                          fruit::impl::meta::RemoveConstFromTypes(
+                              fruit::impl::meta::Vector<fruit::impl::meta::Type<ChildP>...>))),
+                  fruit::impl::meta::GetComponentPs(Comp1)))>>()(memory_pool);
+
+  return Injector<ChildP...>(
+      std::unique_ptr<fruit::impl::InjectorStorage>(
+          new fruit::impl::InjectorStorage(
+              *storage,
+              std::move(component.storage),
+              exposed_types,
+              entries_from_parent,
+              memory_pool)));
 }
 
 template <typename... P>
@@ -127,6 +286,20 @@ inline Injector<P...>::RemoveAnnotations<T> Injector<P...>::get() {
   return storage->template get<T>();
 }
 
+template <typename... P>
+template <typename... T>
+inline std::tuple<typename Injector<P...>::template RemoveAnnotations<T>...> Injector<P...>::getAll() {
+
+  // The first element is just to avoid declaring an array of length 0.
+  bool unused[] = {
+      false,
+      ((void)typename fruit::impl::meta::CheckIfError<
+           typename fruit::impl::meta::InjectorImplHelper<P...>::template CheckGet<T>::type>::type(),
+       false)...};
+  (void)unused;
+  return storage->template getAll<T...>();
+}
+
 template <typename... P>
 template <typename T>
 inline Injector<P...>::operator T() {
@@ -135,9 +308,8 @@ inline Injector<P...>::operator T() {
 
 template <typename... P>
 template <typename AnnotatedC>
-inline const std::vector<
-    typename fruit::Injector<P...>::template RemoveAnnotationsHelper<AnnotatedC>::type
-    *>& Injector<P...>::getMultibindings() {
+inline const std::vector<typename Injector<P...>::template RemoveAnnotations<AnnotatedC>*>&
+Injector<P...>::getMultibindings() {
 
   using Op = fruit::impl::meta::Eval<
       fruit::impl::meta::CheckNormalizedTypes(
@@ -148,6 +320,20 @@ inline const std::vector<
   return storage->template getMultibindings<AnnotatedC>();
 }
 
+template <typename... P>
+template <typename AnnotatedC>
+inline Span<typename Injector<P...>::template RemoveAnnotations<AnnotatedC>* const>
+Injector<P...>::getMultibindingsSpan() {
+
+  using Op = fruit::impl::meta::Eval<
+      fruit::impl::meta::CheckNormalizedTypes(
+          fruit::impl::meta::Vector<
+              fruit::impl::meta::Type<AnnotatedC>>)>;
+  (void)typename fruit::impl::meta::CheckIfError<Op>::type();
+
+  return storage->template getMultibindingsSpan<AnnotatedC>();
+}
+
 template <typename... P>
 inline void Injector<P...>::eagerlyInjectAll() {
   // Eagerly inject normal bindings.
@@ -157,6 +343,11 @@ inline void Injector<P...>::eagerlyInjectAll() {
   storage->eagerlyInjectMultibindings();
 }
 
+template <typename... P>
+inline void Injector<P...>::setProcessLifetime() {
+  storage->setProcessLifetime();
+}
+
 } // namespace fruit
 
 
@@ -41,6 +41,9 @@ struct InjectorAccessorForTests {
    * you need all the following to be true:
    * * C was explicitly bound in a component, or C was a dependency (direct or indirect) of a type that was explicitly bound
    * * C was not bound to any interface (note however that if C was bound to I, you can do unsafeGet<I>() instead).
+   * * If the injector was created directly from a Component (without a NormalizedComponent), C must also be reachable
+   *   from the types exposed by the injector or from a multibinding. Unreachable bindings are removed during
+   *   normalization.
    *
    * Otherwise this method will return nullptr.
    */
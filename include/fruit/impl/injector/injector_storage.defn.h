@@ -24,9 +24,16 @@
 #include <fruit/impl/meta/vector.h>
 #include <fruit/impl/meta/component.h>
 #include <fruit/impl/component_storage/component_storage_entry.h>
+#include <fruit/emplacer.h>
+#include <fruit/factory_ref.h>
+#include <fruit/pooled_ptr.h>
 
 #include <cassert>
 
+#ifdef FRUIT_EXTRA_DEBUG
+#include <iostream>
+#endif
+
 // Redundant, but makes KDevelop happy.
 #include <fruit/impl/injector/injector_storage.h>
 
@@ -55,14 +62,14 @@ inline std::ptrdiff_t InjectorStorage::BindingDataNodeIter::operator-(BindingDat
 
 inline TypeId InjectorStorage::BindingDataNodeIter::getId() {
   // For these kinds the type_id has a different meaning, but we never need to call this method for those.
-  FruitAssert(itr->kind != ComponentStorageEntry::Kind::COMPRESSED_BINDING);
-  FruitAssert(itr->kind != ComponentStorageEntry::Kind::LAZY_COMPONENT_WITH_NO_ARGS);
-  FruitAssert(itr->kind != ComponentStorageEntry::Kind::REPLACED_LAZY_COMPONENT_WITH_NO_ARGS);
-  FruitAssert(itr->kind != ComponentStorageEntry::Kind::REPLACEMENT_LAZY_COMPONENT_WITH_NO_ARGS);
-  FruitAssert(itr->kind != ComponentStorageEntry::Kind::LAZY_COMPONENT_WITH_ARGS);
-  FruitAssert(itr->kind != ComponentStorageEntry::Kind::REPLACED_LAZY_COMPONENT_WITH_ARGS);
-  FruitAssert(itr->kind != ComponentStorageEntry::Kind::REPLACEMENT_LAZY_COMPONENT_WITH_ARGS);
-  return itr->type_id;
+  FruitAssert(itr->getKind() != ComponentStorageEntry::Kind::COMPRESSED_BINDING);
+  FruitAssert(itr->getKind() != ComponentStorageEntry::Kind::LAZY_COMPONENT_WITH_NO_ARGS);
+  FruitAssert(itr->getKind() != ComponentStorageEntry::Kind::REPLACED_LAZY_COMPONENT_WITH_NO_ARGS);
+  FruitAssert(itr->getKind() != ComponentStorageEntry::Kind::REPLACEMENT_LAZY_COMPONENT_WITH_NO_ARGS);
+  FruitAssert(itr->getKind() != ComponentStorageEntry::Kind::LAZY_COMPONENT_WITH_ARGS);
+  FruitAssert(itr->getKind() != ComponentStorageEntry::Kind::REPLACED_LAZY_COMPONENT_WITH_ARGS);
+  FruitAssert(itr->getKind() != ComponentStorageEntry::Kind::REPLACEMENT_LAZY_COMPONENT_WITH_ARGS);
+  return itr->getTypeId();
 }
     
 inline NormalizedBinding InjectorStorage::BindingDataNodeIter::getValue() {
@@ -71,29 +78,29 @@ inline NormalizedBinding InjectorStorage::BindingDataNodeIter::getValue() {
 
 inline bool InjectorStorage::BindingDataNodeIter::isTerminal() {
 #ifdef FRUIT_EXTRA_DEBUG
-  if (itr->kind != ComponentStorageEntry::Kind::BINDING_FOR_CONSTRUCTED_OBJECT
-      && itr->kind != ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_ALLOCATION
-      && itr->kind != ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_NO_ALLOCATION
-      && itr->kind != ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_WITH_UNKNOWN_ALLOCATION) {
-    std::cerr << "Unexpected binding kind: " << (std::size_t)itr->kind << std::endl;
+  if (itr->getKind() != ComponentStorageEntry::Kind::BINDING_FOR_CONSTRUCTED_OBJECT
+      && itr->getKind() != ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_ALLOCATION
+      && itr->getKind() != ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_NO_ALLOCATION
+      && itr->getKind() != ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_WITH_UNKNOWN_ALLOCATION) {
+    std::cerr << "Unexpected binding kind: " << (std::size_t)itr->getKind() << std::endl;
     FruitAssert(false);
   }
 #endif
-  return itr->kind == ComponentStorageEntry::Kind::BINDING_FOR_CONSTRUCTED_OBJECT;
+  return itr->getKind() == ComponentStorageEntry::Kind::BINDING_FOR_CONSTRUCTED_OBJECT;
 }
 
 inline const TypeId* InjectorStorage::BindingDataNodeIter::getEdgesBegin() {
-  FruitAssert(itr->kind == ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_ALLOCATION
-      || itr->kind == ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_NO_ALLOCATION
-      || itr->kind == ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_WITH_UNKNOWN_ALLOCATION);
-  return itr->binding_for_object_to_construct.deps->deps;
+  FruitAssert(itr->getKind() == ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_ALLOCATION
+      || itr->getKind() == ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_NO_ALLOCATION
+      || itr->getKind() == ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_WITH_UNKNOWN_ALLOCATION);
+  return itr->binding_for_object_to_construct.data->deps.deps;
 }
 
 inline const TypeId* InjectorStorage::BindingDataNodeIter::getEdgesEnd() {
-  FruitAssert(itr->kind == ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_ALLOCATION
-      || itr->kind == ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_NO_ALLOCATION
-      || itr->kind == ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_WITH_UNKNOWN_ALLOCATION);
-  return itr->binding_for_object_to_construct.deps->deps + itr->binding_for_object_to_construct.deps->num_deps;
+  FruitAssert(itr->getKind() == ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_ALLOCATION
+      || itr->getKind() == ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_NO_ALLOCATION
+      || itr->getKind() == ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_WITH_UNKNOWN_ALLOCATION);
+  return itr->binding_for_object_to_construct.data->deps.deps + itr->binding_for_object_to_construct.data->deps.num_deps;
 }
 
 template <typename AnnotatedT>
@@ -102,65 +109,78 @@ struct GetFirstStage;
 // General case, value.
 template <typename C>
 struct GetFirstStage {
-  const C* operator()(InjectorStorage& injector, InjectorStorage::Graph::node_iterator node_itr) {
-    return injector.getPtr<C>(node_itr);
+  const C* operator()(InjectorStorage& injector, InjectorStorage::Graph::node_iterator node_itr,
+                      const void* p = nullptr) {
+    return injector.getPtr<C>(node_itr, p);
   }
 };
 
 template <typename C>
 struct GetFirstStage<const C> {
-  const C* operator()(InjectorStorage& injector, InjectorStorage::Graph::node_iterator node_itr) {
-    return injector.getPtr<C>(node_itr);
+  const C* operator()(InjectorStorage& injector, InjectorStorage::Graph::node_iterator node_itr,
+                      const void* p = nullptr) {
+    return injector.getPtr<C>(node_itr, p);
   }
 };
 
 template <typename C>
 struct GetFirstStage<std::shared_ptr<C>> {
   // This method is covered by tests, even though lcov doesn't detect that.
-  C* operator()(InjectorStorage& injector, InjectorStorage::Graph::node_iterator node_itr) {
+  C* operator()(InjectorStorage& injector, InjectorStorage::Graph::node_iterator node_itr, const void* p = nullptr) {
     FruitAssert(node_itr.getNode().is_nonconst);
-    return const_cast<C*>(injector.getPtr<C>(node_itr));
+    return const_cast<C*>(injector.getPtr<C>(node_itr, p));
   }
 };
 
 template <typename C>
 struct GetFirstStage<C*> {
-  C* operator()(InjectorStorage& injector, InjectorStorage::Graph::node_iterator node_itr) {
+  C* operator()(InjectorStorage& injector, InjectorStorage::Graph::node_iterator node_itr, const void* p = nullptr) {
     FruitAssert(node_itr.getNode().is_nonconst);
-    return const_cast<C*>(injector.getPtr<C>(node_itr));
+    return const_cast<C*>(injector.getPtr<C>(node_itr, p));
   }
 };
 
 template <typename C>
 struct GetFirstStage<const C*> {
-  const C* operator()(InjectorStorage& injector, InjectorStorage::Graph::node_iterator node_itr) {
-    return injector.getPtr<C>(node_itr);
+  const C* operator()(InjectorStorage& injector, InjectorStorage::Graph::node_iterator node_itr,
+                      const void* p = nullptr) {
+    return injector.getPtr<C>(node_itr, p);
   }
 };
 
 template <typename C>
 struct GetFirstStage<C&> {
-  C* operator()(InjectorStorage& injector, InjectorStorage::Graph::node_iterator node_itr) {
+  C* operator()(InjectorStorage& injector, InjectorStorage::Graph::node_iterator node_itr, const void* p = nullptr) {
     FruitAssert(node_itr.getNode().is_nonconst);
-    return const_cast<C*>(injector.getPtr<C>(node_itr));
+    return const_cast<C*>(injector.getPtr<C>(node_itr, p));
   }
 };
 
 template <typename C>
 struct GetFirstStage<const C&> {
   // This method is covered by tests, even though lcov doesn't detect that.
-  const C* operator()(InjectorStorage& injector, InjectorStorage::Graph::node_iterator node_itr) {
-    return injector.getPtr<C>(node_itr);
+  const C* operator()(InjectorStorage& injector, InjectorStorage::Graph::node_iterator node_itr,
+                      const void* p = nullptr) {
+    return injector.getPtr<C>(node_itr, p);
   }
 };
 
 template <typename C>
 struct GetFirstStage<Provider<C>> {
-  Provider<C> operator()(InjectorStorage& injector, InjectorStorage::Graph::node_iterator node_itr) {
+  // Providers are lazy, so no pointer is ever passed here.
+  Provider<C> operator()(InjectorStorage& injector, InjectorStorage::Graph::node_iterator node_itr, const void* = nullptr) {
     return Provider<C>(&injector, node_itr);
   }
 };
 
+template <typename C, typename... Args>
+struct GetFirstStage<FactoryRef<C(Args...)>> {
+  FactoryRef<C(Args...)> operator()(InjectorStorage& injector, InjectorStorage::Graph::node_iterator node_itr,
+                                    const void* p = nullptr) {
+    return InjectorStorage::createFactoryRef(*injector.getPtr<std::function<C(Args...)>>(node_itr, p));
+  }
+};
+
 template <typename Annotation, typename T>
 struct GetFirstStage<fruit::Annotated<Annotation, T>> : public GetFirstStage<T> {
 };
@@ -227,6 +247,13 @@ struct GetSecondStage<Provider<C>> {
   }
 };
 
+template <typename C, typename... Args>
+struct GetSecondStage<FactoryRef<C(Args...)>> {
+  FactoryRef<C(Args...)> operator()(FactoryRef<C(Args...)> f) {
+    return f;
+  }
+};
+
 template <typename Annotation, typename T>
 struct GetSecondStage<fruit::Annotated<Annotation, T>> : public GetSecondStage<T> {
 };
@@ -236,12 +263,50 @@ inline InjectorStorage::RemoveAnnotations<AnnotatedT> InjectorStorage::get() {
   return GetSecondStage<AnnotatedT>()(GetFirstStage<AnnotatedT>()(*this, lazyGetPtr<NormalizeType<AnnotatedT>>()));
 }
 
+template <typename AnnotatedTs,
+          typename Indexes = fruit::impl::meta::Eval<
+              fruit::impl::meta::GenerateIntSequence(fruit::impl::meta::VectorSize(AnnotatedTs))>>
+struct GetAllFromNodeIterators;
+
+template <typename... AnnotatedT, typename... Indexes>
+struct GetAllFromNodeIterators<fruit::impl::meta::Vector<fruit::impl::meta::Type<AnnotatedT>...>,
+                               fruit::impl::meta::Vector<Indexes...>> {
+  std::tuple<InjectorStorage::RemoveAnnotations<AnnotatedT>...> operator()(
+      InjectorStorage& injector, const InjectorStorage::Graph::node_iterator* itrs, const void* const* ptrs) {
+    // These *are* used below, but when there are no AnnotatedT some compilers report them as unused.
+    (void)injector;
+    (void)itrs;
+    (void)ptrs;
+    return std::tuple<InjectorStorage::RemoveAnnotations<AnnotatedT>...>(
+        injector.get<InjectorStorage::RemoveAnnotations<AnnotatedT>>(itrs[Indexes::value], ptrs[Indexes::value])...);
+  }
+};
+
+template <typename... AnnotatedT>
+inline std::tuple<InjectorStorage::RemoveAnnotations<AnnotatedT>...> InjectorStorage::getAll() {
+  // The last elements are just to avoid declaring arrays of length 0.
+  const TypeId types[] = {getTypeId<NormalizeType<AnnotatedT>>()..., TypeId{nullptr}};
+  const bool is_lazy[] = {IsLazyDep<AnnotatedT>::value..., false};
+  Graph::node_iterator itrs[sizeof...(AnnotatedT) + 1];
+  const void* ptrs[sizeof...(AnnotatedT) + 1];
+  bindings.atAll(types, sizeof...(AnnotatedT), itrs);
+  constructAll(itrs, is_lazy, sizeof...(AnnotatedT), ptrs);
+  return GetAllFromNodeIterators<fruit::impl::meta::Vector<fruit::impl::meta::Type<AnnotatedT>...>>()(
+      *this, itrs, ptrs);
+}
+
 template <typename T>
 inline T InjectorStorage::get(InjectorStorage::Graph::node_iterator node_iterator) {
   FruitStaticAssert(fruit::impl::meta::IsSame(fruit::impl::meta::Type<T>, fruit::impl::meta::RemoveAnnotations(fruit::impl::meta::Type<T>)));
   return GetSecondStage<T>()(GetFirstStage<T>()(*this, node_iterator));
 }
 
+template <typename T>
+inline T InjectorStorage::get(InjectorStorage::Graph::node_iterator node_iterator, const void* p) {
+  FruitStaticAssert(fruit::impl::meta::IsSame(fruit::impl::meta::Type<T>, fruit::impl::meta::RemoveAnnotations(fruit::impl::meta::Type<T>)));
+  return GetSecondStage<T>()(GetFirstStage<T>()(*this, node_iterator, p));
+}
+
 template <typename AnnotatedC>
 inline InjectorStorage::Graph::node_iterator InjectorStorage::lazyGetPtr() {
   return lazyGetPtr(getTypeId<AnnotatedC>());
@@ -252,6 +317,9 @@ inline InjectorStorage::Graph::node_iterator InjectorStorage::lazyGetPtr(Graph::
   Graph::node_iterator itr = deps.getNodeIterator(dep_index, bindings_begin);
   FruitAssert(bindings.find(getTypeId<AnnotatedC>()) == itr);
   FruitAssert(!(bindings.end() == itr));
+  // The node is only accessed later, after the lazyGetPtr() calls for the other deps (see outerConstructHelper), so
+  // the loads of all the deps' nodes can overlap.
+  itr.prefetch();
   return itr;
 }
 
@@ -262,6 +330,15 @@ inline const C* InjectorStorage::getPtr(Graph::node_iterator itr) {
   return reinterpret_cast<const C*>(p);
 }
 
+template <typename C>
+inline const C* InjectorStorage::getPtr(Graph::node_iterator itr, const void* p) {
+  if (p == nullptr) {
+    return getPtr<C>(itr);
+  }
+  FruitStaticAssert(fruit::impl::meta::IsSame(fruit::impl::meta::Type<C>, fruit::impl::meta::NormalizeType(fruit::impl::meta::Type<C>)));
+  return reinterpret_cast<const C*>(p);
+}
+
 template <typename AnnotatedC>
 inline const InjectorStorage::RemoveAnnotations<AnnotatedC>* InjectorStorage::unsafeGet() {
   using C = RemoveAnnotations<AnnotatedC>;
@@ -284,22 +361,64 @@ inline const void* InjectorStorage::unsafeGetPtr(TypeId type) {
 template <typename AnnotatedC>
 inline const std::vector<InjectorStorage::RemoveAnnotations<AnnotatedC>*>& InjectorStorage::getMultibindings() {
   using C = RemoveAnnotations<AnnotatedC>;
-  void* p = getMultibindings(getTypeId<AnnotatedC>());
-  if (p == nullptr) {
+  NormalizedMultibindingSet* multibinding_set = getNormalizedMultibindingSet(getTypeId<AnnotatedC>());
+  if (multibinding_set == nullptr) {
+    if (parent != nullptr) {
+      // Not registered in this child injector, use the multibindings of the parent (if any).
+      return parent->getMultibindings<AnnotatedC>();
+    }
+    // Not registered.
     static std::vector<C*> empty_vector;
     return empty_vector;
-  } else {
-    return *reinterpret_cast<std::vector<C*>*>(p);
   }
+  std::shared_ptr<char> vector = std::atomic_load(&multibinding_set->vector);
+  if (vector.get() == nullptr) {
+    C** array = reinterpret_cast<C**>(multibinding_set->get_multibindings_vector(*this));
+    std::shared_ptr<std::vector<C*>> vector_ptr =
+        std::make_shared<std::vector<C*>>(array, array + multibinding_set->elems.size());
+    std::shared_ptr<char> new_vector(vector_ptr, reinterpret_cast<char*>(vector_ptr.get()));
+    // After eagerlyInjectMultibindings() this can be called concurrently from multiple threads. If another thread
+    // stored its vector first, that one is used instead (and `vector' is set to it).
+    if (std::atomic_compare_exchange_strong(&multibinding_set->vector, &vector, new_vector)) {
+      vector = new_vector;
+    }
+  }
+  return *reinterpret_cast<std::vector<C*>*>(vector.get());
+}
+
+template <typename AnnotatedC>
+inline Span<InjectorStorage::RemoveAnnotations<AnnotatedC>* const> InjectorStorage::getMultibindingsSpan() {
+  using C = RemoveAnnotations<AnnotatedC>;
+  NormalizedMultibindingSet* multibinding_set = getNormalizedMultibindingSet(getTypeId<AnnotatedC>());
+  if (multibinding_set == nullptr) {
+    if (parent != nullptr) {
+      // Not registered in this child injector, use the multibindings of the parent (if any).
+      return parent->getMultibindingsSpan<AnnotatedC>();
+    }
+    // Not registered.
+    return Span<C* const>();
+  }
+  C** array = reinterpret_cast<C**>(multibinding_set->get_multibindings_vector(*this));
+  return Span<C* const>(array, multibinding_set->elems.size());
 }
 
 inline const void* InjectorStorage::getPtrInternal(Graph::node_iterator node_itr) {
   NormalizedBinding& normalized_binding = node_itr.getNode();
-  if (!node_itr.isTerminal()) {
-    normalized_binding.object = normalized_binding.create(*this, node_itr);
-    FruitAssert(node_itr.isTerminal());
+  if (node_itr.isTerminal()) {
+    // For objects stored inline, the object is in the same cache line as the node, so this doesn't need a further load.
+    return node_itr.isInlineTerminal() ? normalized_binding.inline_object : normalized_binding.object;
   }
-  return normalized_binding.object;
+  if (construction_plans != nullptr) {
+    executeConstructionPlan(node_itr);
+  }
+  const void* p = normalized_binding.create(*this, node_itr);
+  if (node_itr.isTerminal() && !node_itr.isInlineTerminal()) {
+    normalized_binding.object = p;
+  }
+  // Otherwise this is either an object stored inline (already copied into the node by `create') or a thread-local
+  // binding (or a bind<> to one). In the latter case `p' is the object of the current thread, and we must call `create'
+  // again on the next get(), so we can't replace `create' with the object.
+  return p;
 }
 
 inline NormalizedMultibindingSet* InjectorStorage::getNormalizedMultibindingSet(TypeId type) {
@@ -311,7 +430,7 @@ inline NormalizedMultibindingSet* InjectorStorage::getNormalizedMultibindingSet(
 }
 
 template <typename AnnotatedC>
-inline std::shared_ptr<char> InjectorStorage::createMultibindingVector(InjectorStorage& storage) {
+inline void* InjectorStorage::createMultibindingArray(InjectorStorage& storage) {
   using C = RemoveAnnotations<AnnotatedC>;
   TypeId type = getTypeId<AnnotatedC>();
   NormalizedMultibindingSet* multibinding_set = storage.getNormalizedMultibindingSet(type);
@@ -320,26 +439,27 @@ inline std::shared_ptr<char> InjectorStorage::createMultibindingVector(InjectorS
   // instead of calling this).
   FruitAssert(multibinding_set != nullptr);
   
-  if (multibinding_set->v.get() != nullptr) {
+  if (multibinding_set->v != nullptr) {
     // Result cached, return early.
     return multibinding_set->v;
   }
   
+  // This constructs all the instances in a single pass, so the ones allocated in the FixedSizeAllocator end up next to
+  // each other (and right before the array below), unless they need to construct some of their dependencies first.
   storage.ensureConstructedMultibinding(*multibinding_set);
   
-  std::vector<C*> s;
-  s.reserve(multibinding_set->elems.size());
+  // The space for this array was reserved in the FixedSizeAllocatorData during binding normalization.
+  C** array = storage.allocator.template allocatePointerArray<C>(multibinding_set->elems.size());
+  C** array_itr = array;
   for (const NormalizedMultibinding& multibinding : multibinding_set->elems) {
     FruitAssert(multibinding.is_constructed);
-    s.push_back(reinterpret_cast<C*>(multibinding.object));
+    *array_itr = reinterpret_cast<C*>(multibinding.object);
+    ++array_itr;
   }
   
-  std::shared_ptr<std::vector<C*>> vector_ptr = std::make_shared<std::vector<C*>>(std::move(s));
-  std::shared_ptr<char> result(vector_ptr, reinterpret_cast<char*>(vector_ptr.get()));
-  
-  multibinding_set->v = result;
+  multibinding_set->v = array;
   
-  return result;
+  return array;
 }
 
 template <typename I, typename C, typename AnnotatedC>
@@ -347,8 +467,13 @@ InjectorStorage::const_object_ptr_t InjectorStorage::createInjectedObjectForBind
     InjectorStorage& injector, InjectorStorage::Graph::node_iterator node_itr) {
 
   InjectorStorage::Graph::node_iterator bindings_begin = injector.bindings.begin();
-  const C* cPtr = injector.get<const C*>(injector.lazyGetPtr<AnnotatedC>(node_itr.neighborsBegin(), 0, bindings_begin));
-  node_itr.setTerminal();
+  InjectorStorage::Graph::node_iterator c_itr =
+      injector.lazyGetPtr<AnnotatedC>(node_itr.neighborsBegin(), 0, bindings_begin);
+  const C* cPtr = injector.get<const C*>(c_itr);
+  // If C is a thread-local binding, I must be one too (otherwise all threads would get the C of this thread).
+  if (c_itr.isTerminal()) {
+    node_itr.setTerminal();
+  }
   // This step is needed when the cast C->I changes the pointer
   // (e.g. for multiple inheritance).
   const I* iPtr = static_cast<const I*>(cPtr);
@@ -363,11 +488,14 @@ inline ComponentStorageEntry InjectorStorage::createComponentStorageEntryForBind
   FruitStaticAssert(fruit::impl::meta::Not(fruit::impl::meta::IsPointer(fruit::impl::meta::Type<I>)));
   FruitStaticAssert(fruit::impl::meta::Not(fruit::impl::meta::IsPointer(fruit::impl::meta::Type<C>)));
   ComponentStorageEntry result;
-  result.kind = ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_NO_ALLOCATION;
-  result.type_id = getTypeId<AnnotatedI>();
+  result.setKind(ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_NO_ALLOCATION);
+  result.setTypeId(getTypeId<AnnotatedI>());
   ComponentStorageEntry::BindingForObjectToConstruct& binding = result.binding_for_object_to_construct;
-  binding.create = createInjectedObjectForBind<I, C, AnnotatedC>;
-  binding.deps = getBindingDeps<fruit::impl::meta::Vector<fruit::impl::meta::Type<AnnotatedC>>>();
+  static const ComponentStorageEntry::BindingForObjectToConstruct::Data data = {
+      createInjectedObjectForBind<I, C, AnnotatedC>,
+      *getBindingDeps<fruit::impl::meta::Vector<fruit::impl::meta::Type<AnnotatedC>>>(),
+  };
+  binding.data = &data;
 #ifdef FRUIT_EXTRA_DEBUG
   binding.is_nonconst = true;
 #endif
@@ -382,11 +510,14 @@ inline ComponentStorageEntry InjectorStorage::createComponentStorageEntryForCons
   FruitStaticAssert(fruit::impl::meta::Not(fruit::impl::meta::IsPointer(fruit::impl::meta::Type<I>)));
   FruitStaticAssert(fruit::impl::meta::Not(fruit::impl::meta::IsPointer(fruit::impl::meta::Type<C>)));
   ComponentStorageEntry result;
-  result.kind = ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_NO_ALLOCATION;
-  result.type_id = getTypeId<AnnotatedI>();
+  result.setKind(ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_NO_ALLOCATION);
+  result.setTypeId(getTypeId<AnnotatedI>());
   ComponentStorageEntry::BindingForObjectToConstruct& binding = result.binding_for_object_to_construct;
-  binding.create = createInjectedObjectForBind<I, C, AnnotatedC>;
-  binding.deps = getBindingDeps<fruit::impl::meta::Vector<fruit::impl::meta::Type<AnnotatedC>>>();
+  static const ComponentStorageEntry::BindingForObjectToConstruct::Data data = {
+      createInjectedObjectForBind<I, C, AnnotatedC>,
+      *getBindingDeps<fruit::impl::meta::Vector<fruit::impl::meta::Type<AnnotatedC>>>(),
+  };
+  binding.data = &data;
 #ifdef FRUIT_EXTRA_DEBUG
   binding.is_nonconst = false;
 #endif
@@ -396,8 +527,8 @@ inline ComponentStorageEntry InjectorStorage::createComponentStorageEntryForCons
 template <typename AnnotatedC, typename C>
 inline ComponentStorageEntry InjectorStorage::createComponentStorageEntryForBindInstance(C& instance) {
   ComponentStorageEntry result;
-  result.kind = ComponentStorageEntry::Kind::BINDING_FOR_CONSTRUCTED_OBJECT;
-  result.type_id = getTypeId<AnnotatedC>();
+  result.setKind(ComponentStorageEntry::Kind::BINDING_FOR_CONSTRUCTED_OBJECT);
+  result.setTypeId(getTypeId<AnnotatedC>());
   ComponentStorageEntry::BindingForConstructedObject& binding = result.binding_for_constructed_object;
   binding.object_ptr = &instance;
 #ifdef FRUIT_EXTRA_DEBUG
@@ -409,8 +540,8 @@ inline ComponentStorageEntry InjectorStorage::createComponentStorageEntryForBind
 template <typename AnnotatedC, typename C>
 inline ComponentStorageEntry InjectorStorage::createComponentStorageEntryForBindConstInstance(const C& instance) {
   ComponentStorageEntry result;
-  result.kind = ComponentStorageEntry::Kind::BINDING_FOR_CONSTRUCTED_OBJECT;
-  result.type_id = getTypeId<AnnotatedC>();
+  result.setKind(ComponentStorageEntry::Kind::BINDING_FOR_CONSTRUCTED_OBJECT);
+  result.setTypeId(getTypeId<AnnotatedC>());
   ComponentStorageEntry::BindingForConstructedObject& binding = result.binding_for_constructed_object;
   binding.object_ptr = &instance;
 #ifdef FRUIT_EXTRA_DEBUG
@@ -471,7 +602,8 @@ struct InvokeLambdaWithInjectedArgVector<AnnotatedSignature, Lambda, true /* lam
 
   // This is not inlined in operator() so that all the lazyGetPtr() calls happen first (instead of being interleaved
   // with the get() calls). The lazyGetPtr() calls don't branch, while the get() calls branch on the result of the
-  // lazyGetPtr()s, so it's faster to execute them in this order.
+  // lazyGetPtr()s, so it's faster to execute them in this order. This also means that the nodes of all deps are
+  // prefetched (by lazyGetPtr()) before the first get().
   template <typename... NodeItrs>
   FRUIT_ALWAYS_INLINE
   CPtr outerConstructHelper(InjectorStorage& injector, NodeItrs... nodeItrs) {
@@ -534,7 +666,8 @@ struct InvokeLambdaWithInjectedArgVector<AnnotatedSignature, Lambda, false /* la
 
   // This is not inlined in operator() so that all the lazyGetPtr() calls happen first (instead of being interleaved
   // with the get() calls). The lazyGetPtr() calls don't branch, while the get() calls branch on the result of the
-  // lazyGetPtr()s, so it's faster to execute them in this order.
+  // lazyGetPtr()s, so it's faster to execute them in this order. This also means that the nodes of all deps are
+  // prefetched (by lazyGetPtr()) before the first get().
   template <typename... NodeItrs>
   FRUIT_ALWAYS_INLINE
   C* outerConstructHelper(InjectorStorage& injector, FixedSizeAllocator& allocator, NodeItrs... nodeItrs) {
@@ -564,9 +697,111 @@ struct InvokeLambdaWithInjectedArgVector<AnnotatedSignature, Lambda, false /* la
 };
 
 
+// Similar to InvokeLambdaWithInjectedArgVector, but for lambdas of the form C*(fruit::Emplacer<C>, Args...). Here
+// AnnotatedSignature is the signature without the Emplacer (see ProviderSignature).
+// The space for the C object is reserved in the injector's allocator after injecting the arguments (so that the objects
+// constructed to inject them don't end up in the middle), and then the lambda constructs the C there.
+template <typename AnnotatedSignature,
+          typename Lambda,
+          typename AnnotatedC         = InjectorStorage::SignatureType<AnnotatedSignature>,
+          typename AnnotatedArgVector = fruit::impl::meta::Eval<fruit::impl::meta::SignatureArgs(fruit::impl::meta::Type<AnnotatedSignature>)>,
+          typename Indexes = fruit::impl::meta::Eval<
+              fruit::impl::meta::GenerateIntSequence(fruit::impl::meta::VectorSize(
+                  fruit::impl::meta::SignatureArgs(fruit::impl::meta::Type<AnnotatedSignature>)))
+              >>
+struct InvokeEmplacingLambdaWithInjectedArgVector;
+
+template <typename AnnotatedSignature, typename Lambda, typename AnnotatedC, typename... AnnotatedArgs, typename... Indexes>
+struct InvokeEmplacingLambdaWithInjectedArgVector<AnnotatedSignature, Lambda, AnnotatedC, fruit::impl::meta::Vector<AnnotatedArgs...>, fruit::impl::meta::Vector<Indexes...>> {
+  using C = InjectorStorage::RemoveAnnotations<AnnotatedC>;
+  
+  // See the corresponding method in InvokeLambdaWithInjectedArgVector.
+  template <typename... GetFirstStageResults>
+  FRUIT_ALWAYS_INLINE
+  C* innerConstructHelper(InjectorStorage& injector, FixedSizeAllocator& allocator, GetFirstStageResults... getFirstStageResults) {
+    // `injector' *is* used below, but when there are no AnnotatedArgs some compilers report it as unused.
+    (void)injector;
+    C* storage = allocator.allocateObject<AnnotatedC>();
+    C* cPtr = LambdaInvoker::invoke<Lambda, Emplacer<C>, InjectorStorage::RemoveAnnotations<fruit::impl::meta::UnwrapType<AnnotatedArgs>>...>(
+        InjectorStorage::createEmplacer(storage),
+        GetSecondStage<InjectorStorage::RemoveAnnotations<fruit::impl::meta::UnwrapType<AnnotatedArgs>>>()(getFirstStageResults)
+        ...);
+    
+    // This can happen if the user-supplied provider doesn't return the result of the Emplacer.
+    if (cPtr != storage) {
+      InjectorStorage::fatal("attempting to get an instance for the type " + std::string(getTypeId<AnnotatedC>()) + " but the provider returned a pointer that wasn't constructed with its fruit::Emplacer");
+      FRUIT_UNREACHABLE; // LCOV_EXCL_LINE
+    }
+    
+    // As in FixedSizeAllocator::constructObject(), this is only done after the object is constructed, so that it's not
+    // destroyed if the provider throws.
+    allocator.registerConstructedObject(cPtr);
+    return cPtr;
+  }
+
+  // See the corresponding method in InvokeLambdaWithInjectedArgVector.
+  template <typename... NodeItrs>
+  FRUIT_ALWAYS_INLINE
+  C* outerConstructHelper(InjectorStorage& injector, FixedSizeAllocator& allocator, NodeItrs... nodeItrs) {
+    // `injector' *is* used below, but when there are no AnnotatedArgs some compilers report it as unused.
+    (void)injector;
+    return innerConstructHelper(injector, allocator,
+        GetFirstStage<InjectorStorage::RemoveAnnotations<fruit::impl::meta::UnwrapType<AnnotatedArgs>>>()(injector, nodeItrs)
+        ...);
+  }
+
+  C* operator()(InjectorStorage& injector, SemistaticGraph<TypeId, NormalizedBinding>& bindings,
+                FixedSizeAllocator& allocator, InjectorStorage::Graph::edge_iterator deps) {
+    InjectorStorage::Graph::node_iterator bindings_begin = bindings.begin();
+    // `bindings_begin' *is* used below, but when there are no AnnotatedArgs some compilers report it as unused.
+    (void) bindings_begin;
+    
+    // `deps' *is* used below, but when there are no AnnotatedArgs some compilers report it as unused.
+    (void)deps;
+    
+    return outerConstructHelper(injector, allocator,
+        injector.lazyGetPtr<InjectorStorage::NormalizeType<fruit::impl::meta::UnwrapType<AnnotatedArgs>>>(deps, Indexes::value, bindings_begin)
+        ...);
+  }
+};
+
+// Selects the struct used to invoke the provider `Lambda' (that returns a T).
+template <typename AnnotatedSignature, typename Lambda, typename T>
+using InvokeProviderWithInjectedArgVector = typename std::conditional<
+    fruit::impl::meta::Eval<fruit::impl::meta::IsEmplacingProviderSignature(
+        fruit::impl::meta::FunctionSignature(fruit::impl::meta::Type<Lambda>))>::value,
+    InvokeEmplacingLambdaWithInjectedArgVector<AnnotatedSignature, Lambda>,
+    InvokeLambdaWithInjectedArgVector<AnnotatedSignature, Lambda, std::is_pointer<T>::value>>::type;
+
+template <typename C>
+inline Emplacer<C> InjectorStorage::createEmplacer(C* storage) {
+  return Emplacer<C>(storage);
+}
+
+template <typename C, typename... Args>
+inline FactoryRef<C(Args...)> InjectorStorage::createFactoryRef(C(*invoke)(void*, Args...), void* state) {
+  return FactoryRef<C(Args...)>(invoke, state);
+}
+
+template <typename C, typename... Args>
+inline FactoryRef<C(Args...)> InjectorStorage::createFactoryRef(const std::function<C(Args...)>& function) {
+  const FactoryRef<C(Args...)>* factory_ref = function.template target<FactoryRef<C(Args...)>>();
+  if (factory_ref != nullptr) {
+    return *factory_ref;
+  }
+  // invokeFunction() only accesses `function' through a const pointer, so this const_cast is safe.
+  return FactoryRef<C(Args...)>(FactoryRef<C(Args...)>::invokeFunction,
+                                const_cast<void*>(static_cast<const void*>(&function)));
+}
+
+template <typename C>
+inline PooledPtr<C> InjectorStorage::createPooledPtr(C* p, ObjectPool* pool) {
+  return PooledPtr<C>(p, PoolDeleter<C>(pool));
+}
+
 template <typename C, typename T, typename AnnotatedSignature, typename Lambda>
 InjectorStorage::const_object_ptr_t InjectorStorage::createInjectedObjectForProvider(InjectorStorage& injector, Graph::node_iterator node_itr) {
-  C* cPtr = InvokeLambdaWithInjectedArgVector<AnnotatedSignature, Lambda, std::is_pointer<T>::value>()(
+  C* cPtr = InvokeProviderWithInjectedArgVector<AnnotatedSignature, Lambda, T>()(
       injector, injector.bindings, injector.allocator, node_itr.neighborsBegin());
   node_itr.setTerminal();
   return reinterpret_cast<const_object_ptr_t>(cPtr);
@@ -576,7 +811,7 @@ template <typename AnnotatedSignature, typename Lambda>
 inline ComponentStorageEntry InjectorStorage::createComponentStorageEntryForProvider() {
 #ifdef FRUIT_EXTRA_DEBUG
   using Signature = fruit::impl::meta::UnwrapType<fruit::impl::meta::Eval<fruit::impl::meta::RemoveAnnotationsFromSignature(fruit::impl::meta::Type<AnnotatedSignature>)>>;
-  FruitStaticAssert(fruit::impl::meta::IsSame(fruit::impl::meta::Type<Signature>, fruit::impl::meta::FunctionSignature(fruit::impl::meta::Type<Lambda>)));
+  FruitStaticAssert(fruit::impl::meta::IsSame(fruit::impl::meta::Type<Signature>, fruit::impl::meta::ProviderSignature(fruit::impl::meta::Type<Lambda>)));
 #endif
   using AnnotatedT = SignatureType<AnnotatedSignature>;
   using AnnotatedC = NormalizeType<AnnotatedT>;
@@ -585,14 +820,17 @@ inline ComponentStorageEntry InjectorStorage::createComponentStorageEntryForProv
   using C          = NormalizeType<T>;
   ComponentStorageEntry result;
   constexpr bool needs_allocation = !std::is_pointer<T>::value;
-  result.kind =
+  result.setKind(
       needs_allocation
           ? ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_ALLOCATION
-          : ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_NO_ALLOCATION;
-  result.type_id = getTypeId<AnnotatedC>();
+          : ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_NO_ALLOCATION);
+  result.setTypeId(getTypeId<AnnotatedC>());
   ComponentStorageEntry::BindingForObjectToConstruct& binding = result.binding_for_object_to_construct;
-  binding.create = createInjectedObjectForProvider<C, T, AnnotatedSignature, Lambda>;
-  binding.deps = getBindingDeps<NormalizedSignatureArgs<AnnotatedSignature>>();
+  static const ComponentStorageEntry::BindingForObjectToConstruct::Data data = {
+      createInjectedObjectForProvider<C, T, AnnotatedSignature, Lambda>,
+      *getBindingDeps<NormalizedSignatureArgs<AnnotatedSignature>, AnnotatedSignatureArgs<AnnotatedSignature>>(),
+  };
+  binding.data = &data;
 #ifdef FRUIT_EXTRA_DEBUG
   binding.is_nonconst = true;
 #endif
@@ -602,7 +840,7 @@ inline ComponentStorageEntry InjectorStorage::createComponentStorageEntryForProv
 template <typename I, typename C, typename T, typename AnnotatedSignature, typename Lambda>
 InjectorStorage::const_object_ptr_t InjectorStorage::createInjectedObjectForCompressedProvider(
     InjectorStorage& injector, Graph::node_iterator node_itr) {
-  C* cPtr = InvokeLambdaWithInjectedArgVector<AnnotatedSignature, Lambda, std::is_pointer<T>::value>()(
+  C* cPtr = InvokeProviderWithInjectedArgVector<AnnotatedSignature, Lambda, T>()(
       injector, injector.bindings, injector.allocator, node_itr.neighborsBegin());
   node_itr.setTerminal();
   I* iPtr = static_cast<I*>(cPtr);
@@ -613,7 +851,7 @@ template <typename AnnotatedSignature, typename Lambda, typename AnnotatedI>
 inline ComponentStorageEntry InjectorStorage::createComponentStorageEntryForCompressedProvider() {
 #ifdef FRUIT_EXTRA_DEBUG
   using Signature = fruit::impl::meta::UnwrapType<fruit::impl::meta::Eval<fruit::impl::meta::RemoveAnnotationsFromSignature(fruit::impl::meta::Type<AnnotatedSignature>)>>;
-  FruitStaticAssert(fruit::impl::meta::IsSame(fruit::impl::meta::Type<Signature>, fruit::impl::meta::FunctionSignature(fruit::impl::meta::Type<Lambda>)));
+  FruitStaticAssert(fruit::impl::meta::IsSame(fruit::impl::meta::Type<Signature>, fruit::impl::meta::ProviderSignature(fruit::impl::meta::Type<Lambda>)));
 #endif
   using AnnotatedT = SignatureType<AnnotatedSignature>;
   using AnnotatedC = NormalizeType<AnnotatedT>;
@@ -622,11 +860,18 @@ inline ComponentStorageEntry InjectorStorage::createComponentStorageEntryForComp
   using C          = NormalizeType<T>;
   using I          = RemoveAnnotations<AnnotatedI>;
   ComponentStorageEntry result;
-  result.kind = ComponentStorageEntry::Kind::COMPRESSED_BINDING;
-  result.type_id = getTypeId<AnnotatedI>();
+  result.setKind(ComponentStorageEntry::Kind::COMPRESSED_BINDING);
+  result.setTypeId(getTypeId<AnnotatedI>());
   ComponentStorageEntry::CompressedBinding& binding = result.compressed_binding;
-  binding.c_type_id = getTypeId<AnnotatedC>();
-  binding.create = createInjectedObjectForCompressedProvider<I, C, T, AnnotatedSignature, Lambda>;
+  // The deps are the ones of the binding for C (see createComponentStorageEntryForProvider()).
+  static const ComponentStorageEntry::CompressedBinding::Data data = {
+      getTypeId<AnnotatedC>(),
+      {
+          createInjectedObjectForCompressedProvider<I, C, T, AnnotatedSignature, Lambda>,
+          *getBindingDeps<NormalizedSignatureArgs<AnnotatedSignature>, AnnotatedSignatureArgs<AnnotatedSignature>>(),
+      },
+  };
+  binding.data = &data;
   return result;
 }
 
@@ -649,9 +894,14 @@ struct InvokeConstructorWithInjectedArgVector<AnnotatedC(AnnotatedArgs...), frui
   // operations (e.g. the increment/decrement/check of shared_ptr's reference count).
   template <typename... GetFirstStageResults>
   FRUIT_ALWAYS_INLINE
-  C* innerConstructHelper(InjectorStorage& injector, FixedSizeAllocator& allocator, GetFirstStageResults... getFirstStageResults) {
+  C* innerConstructHelper(InjectorStorage& injector, FixedSizeAllocator& allocator, void* inline_storage,
+                          GetFirstStageResults... getFirstStageResults) {
 	// `injector' *is* used below, but when there are no AnnotatedArgs some compilers report it as unused.
 	(void)injector;
+    if (IsStoredInline<C>::value && inline_storage != nullptr) {
+      return new (inline_storage) C(GetSecondStage<InjectorStorage::RemoveAnnotations<AnnotatedArgs>>()(getFirstStageResults)
+                                    ...);
+    }
     return allocator.constructObject<AnnotatedC, InjectorStorage::RemoveAnnotations<AnnotatedArgs>&&...>(
         GetSecondStage<InjectorStorage::RemoveAnnotations<AnnotatedArgs>>()(getFirstStageResults)
         ...);
@@ -659,20 +909,25 @@ struct InvokeConstructorWithInjectedArgVector<AnnotatedC(AnnotatedArgs...), frui
 
   // This is not inlined in operator() so that all the lazyGetPtr() calls happen first (instead of being interleaved
   // with the get() calls). The lazyGetPtr() calls don't branch, while the get() calls branch on the result of the
-  // lazyGetPtr()s, so it's faster to execute them in this order.
+  // lazyGetPtr()s, so it's faster to execute them in this order. This also means that the nodes of all deps are
+  // prefetched (by lazyGetPtr()) before the first get().
   template <typename... NodeItrs>
   FRUIT_ALWAYS_INLINE
-  C* outerConstructHelper(InjectorStorage& injector, FixedSizeAllocator& allocator, NodeItrs... nodeItrs) {
+  C* outerConstructHelper(InjectorStorage& injector, FixedSizeAllocator& allocator, void* inline_storage,
+                          NodeItrs... nodeItrs) {
 	// `injector' *is* used below, but when there are no AnnotatedArgs some compilers report it as unused.
 	(void)injector;
-    return innerConstructHelper(injector, allocator,
+    return innerConstructHelper(injector, allocator, inline_storage,
         GetFirstStage<InjectorStorage::RemoveAnnotations<AnnotatedArgs>>()(injector, nodeItrs)
         ...);
   }
 
+  // If inline_storage is not nullptr and C is stored inline (see IsStoredInline), the object is constructed there
+  // instead of in the allocator.
   FRUIT_ALWAYS_INLINE
   C* operator()(InjectorStorage& injector, SemistaticGraph<TypeId, NormalizedBinding>& bindings,
-                FixedSizeAllocator& allocator, InjectorStorage::Graph::edge_iterator deps) {
+                FixedSizeAllocator& allocator, InjectorStorage::Graph::edge_iterator deps,
+                void* inline_storage = nullptr) {
 
     // `deps' *is* used below, but when there are no Args some compilers report it as unused.
     (void)deps;
@@ -680,7 +935,7 @@ struct InvokeConstructorWithInjectedArgVector<AnnotatedC(AnnotatedArgs...), frui
     InjectorStorage::Graph::node_iterator bindings_begin = bindings.begin();
     // `bindings_begin' *is* used below, but when there are no Args some compilers report it as unused.
     (void) bindings_begin;
-    C* p = outerConstructHelper(injector, allocator,
+    C* p = outerConstructHelper(injector, allocator, inline_storage,
         injector.lazyGetPtr<InjectorStorage::NormalizeType<AnnotatedArgs>>(deps, Indexes::value, bindings_begin)
         ...);
     return p;
@@ -690,9 +945,30 @@ struct InvokeConstructorWithInjectedArgVector<AnnotatedC(AnnotatedArgs...), frui
 template <typename C, typename AnnotatedSignature>
 InjectorStorage::const_object_ptr_t InjectorStorage::createInjectedObjectForConstructor(
     InjectorStorage& injector, Graph::node_iterator node_itr) {
+  if (!IsStoredInline<C>::value) {
+    C* cPtr = InvokeConstructorWithInjectedArgVector<AnnotatedSignature>()(injector,
+                  injector.bindings, injector.allocator, node_itr.neighborsBegin());
+    node_itr.setTerminal();
+    return reinterpret_cast<InjectorStorage::object_ptr_t>(cPtr);
+  }
+
+  // The object is constructed in the node itself, overwriting `create' (that's this function, already running). If the
+  // construction fails (e.g. the constructor throws), `create' is restored so that the node is still valid.
+  struct RestoreCreateUnlessConstructed {
+    NormalizedBinding& binding;
+    ComponentStorageEntry::BindingForObjectToConstruct::create_t create;
+    bool constructed;
+
+    ~RestoreCreateUnlessConstructed() {
+      if (!constructed) {
+        binding.create = create;
+      }
+    }
+  } guard{node_itr.getNode(), node_itr.getNode().create, false};
   C* cPtr = InvokeConstructorWithInjectedArgVector<AnnotatedSignature>()(injector,
-                injector.bindings, injector.allocator, node_itr.neighborsBegin());
-  node_itr.setTerminal();
+                injector.bindings, injector.allocator, node_itr.neighborsBegin(), guard.binding.inline_object);
+  guard.constructed = true;
+  node_itr.setInlineTerminal();
   return reinterpret_cast<InjectorStorage::object_ptr_t>(cPtr);
 }
 
@@ -701,11 +977,14 @@ inline ComponentStorageEntry InjectorStorage::createComponentStorageEntryForCons
   using AnnotatedC = SignatureType<AnnotatedSignature>;
   using C          = RemoveAnnotations<AnnotatedC>;
   ComponentStorageEntry result;
-  result.kind = ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_ALLOCATION;
-  result.type_id = getTypeId<AnnotatedC>();
+  result.setKind(ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_ALLOCATION);
+  result.setTypeId(getTypeId<AnnotatedC>());
   ComponentStorageEntry::BindingForObjectToConstruct& binding = result.binding_for_object_to_construct;
-  binding.create = createInjectedObjectForConstructor<C, AnnotatedSignature>;
-  binding.deps = getBindingDeps<NormalizedSignatureArgs<AnnotatedSignature>>();
+  static const ComponentStorageEntry::BindingForObjectToConstruct::Data data = {
+      createInjectedObjectForConstructor<C, AnnotatedSignature>,
+      *getBindingDeps<NormalizedSignatureArgs<AnnotatedSignature>, AnnotatedSignatureArgs<AnnotatedSignature>>(),
+  };
+  binding.data = &data;
 #ifdef FRUIT_EXTRA_DEBUG
   binding.is_nonconst = true;
 #endif
@@ -728,21 +1007,136 @@ inline ComponentStorageEntry InjectorStorage::createComponentStorageEntryForComp
   using C          = RemoveAnnotations<AnnotatedC>;
   using I          = RemoveAnnotations<AnnotatedI>;
   ComponentStorageEntry result;
-  result.kind = ComponentStorageEntry::Kind::COMPRESSED_BINDING;
-  result.type_id = getTypeId<AnnotatedI>();
+  result.setKind(ComponentStorageEntry::Kind::COMPRESSED_BINDING);
+  result.setTypeId(getTypeId<AnnotatedI>());
   ComponentStorageEntry::CompressedBinding& binding = result.compressed_binding;
-  binding.c_type_id = getTypeId<AnnotatedC>();
-  binding.create = createInjectedObjectForCompressedConstructor<I, C, AnnotatedSignature>;
+  // The deps are the ones of the binding for C (see createComponentStorageEntryForConstructor()).
+  static const ComponentStorageEntry::CompressedBinding::Data data = {
+      getTypeId<AnnotatedC>(),
+      {
+          createInjectedObjectForCompressedConstructor<I, C, AnnotatedSignature>,
+          *getBindingDeps<NormalizedSignatureArgs<AnnotatedSignature>, AnnotatedSignatureArgs<AnnotatedSignature>>(),
+      },
+  };
+  binding.data = &data;
   return result;
 }
 
+// Constructs a new C (outside of the injector's allocator), injecting the arguments in AnnotatedSignature.
+template <typename AnnotatedSignature>
+struct NewObjectWithInjectedArgs;
+
+template <typename AnnotatedC, typename... AnnotatedArgs>
+struct NewObjectWithInjectedArgs<AnnotatedC(AnnotatedArgs...)> {
+  using C = InjectorStorage::RemoveAnnotations<AnnotatedC>;
+
+  C* operator()(InjectorStorage& injector) {
+    // `injector' *is* used below, but when there are no AnnotatedArgs some compilers report it as unused.
+    (void)injector;
+    return new C(injector.get<AnnotatedArgs>()...);
+  }
+};
+
+template <typename C, typename AnnotatedSignature>
+InjectorStorage::const_object_ptr_t InjectorStorage::createInjectedObjectForThreadLocal(
+    InjectorStorage& injector, Graph::node_iterator node_itr) {
+  (void)node_itr;
+  static const std::size_t binding_index = ThreadLocalObjects::newBindingIndex();
+  void* p = injector.thread_local_objects.get(binding_index);
+  if (p == nullptr) {
+    C* cPtr = NewObjectWithInjectedArgs<AnnotatedSignature>()(injector);
+#ifdef FRUIT_EXTRA_DEBUG
+    std::cout << "InjectorStorage: constructed a thread-local " << getTypeId<C>() << " for the current thread."
+              << std::endl;
+#endif
+    injector.thread_local_objects.set(binding_index, cPtr, ThreadLocalObjects::destroyObject<C>);
+    p = cPtr;
+  }
+  // Note that we don't call node_itr.setTerminal() here, see getPtrInternal().
+  return reinterpret_cast<const_object_ptr_t>(p);
+}
+
+template <typename AnnotatedSignature>
+inline ComponentStorageEntry InjectorStorage::createComponentStorageEntryForThreadLocal() {
+  using AnnotatedC = SignatureType<AnnotatedSignature>;
+  using C          = RemoveAnnotations<AnnotatedC>;
+  ComponentStorageEntry result;
+  // The objects are allocated separately for each thread, so no space is reserved in the injector's allocator.
+  result.setKind(ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_NO_ALLOCATION);
+  result.setTypeId(getTypeId<AnnotatedC>());
+  ComponentStorageEntry::BindingForObjectToConstruct& binding = result.binding_for_object_to_construct;
+  // This node is never terminal, so the deps are marked as lazy to leave them out of its construction plan (see
+  // ConstructionPlans). Otherwise the plan would be executed on every get().
+  static const ComponentStorageEntry::BindingForObjectToConstruct::Data data = {
+      createInjectedObjectForThreadLocal<C, AnnotatedSignature>,
+      *getBindingDeps<NormalizedSignatureArgs<AnnotatedSignature>, AnnotatedSignatureArgs<AnnotatedSignature>, true>(),
+  };
+  binding.data = &data;
+#ifdef FRUIT_EXTRA_DEBUG
+  binding.is_nonconst = true;
+#endif
+  return result;
+}
+
+template <typename AnnotatedT>
+InjectorStorage::const_object_ptr_t InjectorStorage::createObjectFromParent(
+    InjectorStorage& injector, Graph::node_iterator node_itr) {
+  FruitAssert(injector.parent != nullptr);
+  InjectorStorage& parent = *injector.parent;
+  Graph::node_iterator parent_itr = parent.bindings.at(getTypeId<AnnotatedT>());
+  const void* p = parent.getPtrInternal(parent_itr);
+#ifdef FRUIT_EXTRA_DEBUG
+  std::cout << "InjectorStorage: using the object for " << getTypeId<AnnotatedT>() << " from the parent injector."
+            << std::endl;
+#endif
+  if (parent_itr.isTerminal()) {
+    // The object is owned by the parent, so next time the child can use it directly.
+    node_itr.setTerminal();
+  }
+  // Otherwise this is a thread-local binding (or a bind<> to one) in the parent, and `p' is the object of the current
+  // thread. So the child must ask the parent again on the next get(), like the parent itself does.
+  return reinterpret_cast<const_object_ptr_t>(p);
+}
+
+template <typename AnnotatedT>
+inline ComponentStorageEntry InjectorStorage::createComponentStorageEntryForParentObject() {
+  ComponentStorageEntry result;
+  // The object is owned by the parent, so no space is reserved in the child's allocator.
+  result.setKind(ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_NO_ALLOCATION);
+  result.setTypeId(getTypeId<AnnotatedT>());
+  ComponentStorageEntry::BindingForObjectToConstruct& binding = result.binding_for_object_to_construct;
+  // The deps (if any) are in the parent's graph, not in the child's.
+  static const ComponentStorageEntry::BindingForObjectToConstruct::Data data = {
+      createObjectFromParent<AnnotatedT>,
+      *getBindingDeps<fruit::impl::meta::Vector<>>(),
+  };
+  binding.data = &data;
+#ifdef FRUIT_EXTRA_DEBUG
+  // The constness is checked at compile time in Injector::createChild().
+  binding.is_nonconst = true;
+#endif
+  return result;
+}
+
+template <typename L>
+struct GetComponentStorageEntriesForParentObjectsHelper;
+
+template <typename... Ts>
+struct GetComponentStorageEntriesForParentObjectsHelper<fruit::impl::meta::Vector<fruit::impl::meta::Type<Ts>...>> {
+  std::vector<ComponentStorageEntry, ArenaAllocator<ComponentStorageEntry>> operator()(MemoryPool& memory_pool) {
+    return std::vector<ComponentStorageEntry, ArenaAllocator<ComponentStorageEntry>>(
+        std::initializer_list<ComponentStorageEntry>{InjectorStorage::createComponentStorageEntryForParentObject<Ts>()...},
+        memory_pool);
+  }
+};
+
 template <typename AnnotatedT>
 inline ComponentStorageEntry InjectorStorage::createComponentStorageEntryForMultibindingVectorCreator() {
   ComponentStorageEntry result;
-  result.kind = ComponentStorageEntry::Kind::MULTIBINDING_VECTOR_CREATOR;
-  result.type_id = getTypeId<AnnotatedT>();
+  result.setKind(ComponentStorageEntry::Kind::MULTIBINDING_VECTOR_CREATOR);
+  result.setTypeId(getTypeId<AnnotatedT>());
   ComponentStorageEntry::MultibindingVectorCreator& binding = result.multibinding_vector_creator;
-  binding.get_multibindings_vector = createMultibindingVector<AnnotatedT>;
+  binding.get_multibindings_vector = createMultibindingArray<AnnotatedT>;
   return result;
 }
 
@@ -761,19 +1155,22 @@ inline ComponentStorageEntry InjectorStorage::createComponentStorageEntryForMult
   using I             = RemoveAnnotations<AnnotatedI>;
   using C             = RemoveAnnotations<AnnotatedC>;
   ComponentStorageEntry result;
-  result.kind = ComponentStorageEntry::Kind::MULTIBINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_NO_ALLOCATION;
-  result.type_id = getTypeId<AnnotatedI>();
+  result.setKind(ComponentStorageEntry::Kind::MULTIBINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_NO_ALLOCATION);
+  result.setTypeId(getTypeId<AnnotatedI>());
   ComponentStorageEntry::MultibindingForObjectToConstruct& binding = result.multibinding_for_object_to_construct;
-  binding.create = createInjectedObjectForMultibinding<I, C, AnnotatedCPtr>;
-  binding.deps = getBindingDeps<fruit::impl::meta::Vector<fruit::impl::meta::Type<AnnotatedC>>>();
+  static const ComponentStorageEntry::MultibindingForObjectToConstruct::Data data = {
+      createInjectedObjectForMultibinding<I, C, AnnotatedCPtr>,
+      *getBindingDeps<fruit::impl::meta::Vector<fruit::impl::meta::Type<AnnotatedC>>>(),
+  };
+  binding.data = &data;
   return result;
 }
 
 template <typename AnnotatedC, typename C>
 inline ComponentStorageEntry InjectorStorage::createComponentStorageEntryForInstanceMultibinding(C& instance) {
   ComponentStorageEntry result;
-  result.kind = ComponentStorageEntry::Kind::MULTIBINDING_FOR_CONSTRUCTED_OBJECT;
-  result.type_id = getTypeId<AnnotatedC>();
+  result.setKind(ComponentStorageEntry::Kind::MULTIBINDING_FOR_CONSTRUCTED_OBJECT);
+  result.setTypeId(getTypeId<AnnotatedC>());
   ComponentStorageEntry::MultibindingForConstructedObject& binding = result.multibinding_for_constructed_object;
   binding.object_ptr = &instance;
   return result;
@@ -800,13 +1197,16 @@ inline ComponentStorageEntry InjectorStorage::createComponentStorageEntryForMult
   ComponentStorageEntry result;
   bool needs_allocation = !std::is_pointer<T>::value;
   if (needs_allocation)
-    result.kind = ComponentStorageEntry::Kind::MULTIBINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_ALLOCATION;
+    result.setKind(ComponentStorageEntry::Kind::MULTIBINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_ALLOCATION);
   else
-    result.kind = ComponentStorageEntry::Kind::MULTIBINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_NO_ALLOCATION;
-  result.type_id = getTypeId<AnnotatedC>();
+    result.setKind(ComponentStorageEntry::Kind::MULTIBINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_NO_ALLOCATION);
+  result.setTypeId(getTypeId<AnnotatedC>());
   ComponentStorageEntry::MultibindingForObjectToConstruct& binding = result.multibinding_for_object_to_construct;
-  binding.create = createInjectedObjectForMultibindingProvider<C, T, AnnotatedSignature, Lambda>;
-  binding.deps = getBindingDeps<NormalizedSignatureArgs<AnnotatedSignature>>();
+  static const ComponentStorageEntry::MultibindingForObjectToConstruct::Data data = {
+      createInjectedObjectForMultibindingProvider<C, T, AnnotatedSignature, Lambda>,
+      *getBindingDeps<NormalizedSignatureArgs<AnnotatedSignature>, AnnotatedSignatureArgs<AnnotatedSignature>>(),
+  };
+  binding.data = &data;
   return result;
 }
 
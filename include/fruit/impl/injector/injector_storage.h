@@ -19,9 +19,14 @@
 
 #include <fruit/fruit_forward_decls.h>
 #include <fruit/impl/data_structures/fixed_size_allocator.h>
+#include <fruit/impl/injector/thread_local_objects.h>
 #include <fruit/impl/meta/component.h>
 #include <fruit/impl/normalized_component_storage/normalized_bindings.h>
+#include <fruit/pooled_ptr.h>
+#include <fruit/span.h>
 
+#include <functional>
+#include <tuple>
 #include <vector>
 #include <unordered_map>
 
@@ -65,10 +70,33 @@ public:
   using NormalizedSignatureArgs = fruit::impl::meta::Eval<
       fruit::impl::meta::NormalizeTypeVector(fruit::impl::meta::SignatureArgs(fruit::impl::meta::Type<Signature>))
       >;
+
+  template <typename Signature>
+  using AnnotatedSignatureArgs = fruit::impl::meta::Eval<
+      fruit::impl::meta::SignatureArgs(fruit::impl::meta::Type<Signature>)
+      >;
   
   // Prints the specified error and calls exit(1).
   static void fatal(const std::string& error);
 
+  // Returns an Emplacer that constructs a C in `storage'. Only Fruit can create Emplacer objects.
+  template <typename C>
+  static Emplacer<C> createEmplacer(C* storage);
+
+  // Returns a FactoryRef that calls `invoke' with `state'. Only Fruit can create FactoryRef objects.
+  template <typename C, typename... Args>
+  static FactoryRef<C(Args...)> createFactoryRef(C(*invoke)(void*, Args...), void* state);
+
+  // Returns a FactoryRef for the factory `function'. This dispatches directly to the factory's state if `function'
+  // wraps a FactoryRef (as the factories registered with registerFactory() do), and calls `function' otherwise.
+  template <typename C, typename... Args>
+  static FactoryRef<C(Args...)> createFactoryRef(const std::function<C(Args...)>& function);
+
+  // Returns a PooledPtr that owns `p', that was constructed in a slot allocated from `pool'. Only Fruit can create
+  // PoolDeleter objects.
+  template <typename C>
+  static PooledPtr<C> createPooledPtr(C* p, ObjectPool* pool);
+
   template <typename AnnotatedI, typename AnnotatedC>
   static ComponentStorageEntry createComponentStorageEntryForBind();
 
@@ -93,6 +121,13 @@ public:
   template <typename AnnotatedSignature, typename AnnotatedI>
   static ComponentStorageEntry createComponentStorageEntryForCompressedConstructor();
 
+  template <typename AnnotatedSignature>
+  static ComponentStorageEntry createComponentStorageEntryForThreadLocal();
+
+  // A binding for AnnotatedT in a child injector, that uses the object of the parent injector (see createChild()).
+  template <typename AnnotatedT>
+  static ComponentStorageEntry createComponentStorageEntryForParentObject();
+
   template <typename AnnotatedT>
   static ComponentStorageEntry createComponentStorageEntryForMultibindingVectorCreator();
 
@@ -117,12 +152,38 @@ private:
   SemistaticGraph<TypeId, NormalizedBinding> bindings;
   
   // Maps the type index of a type T to the corresponding NormalizedMultibindingSet object (that stores all multibindings).
-  std::unordered_map<TypeId, NormalizedMultibindingSet> multibindings;
+  NormalizedMultibindingSetMap multibindings;
+
+  // The storage of the parent injector, if this is the storage of a child injector. Otherwise nullptr.
+  // The types that the child gets from the parent have a node in `bindings' that looks up the object in the parent the
+  // first time it's needed (see createComponentStorageEntryForParentObject()).
+  InjectorStorage* parent = nullptr;
+
+  // The objects of thread-local bindings (see PartialComponent::registerThreadLocal()). Their nodes in `bindings' are
+  // never marked as terminal, so that each get() looks up the object of the current thread here.
+  // This is declared last so that these objects are destroyed before the objects in `allocator', that they might
+  // depend on.
+  ThreadLocalObjects thread_local_objects;
+
+  // Whether this storage is leaked (instead of destroyed) in destroy(). See Injector::setProcessLifetime().
+  bool is_process_lifetime = false;
+
+  // The construction plans of the NormalizedComponentStorage that `bindings' was copied from. These are used in
+  // getPtrInternal() to construct chains of deps in a loop instead of recursively.
+  // nullptr in the storage for the shared singletons of a NormalizedComponent, since the plans aren't computed yet.
+  const ConstructionPlans* construction_plans = nullptr;
   
 private:
+
+  // Returns a ComponentStorage with all the entries of `component', plus the ones in `entries_from_parent'.
+  static ComponentStorage addBindingsFromParent(
+      ComponentStorage&& component,
+      const std::vector<ComponentStorageEntry, ArenaAllocator<ComponentStorageEntry>>& entries_from_parent);
   
+  // Returns the array of T* instances for the multibindings of AnnotatedC, constructing it (and the instances) if needed.
+  // The array is allocated in `allocator' and has exactly one element for each multibinding.
   template <typename AnnotatedC>
-  static std::shared_ptr<char> createMultibindingVector(InjectorStorage& storage);
+  static void* createMultibindingArray(InjectorStorage& storage);
   
   // If not bound, returns nullptr.
   NormalizedMultibindingSet* getNormalizedMultibindingSet(TypeId type);
@@ -134,9 +195,25 @@ private:
   // getPtr() is equivalent to getPtrInternal(lazyGetPtr())
   template <typename C>
   const C* getPtr(Graph::node_iterator itr);
+
+  // Same as getPtr(itr), but if p is not nullptr it's the result of a previous getPtrInternal(itr) call, and it's
+  // returned without calling getPtrInternal() again (see constructAll()).
+  template <typename C>
+  const C* getPtr(Graph::node_iterator itr, const void* p);
   
   // Similar to the previous, but takes a node_iterator. Use this when the node_iterator is known, it's faster.
   const void* getPtrInternal(Graph::node_iterator itr);
+
+  // Constructs the nodes in the construction plan of the given node (if any), see ConstructionPlans.
+  // This is out of line since it's only called when constructing objects.
+  void executeConstructionPlan(Graph::node_iterator itr);
+
+  // Constructs the objects of the n given nodes (and their deps) if they aren't constructed yet, and stores the pointer
+  // to the object of itrs[i] in ptrs[i]. The nodes with is_lazy[i]==true are skipped (e.g. types requested as a
+  // Provider), and ptrs[i] is set to nullptr for those.
+  // The pointers must be used instead of getting the objects from the nodes again: thread-local nodes (see
+  // registerThreadLocal()) are never terminal, so that would call their `create' again.
+  void constructAll(const Graph::node_iterator* itrs, const bool* is_lazy, std::size_t n, const void** ptrs);
   
   // getPtr(typeInfo) is equivalent to getPtr(lazyGetPtr(typeInfo)).
   Graph::node_iterator lazyGetPtr(TypeId type);
@@ -149,9 +226,6 @@ private:
   
   void* getPtrForMultibinding(TypeId type);
   
-  // Returns a std::vector<T*>*, or nullptr if there are no multibindings.
-  void* getMultibindings(TypeId type);
-  
   // Constructs any necessary instances, but NOT the instance set.
   void ensureConstructedMultibinding(NormalizedMultibindingSet& multibinding_set);
   
@@ -161,6 +235,8 @@ private:
   template <typename T>
   friend class fruit::Provider;
 
+  friend class NormalizedComponentStorage;
+
   using object_ptr_t = void*;
   using const_object_ptr_t = const void*;
 
@@ -184,6 +260,13 @@ private:
   static const_object_ptr_t createInjectedObjectForCompressedConstructor(
       InjectorStorage& injector, Graph::node_iterator node_itr);
 
+  template <typename C, typename AnnotatedSignature>
+  static const_object_ptr_t createInjectedObjectForThreadLocal(
+      InjectorStorage& injector, Graph::node_iterator node_itr);
+
+  template <typename AnnotatedT>
+  static const_object_ptr_t createObjectFromParent(InjectorStorage& injector, Graph::node_iterator node_itr);
+
   template <typename I, typename C, typename AnnotatedCPtr>
   static object_ptr_t createInjectedObjectForMultibinding(InjectorStorage& m);
 
@@ -215,20 +298,54 @@ public:
 
   /**
    * The MemoryPool is only used during construction, the constructed object *can* outlive the memory pool.
+   * If lazy_object_storage is true, the storage for the injected objects is allocated as they're constructed (see
+   * FixedSizeAllocator).
    */
   InjectorStorage(
       ComponentStorage&& storage,
       const std::vector<TypeId, ArenaAllocator<TypeId>>& exposed_types,
-      MemoryPool& memory_pool);
+      MemoryPool& memory_pool,
+      bool lazy_object_storage = false);
 
   /**
    * The MemoryPool is only used during construction, the constructed object *can* outlive the memory pool.
+   * If lazy_object_storage is true, the storage for the injected objects is allocated as they're constructed (see
+   * FixedSizeAllocator).
    */
   InjectorStorage(
       const NormalizedComponentStorage& normalized_storage,
       ComponentStorage&& storage,
+      MemoryPool& memory_pool,
+      bool lazy_object_storage = false);
+
+  /**
+   * Constructs the storage of a child injector of the injector that owns `parent'.
+   * `entries_from_parent' has a binding created with createComponentStorageEntryForParentObject() for each type that
+   * the child uses from `parent' instead of binding it in `storage'. `parent' must outlive the constructed object.
+   * The MemoryPool is only used during construction, the constructed object *can* outlive the memory pool.
+   */
+  InjectorStorage(
+      InjectorStorage& parent,
+      ComponentStorage&& storage,
+      const std::vector<TypeId, ArenaAllocator<TypeId>>& exposed_types,
+      const std::vector<ComponentStorageEntry, ArenaAllocator<ComponentStorageEntry>>& entries_from_parent,
       MemoryPool& memory_pool);
   
+  // Used as a tag to select the constructor below.
+  struct ForSharedSingletons {};
+
+  /**
+   * Constructs the storage for the shared singletons of `normalized_storage' (see
+   * NormalizedComponentStorage::constructSharedSingletons()). No objects are constructed here.
+   * Unlike with the other constructors, the bindings of `normalized_storage' can have unsatisfied requirements; the
+   * caller must only construct objects that don't depend on those.
+   * The MemoryPool is only used during construction, the constructed object *can* outlive the memory pool.
+   */
+  InjectorStorage(
+      const NormalizedComponentStorage& normalized_storage,
+      MemoryPool& memory_pool,
+      ForSharedSingletons);
+
   // This is just the default destructor, but we declare it here to avoid including
   // normalized_component_storage.h in fruit.h.
   ~InjectorStorage();
@@ -248,6 +365,15 @@ public:
   // Note that T should *not* be annotated.
   template <typename T>
   T get(InjectorStorage::Graph::node_iterator node_iterator);
+
+  // Same as get<T>(node_iterator), but if p is not nullptr it's the pointer to the object, returned by constructAll().
+  template <typename T>
+  T get(InjectorStorage::Graph::node_iterator node_iterator, const void* p);
+
+  // Equivalent to std::make_tuple(get<AnnotatedT>()...), but faster. The nodes are looked up together, and the objects
+  // that aren't constructed yet are constructed before any of them is returned (see constructAll()).
+  template <typename... AnnotatedT>
+  std::tuple<RemoveAnnotations<AnnotatedT>...> getAll();
    
   // Looks up the location where the type is (or will be) stored, but does not construct the class.
   // get<AnnotatedT>() is equivalent to get<AnnotatedT>(lazyGetPtr<Apply<NormalizeType, AnnotatedT>>(deps, dep_index))
@@ -263,7 +389,19 @@ public:
   template <typename AnnotatedC>
   const std::vector<RemoveAnnotations<AnnotatedC>*>& getMultibindings();
   
+  template <typename AnnotatedC>
+  Span<RemoveAnnotations<AnnotatedC>* const> getMultibindingsSpan();
+  
   void eagerlyInjectMultibindings();
+
+  // Returns the resource used for the memory of this injector, or nullptr if it uses the global operator new.
+  MemoryResource* getMemoryResource() const;
+
+  void setProcessLifetime();
+
+  // Destroys `storage', unless it was marked with setProcessLifetime(). In that case, this only destroys the objects of
+  // the types marked with fruit::RunDestructorAtExit and leaks everything else.
+  static void destroy(std::unique_ptr<InjectorStorage> storage);
 };
 
 } // namespace impl
@@ -0,0 +1,40 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef FRUIT_THREAD_LOCAL_OBJECTS_DEFN_H
+#define FRUIT_THREAD_LOCAL_OBJECTS_DEFN_H
+
+// Redundant, but makes KDevelop happy.
+#include <fruit/impl/injector/thread_local_objects.h>
+
+namespace fruit {
+namespace impl {
+
+inline ThreadLocalObjects::ThreadLocalObjects()
+  : registry(nullptr) {
+}
+
+template <typename C>
+void ThreadLocalObjects::destroyObject(void* p) {
+  C* cPtr = reinterpret_cast<C*>(p);
+  delete cPtr; // LCOV_EXCL_BR_LINE
+}
+
+} // namespace impl
+} // namespace fruit
+
+#endif // FRUIT_THREAD_LOCAL_OBJECTS_DEFN_H
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef FRUIT_THREAD_LOCAL_OBJECTS_H
+#define FRUIT_THREAD_LOCAL_OBJECTS_H
+
+#include <atomic>
+#include <cstddef>
+
+namespace fruit {
+namespace impl {
+
+/**
+ * Stores the objects of the thread-local bindings of an injector (see PartialComponent::registerThreadLocal()): one
+ * object for each (thread, binding) pair.
+ *
+ * Each thread has its own slots, indexed by a dense process-wide binding index (see newBindingIndex()), so getting
+ * and setting the objects of the current thread requires no locking once the thread has used this object.
+ * The objects of a thread are destroyed (in reverse construction order) when the thread exits or when this object is
+ * destroyed, whichever happens first.
+ */
+class ThreadLocalObjects {
+public:
+  using destroy_t = void(*)(void*);
+
+  // Shared between a ThreadLocalObjects and the threads that stored objects in it, so that whichever is destroyed last
+  // can clean up. Defined in thread_local_objects.cpp.
+  struct Registry;
+
+private:
+  // Created on the first call to set(), so that injectors without thread-local bindings don't pay for it.
+  std::atomic<Registry*> registry;
+
+  Registry* getOrCreateRegistry();
+
+public:
+  ThreadLocalObjects();
+
+  // Destroys the objects of all threads that haven't exited yet.
+  // No other thread must be using this object at this point.
+  ~ThreadLocalObjects();
+
+  ThreadLocalObjects(const ThreadLocalObjects&) = delete;
+  ThreadLocalObjects& operator=(const ThreadLocalObjects&) = delete;
+
+  ThreadLocalObjects(ThreadLocalObjects&&) = delete;
+  ThreadLocalObjects& operator=(ThreadLocalObjects&&) = delete;
+
+  // Returns a new index, never returned before in this process. This is thread-safe.
+  // Each thread-local binding calls this once, the first time it's used.
+  static std::size_t newBindingIndex();
+
+  // Returns the object of the current thread for the binding with the specified index, or nullptr if the current thread
+  // hasn't stored one yet.
+  void* get(std::size_t binding_index);
+
+  // Stores `object' as the object of the current thread for the binding with the specified index. There must be no
+  // object stored for that binding already.
+  // `destroy(object)' will be called when the current thread exits or when this object is destroyed.
+  void set(std::size_t binding_index, void* object, destroy_t destroy);
+
+  // Calls delete on an object of type C. Can be used as the `destroy' argument of set().
+  template <typename C>
+  static void destroyObject(void* p);
+};
+
+} // namespace impl
+} // namespace fruit
+
+#include <fruit/impl/injector/thread_local_objects.defn.h>
+
+#endif // FRUIT_THREAD_LOCAL_OBJECTS_H
@@ -0,0 +1,36 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_INJECTOR_RECLAIMER_DEFN_H
+#define FRUIT_INJECTOR_RECLAIMER_DEFN_H
+
+#include <fruit/injector.h>
+
+#include <utility>
+
+// Redundant, but makes KDevelop happy.
+#include <fruit/injector_reclaimer.h>
+
+namespace fruit {
+
+template <typename... P>
+inline void InjectorReclaimer::reclaim(Injector<P...>&& injector) {
+  reclaimStorage(std::move(injector.storage));
+}
+
+} // namespace fruit
+
+#endif // FRUIT_INJECTOR_RECLAIMER_DEFN_H
@@ -31,6 +31,7 @@
 #include <fruit/impl/meta/signatures.h>
 #include <fruit/impl/injection_debug_errors.h>
 
+#include <functional>
 #include <memory>
 #include <type_traits>
 
@@ -80,6 +81,9 @@ struct GetClassForType {
   template <typename T>
   struct apply<Type<Provider<const T>>> {using type = Type<T>;};
 
+  template <typename C, typename... Args>
+  struct apply<Type<FactoryRef<C(Args...)>>> {using type = Type<std::function<C(Args...)>>;};
+
   template <typename Annotation, typename T>
   struct apply<Type<fruit::Annotated<Annotation, T>>> {using type = Type<T>;};
 };
@@ -128,6 +132,9 @@ struct NormalizeType {
   template <typename T>
   struct apply<Type<Provider<const T>>> {using type = Type<T>;};
 
+  template <typename C, typename... Args>
+  struct apply<Type<FactoryRef<C(Args...)>>> {using type = Type<std::function<C(Args...)>>;};
+
   template <typename Annotation, typename T>
   struct apply<Type<fruit::Annotated<Annotation, T>>> {using type = Type<fruit::Annotated<Annotation, UnwrapType<Eval<NormalizeType(Type<T>)>>>>;};
 };
@@ -182,6 +189,9 @@ struct TypeInjectionRequiresNonConstBinding {
   template <typename T>
   struct apply<Type<Provider<const T>>> {using type = Bool<false>;};
 
+  template <typename C, typename... Args>
+  struct apply<Type<FactoryRef<C(Args...)>>> {using type = Bool<false>;};
+
   template <typename Annotation, typename T>
   struct apply<Type<fruit::Annotated<Annotation, T>>> {
     using type = TypeInjectionRequiresNonConstBinding(Type<T>);
@@ -365,6 +375,41 @@ struct InjectedSignatureForAssistedFactory {
   };
 };
 
+// Checks whether Signature is the signature of a provider that constructs its object with a fruit::Emplacer, i.e.
+// whether it's of the form C*(fruit::Emplacer<C>, Args...).
+struct IsEmplacingProviderSignature {
+  template <typename Signature>
+  struct apply {
+    using type = Bool<false>;
+  };
+
+  template <typename C, typename... Args>
+  struct apply<Type<C*(fruit::Emplacer<C>, Args...)>> {
+    using type = Bool<true>;
+  };
+};
+
+struct ProviderSignatureFromLambdaSignature {
+  template <typename Signature>
+  struct apply {
+    using type = Signature;
+  };
+
+  template <typename C, typename... Args>
+  struct apply<Type<C*(fruit::Emplacer<C>, Args...)>> {
+    using type = Type<C(Args...)>;
+  };
+};
+
+// Returns the signature of the provider `Lambda', as it's used for injection: the signature of the lambda, except that
+// for a lambda with signature C*(fruit::Emplacer<C>, Args...) this is C(Args...).
+struct ProviderSignature {
+  template <typename Lambda>
+  struct apply {
+    using type = ProviderSignatureFromLambdaSignature(FunctionSignature(Lambda));
+  };
+};
+
 struct IsAssisted {
   template <typename T>
   struct apply {
@@ -905,6 +950,20 @@ struct AddProvidedType {
   };
 };
 
+// Returns a Vector<AnnotatedI1, ..., AnnotatedIn> where AnnotatedI1 is bound to AnnotatedC, AnnotatedI2 is bound to
+// AnnotatedI1 and so on (following the interface bindings in InterfaceBindings). Returns Vector<> if no interface is
+// bound to AnnotatedC.
+struct GetInterfaceBindingChain {
+  template <typename InterfaceBindings, typename AnnotatedC>
+  struct apply {
+    using AnnotatedI = FindValueInMap(InterfaceBindings, AnnotatedC);
+    using type = If(IsNone(AnnotatedI),
+                    Vector<>,
+                 PushFront(GetInterfaceBindingChain(InterfaceBindings, AnnotatedI),
+                           AnnotatedI));
+  };
+};
+
 struct AddDeferredBinding {
   template <typename Comp, typename DeferredBinding>
   struct apply {
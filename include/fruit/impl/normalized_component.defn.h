@@ -22,6 +22,24 @@
 
 namespace fruit {
 
+namespace impl {
+namespace meta {
+
+// Checks that all the types in SharedTypesVector are provided by the component Comp.
+struct CheckSharedSingletonsProvided {
+  template <typename SharedTypesVector, typename Comp>
+  struct apply {
+    using TypesNotProvided = SetDifference(VectorToSetUnchecked(NormalizeTypeVector(SharedTypesVector)),
+                                           GetComponentPs(Comp));
+    using type = If(Not(IsEmptySet(TypesNotProvided)),
+                    ConstructErrorWithArgVector(SharedSingletonsNotProvidedErrorTag, SetToVector(TypesNotProvided)),
+                 None);
+  };
+};
+
+} // namespace meta
+} // namespace impl
+
 template <typename... Params>
 template <typename... FormalArgs, typename... Args>
 inline NormalizedComponent<Params...>::NormalizedComponent(Component<Params...>(*getComponent)(FormalArgs...), Args&&... args)
@@ -33,10 +51,72 @@ inline NormalizedComponent<Params...>::NormalizedComponent(Component<Params...>(
       fruit::impl::MemoryPool()) {
 }
 
+template <typename... Params>
+template <typename... FormalArgs, typename... Args>
+inline NormalizedComponent<Params...>::NormalizedComponent(
+    MemoryResource& memory_resource, Component<Params...>(*getComponent)(FormalArgs...), Args&&... args)
+  : NormalizedComponent(
+      std::move(
+          fruit::Component<Params...>(
+              fruit::createComponent().install(getComponent, std::forward<Args>(args)...))
+                  .storage),
+      fruit::impl::MemoryPool(&memory_resource)) {
+}
+
 template <typename... Params>
 inline NormalizedComponent<Params...>::NormalizedComponent(
     fruit::impl::ComponentStorage&& storage,
     fruit::impl::MemoryPool memory_pool)
+  : NormalizedComponent(SharedSingletons<>(), std::move(storage), std::move(memory_pool)) {
+}
+
+template <typename... Params>
+template <typename... SharedTypes, typename... FormalArgs, typename... Args>
+inline NormalizedComponent<Params...>::NormalizedComponent(
+    SharedSingletons<SharedTypes...> shared_singletons,
+    Component<Params...>(*getComponent)(FormalArgs...),
+    Args&&... args)
+  : NormalizedComponent(
+      shared_singletons,
+      std::move(
+          fruit::Component<Params...>(
+              fruit::createComponent().install(getComponent, std::forward<Args>(args)...))
+                  .storage),
+      fruit::impl::MemoryPool()) {
+  using E = fruit::impl::meta::Eval<
+      fruit::impl::meta::CheckSharedSingletonsProvided(
+          fruit::impl::meta::Vector<fruit::impl::meta::Type<SharedTypes>...>,
+          fruit::impl::meta::ConstructComponentImpl(fruit::impl::meta::Type<Params>...))>;
+  (void)typename fruit::impl::meta::CheckIfError<E>::type();
+}
+
+template <typename... Params>
+template <typename... SharedTypes, typename... FormalArgs, typename... Args>
+inline NormalizedComponent<Params...>::NormalizedComponent(
+    MemoryResource& memory_resource,
+    SharedSingletons<SharedTypes...> shared_singletons,
+    Component<Params...>(*getComponent)(FormalArgs...),
+    Args&&... args)
+  : NormalizedComponent(
+      shared_singletons,
+      std::move(
+          fruit::Component<Params...>(
+              fruit::createComponent().install(getComponent, std::forward<Args>(args)...))
+                  .storage),
+      fruit::impl::MemoryPool(&memory_resource)) {
+  using E = fruit::impl::meta::Eval<
+      fruit::impl::meta::CheckSharedSingletonsProvided(
+          fruit::impl::meta::Vector<fruit::impl::meta::Type<SharedTypes>...>,
+          fruit::impl::meta::ConstructComponentImpl(fruit::impl::meta::Type<Params>...))>;
+  (void)typename fruit::impl::meta::CheckIfError<E>::type();
+}
+
+template <typename... Params>
+template <typename... SharedTypes>
+inline NormalizedComponent<Params...>::NormalizedComponent(
+    SharedSingletons<SharedTypes...>,
+    fruit::impl::ComponentStorage&& storage,
+    fruit::impl::MemoryPool memory_pool)
   : storage(
     std::move(storage),
     fruit::impl::getTypeIdsForList<
@@ -44,6 +124,9 @@ inline NormalizedComponent<Params...>::NormalizedComponent(
           typename fruit::impl::meta::Eval<
               fruit::impl::meta::ConstructComponentImpl(fruit::impl::meta::Type<Params>...)
           >::Ps)>>(memory_pool),
+    fruit::impl::getTypeIdsForList<
+      fruit::impl::meta::Eval<fruit::impl::meta::NormalizeTypeVector(
+          fruit::impl::meta::Vector<fruit::impl::meta::Type<SharedTypes>...>)>>(memory_pool),
     memory_pool,
     fruit::impl::NormalizedComponentStorageHolder::WithUndoableCompression()) {
 }
@@ -56,11 +56,12 @@ public:
       MemoryPool& memory_pool,
       const std::vector<TypeId, ArenaAllocator<TypeId>>& exposed_types,
       std::vector<ComponentStorageEntry, ArenaAllocator<ComponentStorageEntry>>& bindings_vector,
-      std::unordered_map<TypeId, NormalizedMultibindingSet>& multibindings);
+      NormalizedMultibindingSetMap& multibindings);
 
   /**
    * Normalizes the toplevel entries and performs binding compression, but keeps track of which compressions were
    * performed so that we can later undo some of them if needed.
+   * No binding compression is performed for the types that might be constructed together with one of shared_types.
    * This is more expensive than normalizeBindingsWithPermanentBindingCompression(), use that when it suffices.
    */
   static void normalizeBindingsWithUndoableBindingCompression(
@@ -68,8 +69,9 @@ public:
       FixedSizeAllocator::FixedSizeAllocatorData& fixed_size_allocator_data,
       MemoryPool& memory_pool,
       const std::vector<TypeId, ArenaAllocator<TypeId>>& exposed_types,
+      const std::vector<TypeId, ArenaAllocator<TypeId>>& shared_types,
       std::vector<ComponentStorageEntry, ArenaAllocator<ComponentStorageEntry>>& bindings_vector,
-      std::unordered_map<TypeId, NormalizedMultibindingSet>& multibindings,
+      NormalizedMultibindingSetMap& multibindings,
       BindingCompressionInfoMap& bindingCompressionInfoMap);
 
   /**
@@ -98,11 +100,11 @@ public:
       FixedSizeVector<ComponentStorageEntry>&& toplevel_entries,
       MemoryPool& memory_pool,
       const FixedSizeAllocator::FixedSizeAllocatorData& base_fixed_size_allocator_data,
-      const std::unordered_map<TypeId, NormalizedMultibindingSet>& base_multibindings,
+      const NormalizedMultibindingSetMap& base_multibindings,
       const NormalizedComponentStorage::BindingCompressionInfoMap& base_binding_compression_info_map,
       FixedSizeAllocator::FixedSizeAllocatorData& fixed_size_allocator_data,
       std::vector<ComponentStorageEntry, ArenaAllocator<ComponentStorageEntry>>& new_bindings_vector,
-      std::unordered_map<TypeId, NormalizedMultibindingSet>& multibindings,
+      NormalizedMultibindingSetMap& multibindings,
       FindNormalizedBinding find_normalized_binding,
       IsValidItr is_valid_itr,
       IsNormalizedBindingItrForConstructedObject is_normalized_binding_itr_for_constructed_object,
@@ -119,7 +121,7 @@ private:
    * Each element of multibindings_vector is a pair, where the first element is the multibinding and the second is the
    * corresponding MULTIBINDING_VECTOR_CREATOR entry.
    */
-  static void addMultibindings(std::unordered_map<TypeId, NormalizedMultibindingSet>& multibindings,
+  static void addMultibindings(NormalizedMultibindingSetMap& multibindings,
                                FixedSizeAllocator::FixedSizeAllocatorData& fixed_size_allocator_data,
                                const multibindings_vector_t& multibindings_vector);
 
@@ -129,6 +131,8 @@ private:
 
   /**
    * Normalizes the toplevel entries (but doesn't perform binding compression).
+   * This doesn't reserve space in the FixedSizeAllocator for the resulting bindings, use
+   * addBindingsToFixedSizeAllocatorData() for that once the set of bindings is final.
    * - HandleCompressedBinding should have an operator()(ComponentStorageEntry&) that will be called for each
    *   COMPRESSED_BINDING entry.
    * - HandleMultibinding should have an
@@ -159,7 +163,6 @@ private:
       typename GetCreate>
   static void normalizeBindings(
       FixedSizeVector<ComponentStorageEntry>&& toplevel_entries,
-      FixedSizeAllocator::FixedSizeAllocatorData& fixed_size_allocator_data,
       MemoryPool& memory_pool,
       HashMapWithArenaAllocator<TypeId, ComponentStorageEntry>& binding_data_map,
       HandleCompressedBinding handle_compressed_binding,
@@ -172,11 +175,43 @@ private:
 
   struct BindingCompressionInfo {
     TypeId i_type_id;
-    ComponentStorageEntry::BindingForObjectToConstruct::create_t create_i_with_compression;
+    const ComponentStorageEntry::BindingForObjectToConstruct::Data* i_binding_with_compression;
+  };
+
+  // Used for compressed bindings (I, C) where I is not bound directly to C, but to another interface in a chain of
+  // interface bindings (I -> I2 -> ... -> C).
+  struct ChainedBindingCompressionInfo {
+    TypeId c_type_id;
+    const ComponentStorageEntry::BindingForObjectToConstruct::Data* i_binding_with_compression;
+  };
+
+  /**
+   * The bindings in a binding_data_map, laid out as a struct of arrays: the i-th binding has kind kinds[i], type ID
+   * type_ids[i] and deps deps[i] (nullptr for a BINDING_FOR_CONSTRUCTED_OBJECT).
+   * The passes that classify the normalized bindings (e.g. to reserve space for them in the allocator, or to find the
+   * binding compressions that must be undone) only need these fields, so they scan these dense arrays instead of
+   * walking the nodes of binding_data_map and following the data pointer of each entry.
+   */
+  struct BindingArrays {
+    std::vector<ComponentStorageEntry::Kind, ArenaAllocator<ComponentStorageEntry::Kind>> kinds;
+    std::vector<TypeId, ArenaAllocator<TypeId>> type_ids;
+    std::vector<const BindingDeps*, ArenaAllocator<const BindingDeps*>> deps;
+
+    BindingArrays(
+        const HashMapWithArenaAllocator<TypeId, ComponentStorageEntry>& binding_data_map, MemoryPool& memory_pool);
+
+    std::size_t size() const;
   };
 
   /**
    * Normalizes the toplevel entries and performs binding compression.
+   * If bindings_are_final is true no other bindings will be added later, so this also:
+   * - drops the bindings that can't be reached from exposed_types or from a multibinding (see
+   *   removeUnreachableBindings())
+   * - compresses whole chains of interface bindings (I -> I2 -> ... -> C), not just the last edge
+   * - releases the allocator space reserved for the interface bindings removed by binding compression.
+   * The binding compressions performed in this case can't be undone.
+   * shared_types must be empty in that case, see performBindingCompression().
    * - SaveCompressedBindingUndoInfo should have an operator()(TypeId, CompressedBindingUndoInfo) that will be called
    *   with (c_type_id, undo_info) for each binding compression that was applied (and that therefore might need to be
    *   undone later).
@@ -187,14 +222,42 @@ private:
       FixedSizeAllocator::FixedSizeAllocatorData& fixed_size_allocator_data,
       MemoryPool& memory_pool,
       const std::vector<TypeId, ArenaAllocator<TypeId>>& exposed_types,
+      const std::vector<TypeId, ArenaAllocator<TypeId>>& shared_types,
+      bool bindings_are_final,
       std::vector<ComponentStorageEntry, ArenaAllocator<ComponentStorageEntry>>& bindings_vector,
-      std::unordered_map<TypeId, NormalizedMultibindingSet>& multibindings,
+      NormalizedMultibindingSetMap& multibindings,
       SaveCompressedBindingUndoInfo save_compressed_binding_undo_info);
 
   /**
-   * bindingCompressionInfoMap is an output parameter. This function will store information on all performed binding
-   * compressions in that map, to allow them to be undone later, if necessary.
-   * compressed_bindings_map is a map CtypeId -> (ItypeId, bindingData)
+   * Removes from binding_data_map the bindings that are not reachable from exposed_types or from the dependencies of a
+   * multibinding. These bindings can never be used by an injector with those exposed types, so there's no point in
+   * adding them to the graph or reserving space for them in the allocator.
+   */
+  static void removeUnreachableBindings(
+      HashMapWithArenaAllocator<TypeId, ComponentStorageEntry>& binding_data_map,
+      MemoryPool& memory_pool,
+      const multibindings_vector_t& multibindings_vector,
+      const std::vector<TypeId, ArenaAllocator<TypeId>>& exposed_types);
+
+  /**
+   * Reserves space in fixed_size_allocator_data for the (normalized, but not yet compressed) bindings in
+   * binding_arrays.
+   */
+  static void addBindingsToFixedSizeAllocatorData(
+      const BindingArrays& binding_arrays,
+      FixedSizeAllocator::FixedSizeAllocatorData& fixed_size_allocator_data);
+
+  /**
+   * binding_arrays must contain the same bindings as binding_data_map.
+   * compressed_bindings_map is a map CtypeId -> (ItypeId, bindingData) for the compressed bindings where I is bound
+   * directly to C.
+   * chained_compressed_bindings_map is a map ItypeId -> (CtypeId, bindingData) for the other compressed bindings. This
+   * must be empty unless bindings_are_final is true.
+   * If bindings_are_final is true, the space reserved in fixed_size_allocator_data for the interface bindings that
+   * are removed by the compression is released.
+   * Bindings are never compressed into a type that might be constructed together with one of shared_types: the
+   * objects of those types are shared with all injectors, and if the compression was then undone in an injector that
+   * injects C directly, that injector would construct a second C instead of using the shared one.
    * - SaveCompressedBindingUndoInfo should have an operator()(TypeId, CompressedBindingUndoInfo) that will be called
    *   with (c_type_id, undo_info) for each binding compression that was applied (and that therefore might need to be
    *   undone later).
@@ -202,10 +265,15 @@ private:
   template <typename SaveCompressedBindingUndoInfo>
   static std::vector<ComponentStorageEntry, ArenaAllocator<ComponentStorageEntry>> performBindingCompression(
       HashMapWithArenaAllocator<TypeId, ComponentStorageEntry>&& binding_data_map,
+      const BindingArrays& binding_arrays,
       HashMapWithArenaAllocator<TypeId, BindingCompressionInfo>&& compressed_bindings_map,
+      HashMapWithArenaAllocator<TypeId, ChainedBindingCompressionInfo>&& chained_compressed_bindings_map,
       MemoryPool& memory_pool,
       const multibindings_vector_t& multibindings_vector,
       const std::vector<TypeId, ArenaAllocator<TypeId>>& exposed_types,
+      const std::vector<TypeId, ArenaAllocator<TypeId>>& shared_types,
+      bool bindings_are_final,
+      FixedSizeAllocator::FixedSizeAllocatorData& fixed_size_allocator_data,
       SaveCompressedBindingUndoInfo save_compressed_binding_undo_info);
 
   using LazyComponentWithNoArgs = ComponentStorageEntry::LazyComponentWithNoArgs;
@@ -258,7 +326,6 @@ private:
       typename GetObjectPtr,
       typename GetCreate>
   struct BindingNormalizationContext {
-    FixedSizeAllocator::FixedSizeAllocatorData& fixed_size_allocator_data;
     MemoryPool& memory_pool;
     HashMapWithArenaAllocator<TypeId, ComponentStorageEntry>& binding_data_map;
     HandleCompressedBinding handle_compressed_binding;
@@ -293,7 +360,6 @@ private:
 
     BindingNormalizationContext(
         FixedSizeVector<ComponentStorageEntry>& toplevel_entries,
-        FixedSizeAllocator::FixedSizeAllocatorData& fixed_size_allocator_data,
         MemoryPool& memory_pool,
         HashMapWithArenaAllocator<TypeId, ComponentStorageEntry>& binding_data_map,
         HandleCompressedBinding handle_compressed_binding,
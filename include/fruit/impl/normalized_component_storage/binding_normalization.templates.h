@@ -48,7 +48,6 @@ BindingNormalization::BindingNormalizationContext<
       GetObjectPtr,
       GetCreate>::BindingNormalizationContext(
     FixedSizeVector<ComponentStorageEntry>& toplevel_entries,
-    FixedSizeAllocator::FixedSizeAllocatorData& fixed_size_allocator_data,
     MemoryPool& memory_pool,
     HashMapWithArenaAllocator<TypeId, ComponentStorageEntry>& binding_data_map,
     HandleCompressedBinding handle_compressed_binding,
@@ -58,8 +57,7 @@ BindingNormalization::BindingNormalizationContext<
     IsNormalizedBindingItrForConstructedObject is_normalized_binding_itr_for_constructed_object,
     GetObjectPtr get_object_ptr,
     GetCreate get_create)
-  : fixed_size_allocator_data(fixed_size_allocator_data),
-    memory_pool(memory_pool),
+  : memory_pool(memory_pool),
     binding_data_map(binding_data_map),
     handle_compressed_binding(handle_compressed_binding),
     handle_multibinding(handle_multibinding),
@@ -120,7 +118,6 @@ template <
     typename GetCreate>
 void BindingNormalization::normalizeBindings(
     FixedSizeVector<ComponentStorageEntry>&& toplevel_entries,
-    FixedSizeAllocator::FixedSizeAllocatorData& fixed_size_allocator_data,
     MemoryPool& memory_pool,
     HashMapWithArenaAllocator<TypeId, ComponentStorageEntry>& binding_data_map,
     HandleCompressedBinding handle_compressed_binding,
@@ -133,6 +130,10 @@ void BindingNormalization::normalizeBindings(
 
   FruitAssert(binding_data_map.empty());
 
+  // Each toplevel entry contributes at most 1 binding. Lazy components can add more, but usually most bindings come
+  // from the toplevel entries so this avoids most rehashing.
+  binding_data_map.reserve(toplevel_entries.size());
+
   BindingNormalizationContext<
       HandleCompressedBinding,
       HandleMultibinding,
@@ -142,7 +143,6 @@ void BindingNormalization::normalizeBindings(
       GetObjectPtr,
       GetCreate> context(
           toplevel_entries,
-          fixed_size_allocator_data,
           memory_pool,
           binding_data_map,
           handle_compressed_binding,
@@ -157,7 +157,7 @@ void BindingNormalization::normalizeBindings(
   // to one of the *_END_MARKER kinds. This allows to keep track of the "call stack" for the expansion.
 
   while (!context.entries_to_process.empty()) {
-    switch (context.entries_to_process.back().kind) { // LCOV_EXCL_BR_LINE
+    switch (context.entries_to_process.back().getKind()) { // LCOV_EXCL_BR_LINE
     case ComponentStorageEntry::Kind::BINDING_FOR_CONSTRUCTED_OBJECT:
       handleBindingForConstructedObject(context);
       break;
@@ -210,7 +210,7 @@ void BindingNormalization::normalizeBindings(
 
     default:
 #ifdef FRUIT_EXTRA_DEBUG
-      std::cerr << "Unexpected kind: " << (std::size_t)context.entries_to_process.back().kind << std::endl;
+      std::cerr << "Unexpected kind: " << (std::size_t)context.entries_to_process.back().getKind() << std::endl;
 #endif
       FRUIT_UNREACHABLE; // LCOV_EXCL_LINE
     }
@@ -221,27 +221,27 @@ template <typename... Params>
 FRUIT_ALWAYS_INLINE inline void BindingNormalization::handleBindingForConstructedObject(
     BindingNormalizationContext<Params...>& context) {
   ComponentStorageEntry entry = context.entries_to_process.back();
-  FruitAssert(entry.kind == ComponentStorageEntry::Kind::BINDING_FOR_CONSTRUCTED_OBJECT);
+  FruitAssert(entry.getKind() == ComponentStorageEntry::Kind::BINDING_FOR_CONSTRUCTED_OBJECT);
 
   context.entries_to_process.pop_back();
 
-  auto itr = context.find_normalized_binding(entry.type_id);
+  auto itr = context.find_normalized_binding(entry.getTypeId());
   if (context.is_valid_itr(itr)) {
     if (!context.is_normalized_binding_itr_for_constructed_object(itr)
         || context.get_object_ptr(itr) != entry.binding_for_constructed_object.object_ptr) {
-      printMultipleBindingsError(entry.type_id);
+      printMultipleBindingsError(entry.getTypeId());
       FRUIT_UNREACHABLE; // LCOV_EXCL_LINE
     }
     // Otherwise ok, duplicate but consistent binding.
     return;
   }
 
-  ComponentStorageEntry& entry_in_map = context.binding_data_map[entry.type_id];
-  if (entry_in_map.type_id.type_info != nullptr) {
-    if (entry_in_map.kind != ComponentStorageEntry::Kind::BINDING_FOR_CONSTRUCTED_OBJECT
+  ComponentStorageEntry& entry_in_map = context.binding_data_map[entry.getTypeId()];
+  if (entry_in_map.getTypeId().type_info != nullptr) {
+    if (entry_in_map.getKind() != ComponentStorageEntry::Kind::BINDING_FOR_CONSTRUCTED_OBJECT
         || entry.binding_for_constructed_object.object_ptr
             != entry_in_map.binding_for_constructed_object.object_ptr) {
-      printMultipleBindingsError(entry.type_id);
+      printMultipleBindingsError(entry.getTypeId());
       FRUIT_UNREACHABLE; // LCOV_EXCL_LINE
     }
     // Otherwise ok, duplicate but consistent binding.
@@ -262,27 +262,26 @@ template <typename... Params>
 FRUIT_ALWAYS_INLINE inline void BindingNormalization::handleBindingForObjectToConstructThatNeedsAllocation(
     BindingNormalizationContext<Params...>& context) {
   ComponentStorageEntry entry = context.entries_to_process.back();
-  FruitAssert(entry.kind == ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_ALLOCATION);
+  FruitAssert(entry.getKind() == ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_ALLOCATION);
   context.entries_to_process.pop_back();
 
-  auto itr = context.find_normalized_binding(entry.type_id);
+  auto itr = context.find_normalized_binding(entry.getTypeId());
   if (context.is_valid_itr(itr)) {
     if (context.is_normalized_binding_itr_for_constructed_object(itr)
-        || context.get_create(itr) != entry.binding_for_object_to_construct.create) {
-      printMultipleBindingsError(entry.type_id);
+        || context.get_create(itr) != entry.binding_for_object_to_construct.data->create) {
+      printMultipleBindingsError(entry.getTypeId());
       FRUIT_UNREACHABLE; // LCOV_EXCL_LINE
     }
     // Otherwise ok, duplicate but consistent binding.
     return;
   }
 
-  ComponentStorageEntry& entry_in_map = context.binding_data_map[entry.type_id];
-  context.fixed_size_allocator_data.addType(entry.type_id);
-  if (entry_in_map.type_id.type_info != nullptr) {
-    if (entry_in_map.kind != ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_ALLOCATION
-        || entry.binding_for_object_to_construct.create
-            != entry_in_map.binding_for_object_to_construct.create) {
-      printMultipleBindingsError(entry.type_id);
+  ComponentStorageEntry& entry_in_map = context.binding_data_map[entry.getTypeId()];
+  if (entry_in_map.getTypeId().type_info != nullptr) {
+    if (entry_in_map.getKind() != ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_ALLOCATION
+        || entry.binding_for_object_to_construct.data->create
+            != entry_in_map.binding_for_object_to_construct.data->create) {
+      printMultipleBindingsError(entry.getTypeId());
       FRUIT_UNREACHABLE; // LCOV_EXCL_LINE
     }
     // Otherwise ok, duplicate but consistent binding.
@@ -297,27 +296,26 @@ template <typename... Params>
 FRUIT_ALWAYS_INLINE inline void BindingNormalization::handleBindingForObjectToConstructThatNeedsNoAllocation(
     BindingNormalizationContext<Params...>& context) {
   ComponentStorageEntry entry = context.entries_to_process.back();
-  FruitAssert(entry.kind == ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_NO_ALLOCATION);
+  FruitAssert(entry.getKind() == ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_NO_ALLOCATION);
   context.entries_to_process.pop_back();
 
-  auto itr = context.find_normalized_binding(entry.type_id);
+  auto itr = context.find_normalized_binding(entry.getTypeId());
   if (context.is_valid_itr(itr)) {
     if (context.is_normalized_binding_itr_for_constructed_object(itr)
-        || context.get_create(itr) != entry.binding_for_object_to_construct.create) {
-      printMultipleBindingsError(entry.type_id);
+        || context.get_create(itr) != entry.binding_for_object_to_construct.data->create) {
+      printMultipleBindingsError(entry.getTypeId());
       FRUIT_UNREACHABLE; // LCOV_EXCL_LINE
     }
     // Otherwise ok, duplicate but consistent binding.
     return;
   }
 
-  ComponentStorageEntry& entry_in_map = context.binding_data_map[entry.type_id];
-  context.fixed_size_allocator_data.addExternallyAllocatedType(entry.type_id);
-  if (entry_in_map.type_id.type_info != nullptr) {
-    if (entry_in_map.kind != ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_NO_ALLOCATION
-        || entry.binding_for_object_to_construct.create
-            != entry_in_map.binding_for_object_to_construct.create) {
-      printMultipleBindingsError(entry.type_id);
+  ComponentStorageEntry& entry_in_map = context.binding_data_map[entry.getTypeId()];
+  if (entry_in_map.getTypeId().type_info != nullptr) {
+    if (entry_in_map.getKind() != ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_NO_ALLOCATION
+        || entry.binding_for_object_to_construct.data->create
+            != entry_in_map.binding_for_object_to_construct.data->create) {
+      printMultipleBindingsError(entry.getTypeId());
       FRUIT_UNREACHABLE; // LCOV_EXCL_LINE
     }
     // Otherwise ok, duplicate but consistent binding.
@@ -332,7 +330,7 @@ template <typename... Params>
 FRUIT_ALWAYS_INLINE inline void BindingNormalization::handleCompressedBinding(
     BindingNormalizationContext<Params...>& context) {
   ComponentStorageEntry entry = context.entries_to_process.back();
-  FruitAssert(entry.kind == ComponentStorageEntry::Kind::COMPRESSED_BINDING);
+  FruitAssert(entry.getKind() == ComponentStorageEntry::Kind::COMPRESSED_BINDING);
   context.entries_to_process.pop_back();
   context.handle_compressed_binding(entry);
 }
@@ -341,14 +339,14 @@ template <typename... Params>
 void BindingNormalization::handleMultibinding(
     BindingNormalizationContext<Params...>& context) {
   ComponentStorageEntry entry = context.entries_to_process.back();
-  FruitAssert(entry.kind == ComponentStorageEntry::Kind::MULTIBINDING_FOR_CONSTRUCTED_OBJECT
-      || entry.kind == ComponentStorageEntry::Kind::MULTIBINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_ALLOCATION
-      || entry.kind == ComponentStorageEntry::Kind::MULTIBINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_NO_ALLOCATION);
+  FruitAssert(entry.getKind() == ComponentStorageEntry::Kind::MULTIBINDING_FOR_CONSTRUCTED_OBJECT
+      || entry.getKind() == ComponentStorageEntry::Kind::MULTIBINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_ALLOCATION
+      || entry.getKind() == ComponentStorageEntry::Kind::MULTIBINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_NO_ALLOCATION);
   context.entries_to_process.pop_back();
   FruitAssert(!context.entries_to_process.empty());
   ComponentStorageEntry vector_creator_entry = std::move(context.entries_to_process.back());
   context.entries_to_process.pop_back();
-  FruitAssert(vector_creator_entry.kind == ComponentStorageEntry::Kind::MULTIBINDING_VECTOR_CREATOR);
+  FruitAssert(vector_creator_entry.getKind() == ComponentStorageEntry::Kind::MULTIBINDING_VECTOR_CREATOR);
   context.handle_multibinding(entry, vector_creator_entry);
 }
 
@@ -356,16 +354,16 @@ template <typename... Params>
 void BindingNormalization::handleMultibindingVectorCreator(
     BindingNormalizationContext<Params...>& context) {
   ComponentStorageEntry entry = context.entries_to_process.back();
-  FruitAssert(entry.kind == ComponentStorageEntry::Kind::MULTIBINDING_VECTOR_CREATOR);
+  FruitAssert(entry.getKind() == ComponentStorageEntry::Kind::MULTIBINDING_VECTOR_CREATOR);
   context.entries_to_process.pop_back();
   FruitAssert(!context.entries_to_process.empty());
   ComponentStorageEntry multibinding_entry = std::move(context.entries_to_process.back());
   context.entries_to_process.pop_back();
   FruitAssert(
-      multibinding_entry.kind == ComponentStorageEntry::Kind::MULTIBINDING_FOR_CONSTRUCTED_OBJECT
-          || multibinding_entry.kind
+      multibinding_entry.getKind() == ComponentStorageEntry::Kind::MULTIBINDING_FOR_CONSTRUCTED_OBJECT
+          || multibinding_entry.getKind()
               == ComponentStorageEntry::Kind::MULTIBINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_ALLOCATION
-          || multibinding_entry.kind
+          || multibinding_entry.getKind()
               == ComponentStorageEntry::Kind::MULTIBINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_NO_ALLOCATION);
   context.handle_multibinding(multibinding_entry, entry);
 }
@@ -374,7 +372,7 @@ template <typename... Params>
 FRUIT_ALWAYS_INLINE inline void BindingNormalization::handleComponentWithoutArgsEndMarker(
     BindingNormalizationContext<Params...>& context) {
   ComponentStorageEntry entry = context.entries_to_process.back();
-  FruitAssert(entry.kind == ComponentStorageEntry::Kind::COMPONENT_WITHOUT_ARGS_END_MARKER);
+  FruitAssert(entry.getKind() == ComponentStorageEntry::Kind::COMPONENT_WITHOUT_ARGS_END_MARKER);
   context.entries_to_process.pop_back();
   // A lazy component expansion has completed; we now move the component from
   // components_with_*_with_expansion_in_progress to fully_expanded_components_*.
@@ -387,7 +385,7 @@ template <typename... Params>
 FRUIT_ALWAYS_INLINE inline void BindingNormalization::handleComponentWithArgsEndMarker(
     BindingNormalizationContext<Params...>& context) {
   ComponentStorageEntry entry = context.entries_to_process.back();
-  FruitAssert(entry.kind == ComponentStorageEntry::Kind::COMPONENT_WITH_ARGS_END_MARKER);
+  FruitAssert(entry.getKind() == ComponentStorageEntry::Kind::COMPONENT_WITH_ARGS_END_MARKER);
   context.entries_to_process.pop_back();
   // A lazy component expansion has completed; we now move the component from
   // components_with_*_with_expansion_in_progress to fully_expanded_components_*.
@@ -399,7 +397,7 @@ FRUIT_ALWAYS_INLINE inline void BindingNormalization::handleComponentWithArgsEnd
 template <typename... Params>
 void BindingNormalization::handleReplacedLazyComponentWithArgs(BindingNormalizationContext<Params...>& context) {
   ComponentStorageEntry entry = context.entries_to_process.back();
-  FruitAssert(entry.kind == ComponentStorageEntry::Kind::REPLACED_LAZY_COMPONENT_WITH_ARGS);
+  FruitAssert(entry.getKind() == ComponentStorageEntry::Kind::REPLACED_LAZY_COMPONENT_WITH_ARGS);
   ComponentStorageEntry replaced_component_entry = std::move(entry);
   context.entries_to_process.pop_back();
   FruitAssert(!context.entries_to_process.empty());
@@ -407,8 +405,8 @@ void BindingNormalization::handleReplacedLazyComponentWithArgs(BindingNormalizat
   ComponentStorageEntry replacement_component_entry = std::move(context.entries_to_process.back());
   context.entries_to_process.pop_back();
   FruitAssert(
-      replacement_component_entry.kind == ComponentStorageEntry::Kind::REPLACEMENT_LAZY_COMPONENT_WITH_NO_ARGS
-      || replacement_component_entry.kind == ComponentStorageEntry::Kind::REPLACEMENT_LAZY_COMPONENT_WITH_ARGS);
+      replacement_component_entry.getKind() == ComponentStorageEntry::Kind::REPLACEMENT_LAZY_COMPONENT_WITH_NO_ARGS
+      || replacement_component_entry.getKind() == ComponentStorageEntry::Kind::REPLACEMENT_LAZY_COMPONENT_WITH_ARGS);
 
   if (context.components_with_args_with_expansion_in_progress.count(entry.lazy_component_with_args) != 0
       || context.fully_expanded_components_with_args.count(entry.lazy_component_with_args) != 0) {
@@ -418,15 +416,15 @@ void BindingNormalization::handleReplacedLazyComponentWithArgs(BindingNormalizat
 
   ComponentStorageEntry& replacement_component_entry_in_map =
       context.component_with_args_replacements[replaced_component_entry.lazy_component_with_args];
-  if (replacement_component_entry_in_map.type_id.type_info == nullptr) {
+  if (replacement_component_entry_in_map.getTypeId().type_info == nullptr) {
     // We just inserted replaced_component_entry.lazy_component_with_args in the map, so it's now owned by the
     // map.
     replacement_component_entry_in_map = replacement_component_entry;
   } else {
     // The map already contained a replacement component, we must check that they are consistent.
-    switch (replacement_component_entry.kind) { // LCOV_EXCL_BR_LINE
+    switch (replacement_component_entry.getKind()) { // LCOV_EXCL_BR_LINE
     case ComponentStorageEntry::Kind::REPLACEMENT_LAZY_COMPONENT_WITH_NO_ARGS:
-      if (replacement_component_entry_in_map.kind != ComponentStorageEntry::Kind::REPLACEMENT_LAZY_COMPONENT_WITH_NO_ARGS
+      if (replacement_component_entry_in_map.getKind() != ComponentStorageEntry::Kind::REPLACEMENT_LAZY_COMPONENT_WITH_NO_ARGS
           || replacement_component_entry_in_map.lazy_component_with_no_args.erased_fun
               != replacement_component_entry.lazy_component_with_no_args.erased_fun) {
         printIncompatibleComponentReplacementsError(
@@ -439,7 +437,7 @@ void BindingNormalization::handleReplacedLazyComponentWithArgs(BindingNormalizat
       break;
 
     case ComponentStorageEntry::Kind::REPLACEMENT_LAZY_COMPONENT_WITH_ARGS:
-      if (replacement_component_entry_in_map.kind != ComponentStorageEntry::Kind::REPLACEMENT_LAZY_COMPONENT_WITH_ARGS
+      if (replacement_component_entry_in_map.getKind() != ComponentStorageEntry::Kind::REPLACEMENT_LAZY_COMPONENT_WITH_ARGS
           || !(*replacement_component_entry_in_map.lazy_component_with_args.component
               == *replacement_component_entry.lazy_component_with_args.component)) {
         printIncompatibleComponentReplacementsError(
@@ -461,7 +459,7 @@ void BindingNormalization::handleReplacedLazyComponentWithArgs(BindingNormalizat
 template <typename... Params>
 void BindingNormalization::handleReplacedLazyComponentWithNoArgs(BindingNormalizationContext<Params...>& context) {
   ComponentStorageEntry entry = context.entries_to_process.back();
-  FruitAssert(entry.kind == ComponentStorageEntry::Kind::REPLACED_LAZY_COMPONENT_WITH_NO_ARGS);
+  FruitAssert(entry.getKind() == ComponentStorageEntry::Kind::REPLACED_LAZY_COMPONENT_WITH_NO_ARGS);
   ComponentStorageEntry replaced_component_entry = std::move(entry);
   context.entries_to_process.pop_back();
   FruitAssert(!context.entries_to_process.empty());
@@ -469,8 +467,8 @@ void BindingNormalization::handleReplacedLazyComponentWithNoArgs(BindingNormaliz
   ComponentStorageEntry replacement_component_entry = std::move(context.entries_to_process.back());
   context.entries_to_process.pop_back();
   FruitAssert(
-      replacement_component_entry.kind == ComponentStorageEntry::Kind::REPLACEMENT_LAZY_COMPONENT_WITH_NO_ARGS
-      || replacement_component_entry.kind == ComponentStorageEntry::Kind::REPLACEMENT_LAZY_COMPONENT_WITH_ARGS);
+      replacement_component_entry.getKind() == ComponentStorageEntry::Kind::REPLACEMENT_LAZY_COMPONENT_WITH_NO_ARGS
+      || replacement_component_entry.getKind() == ComponentStorageEntry::Kind::REPLACEMENT_LAZY_COMPONENT_WITH_ARGS);
 
   if (context.components_with_no_args_with_expansion_in_progress.count(entry.lazy_component_with_no_args) != 0
       || context.fully_expanded_components_with_no_args.count(entry.lazy_component_with_no_args) != 0) {
@@ -480,15 +478,15 @@ void BindingNormalization::handleReplacedLazyComponentWithNoArgs(BindingNormaliz
 
   ComponentStorageEntry& replacement_component_entry_in_map =
       context.component_with_no_args_replacements[replaced_component_entry.lazy_component_with_no_args];
-  if (replacement_component_entry_in_map.type_id.type_info == nullptr) {
+  if (replacement_component_entry_in_map.getTypeId().type_info == nullptr) {
     // We just inserted replaced_component_entry.lazy_component_with_args in the map, so it's now owned by the
     // map.
     replacement_component_entry_in_map = replacement_component_entry;
   } else {
     // The map already contained a replacement component, we must check that they are consistent.
-    switch (replacement_component_entry.kind) { // LCOV_EXCL_BR_LINE
+    switch (replacement_component_entry.getKind()) { // LCOV_EXCL_BR_LINE
     case ComponentStorageEntry::Kind::REPLACEMENT_LAZY_COMPONENT_WITH_NO_ARGS:
-      if (replacement_component_entry_in_map.kind != ComponentStorageEntry::Kind::REPLACEMENT_LAZY_COMPONENT_WITH_NO_ARGS
+      if (replacement_component_entry_in_map.getKind() != ComponentStorageEntry::Kind::REPLACEMENT_LAZY_COMPONENT_WITH_NO_ARGS
           || replacement_component_entry_in_map.lazy_component_with_no_args.erased_fun
               != replacement_component_entry.lazy_component_with_no_args.erased_fun) {
         printIncompatibleComponentReplacementsError(
@@ -500,7 +498,7 @@ void BindingNormalization::handleReplacedLazyComponentWithNoArgs(BindingNormaliz
       break;
 
     case ComponentStorageEntry::Kind::REPLACEMENT_LAZY_COMPONENT_WITH_ARGS:
-      if (replacement_component_entry_in_map.kind != ComponentStorageEntry::Kind::REPLACEMENT_LAZY_COMPONENT_WITH_ARGS
+      if (replacement_component_entry_in_map.getKind() != ComponentStorageEntry::Kind::REPLACEMENT_LAZY_COMPONENT_WITH_ARGS
           || !(*replacement_component_entry_in_map.lazy_component_with_args.component
               == *replacement_component_entry.lazy_component_with_args.component)) {
         printIncompatibleComponentReplacementsError(
@@ -526,16 +524,18 @@ void BindingNormalization::performComponentReplacement(
 
   ComponentStorageEntry& entry = context.entries_to_process.back();
 
-  switch (replacement.kind) { // LCOV_EXCL_BR_LINE
+  switch (replacement.getKind()) { // LCOV_EXCL_BR_LINE
   case ComponentStorageEntry::Kind::REPLACEMENT_LAZY_COMPONENT_WITH_ARGS:
-    entry.kind = ComponentStorageEntry::Kind::LAZY_COMPONENT_WITH_ARGS;
-    entry.type_id = replacement.type_id;
-    entry.lazy_component_with_args = replacement.lazy_component_with_args.copy();
+    entry.setKind(ComponentStorageEntry::Kind::LAZY_COMPONENT_WITH_ARGS);
+    entry.setTypeId(replacement.getTypeId());
+    // The copy is owned by the context (via entries_to_process and then fully_expanded_components_with_args), so it
+    // can live in the memory pool.
+    entry.lazy_component_with_args = replacement.lazy_component_with_args.copy(&context.memory_pool);
     break;
 
   case ComponentStorageEntry::Kind::REPLACEMENT_LAZY_COMPONENT_WITH_NO_ARGS:
-    entry.kind = ComponentStorageEntry::Kind::LAZY_COMPONENT_WITH_NO_ARGS;
-    entry.type_id = replacement.type_id;
+    entry.setKind(ComponentStorageEntry::Kind::LAZY_COMPONENT_WITH_NO_ARGS);
+    entry.setTypeId(replacement.getTypeId());
     entry.lazy_component_with_no_args = replacement.lazy_component_with_no_args;
     break;
 
@@ -548,7 +548,7 @@ template <typename... Params>
 FRUIT_ALWAYS_INLINE inline void BindingNormalization::handleLazyComponentWithArgs(
     BindingNormalizationContext<Params...>& context) {
   ComponentStorageEntry entry = context.entries_to_process.back();
-  FruitAssert(entry.kind == ComponentStorageEntry::Kind::LAZY_COMPONENT_WITH_ARGS);
+  FruitAssert(entry.getKind() == ComponentStorageEntry::Kind::LAZY_COMPONENT_WITH_ARGS);
   if (context.fully_expanded_components_with_args.count(entry.lazy_component_with_args)) {
     // This lazy component was already inserted, skip it.
     entry.lazy_component_with_args.destroy();
@@ -577,7 +577,7 @@ FRUIT_ALWAYS_INLINE inline void BindingNormalization::handleLazyComponentWithArg
   // Instead of removing the component from component.lazy_components, we just change its kind to the
   // corresponding *_END_MARKER kind.
   // When we pop this marker, this component's expansion will be complete.
-  context.entries_to_process.back().kind = ComponentStorageEntry::Kind::COMPONENT_WITH_ARGS_END_MARKER;
+  context.entries_to_process.back().setKind(ComponentStorageEntry::Kind::COMPONENT_WITH_ARGS_END_MARKER);
 
   // Note that this can also add other lazy components, so the resulting bindings can have a non-intuitive
   // (although deterministic) order.
@@ -588,7 +588,7 @@ template <typename... Params>
 FRUIT_ALWAYS_INLINE inline void BindingNormalization::handleLazyComponentWithNoArgs(
     BindingNormalizationContext<Params...>& context) {
   ComponentStorageEntry entry = context.entries_to_process.back();
-  FruitAssert(entry.kind == ComponentStorageEntry::Kind::LAZY_COMPONENT_WITH_NO_ARGS);
+  FruitAssert(entry.getKind() == ComponentStorageEntry::Kind::LAZY_COMPONENT_WITH_NO_ARGS);
   if (context.fully_expanded_components_with_no_args.count(entry.lazy_component_with_no_args)) {
     // This lazy component was already inserted, skip it.
     context.entries_to_process.pop_back();
@@ -609,17 +609,18 @@ FRUIT_ALWAYS_INLINE inline void BindingNormalization::handleLazyComponentWithNoA
   }
 
 #ifdef FRUIT_EXTRA_DEBUG
-  std::cout << "Expanding lazy component: " << entry.type_id << std::endl;
+  std::cout << "Expanding lazy component: " << entry.getTypeId() << std::endl;
 #endif
 
   // Instead of removing the component from component.lazy_components, we just change its kind to the
   // corresponding *_END_MARKER kind.
   // When we pop this marker, this component's expansion will be complete.
-  context.entries_to_process.back().kind = ComponentStorageEntry::Kind::COMPONENT_WITHOUT_ARGS_END_MARKER;
+  context.entries_to_process.back().setKind(ComponentStorageEntry::Kind::COMPONENT_WITHOUT_ARGS_END_MARKER);
 
   // Note that this can also add other lazy components, so the resulting bindings can have a non-intuitive
   // (although deterministic) order.
-  context.entries_to_process.back().lazy_component_with_no_args.addBindings(context.entries_to_process);
+  context.entries_to_process.back().lazy_component_with_no_args.addBindings(
+      entry.getTypeId(), context.entries_to_process);
 }
 
 template <
@@ -632,18 +633,23 @@ void BindingNormalization::normalizeBindingsAndAddTo(
     FixedSizeVector<ComponentStorageEntry>&& toplevel_entries,
     MemoryPool& memory_pool,
     const FixedSizeAllocator::FixedSizeAllocatorData& base_fixed_size_allocator_data,
-    const std::unordered_map<TypeId, NormalizedMultibindingSet>& base_multibindings,
+    const NormalizedMultibindingSetMap& base_multibindings,
     const NormalizedComponentStorage::BindingCompressionInfoMap& base_binding_compression_info_map,
     FixedSizeAllocator::FixedSizeAllocatorData& fixed_size_allocator_data,
     std::vector<ComponentStorageEntry, ArenaAllocator<ComponentStorageEntry>>& new_bindings_vector,
-    std::unordered_map<TypeId, NormalizedMultibindingSet>& multibindings,
+    NormalizedMultibindingSetMap& multibindings,
     FindNormalizedBinding find_normalized_binding,
     IsValidItr is_valid_itr,
     IsNormalizedBindingItrForConstructedObject is_normalized_binding_itr_for_constructed_object,
     GetObjectPtr get_object_ptr,
     GetCreate get_create) {
 
-  multibindings = base_multibindings;
+  // We can't just copy-assign base_multibindings, since the copied NormalizedMultibindingSet objects must use the
+  // allocator of `multibindings'.
+  multibindings.clear();
+  for (const auto& p : base_multibindings) {
+    multibindings.emplace(p.first, NormalizedMultibindingSet(p.second, multibindings.get_allocator()));
+  }
 
   fixed_size_allocator_data = base_fixed_size_allocator_data;
 
@@ -655,7 +661,6 @@ void BindingNormalization::normalizeBindingsAndAddTo(
 
   normalizeBindings(
       std::move(toplevel_entries),
-      fixed_size_allocator_data,
       memory_pool,
       binding_data_map,
       [](ComponentStorageEntry) {},
@@ -669,6 +674,10 @@ void BindingNormalization::normalizeBindingsAndAddTo(
       get_object_ptr,
       get_create);
 
+  BindingArrays binding_arrays(binding_data_map, memory_pool);
+
+  addBindingsToFixedSizeAllocatorData(binding_arrays, fixed_size_allocator_data);
+
   // Copy the normalized bindings into the result vector.
   new_bindings_vector.clear();
   new_bindings_vector.reserve(binding_data_map.size());
@@ -680,8 +689,8 @@ void BindingNormalization::normalizeBindingsAndAddTo(
 
   HashSetWithArenaAllocator<TypeId> binding_compressions_to_undo =
       createHashSetWithArenaAllocator<TypeId>(memory_pool);
-  for (const ComponentStorageEntry& entry : new_bindings_vector) {
-    switch (entry.kind) { // LCOV_EXCL_BR_LINE
+  for (std::size_t binding_index = 0; binding_index < binding_arrays.size(); ++binding_index) {
+    switch (binding_arrays.kinds[binding_index]) { // LCOV_EXCL_BR_LINE
     case ComponentStorageEntry::Kind::BINDING_FOR_CONSTRUCTED_OBJECT:
       break;
 
@@ -689,12 +698,12 @@ void BindingNormalization::normalizeBindingsAndAddTo(
     case ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_ALLOCATION:
     case ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_WITH_UNKNOWN_ALLOCATION:
       {
-        const BindingDeps *entry_deps = entry.binding_for_object_to_construct.deps;
+        const BindingDeps *entry_deps = binding_arrays.deps[binding_index];
         for (std::size_t i = 0; i < entry_deps->num_deps; ++i) {
           auto binding_compression_itr =
               base_binding_compression_info_map.find(entry_deps->deps[i]);
           if (binding_compression_itr != base_binding_compression_info_map.end()
-              && binding_compression_itr->second.i_type_id != entry.type_id) {
+              && binding_compression_itr->second.i_type_id != binding_arrays.type_ids[binding_index]) {
             // The binding compression for `p.second.getDeps()->deps[i]' must be undone because something
             // different from binding_compression_itr->iTypeId is now bound to it.
             binding_compressions_to_undo.insert(entry_deps->deps[i]);
@@ -705,7 +714,7 @@ void BindingNormalization::normalizeBindingsAndAddTo(
 
     default:
 #ifdef FRUIT_EXTRA_DEBUG
-      std::cerr << "Unexpected kind: " << (std::size_t)entry.kind << std::endl;
+      std::cerr << "Unexpected kind: " << (std::size_t)binding_arrays.kinds[binding_index] << std::endl;
 #endif
       FRUIT_UNREACHABLE; // LCOV_EXCL_LINE
       break;
@@ -719,13 +728,13 @@ void BindingNormalization::normalizeBindingsAndAddTo(
     FruitAssert(is_valid_itr(find_normalized_binding(binding_compression_itr->second.i_type_id)));
 
     ComponentStorageEntry c_binding;
-    c_binding.type_id = cTypeId;
-    c_binding.kind = ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_WITH_UNKNOWN_ALLOCATION;
+    c_binding.setTypeId(cTypeId);
+    c_binding.setKind(ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_WITH_UNKNOWN_ALLOCATION);
     c_binding.binding_for_object_to_construct = binding_compression_itr->second.c_binding;
 
     ComponentStorageEntry i_binding;
-    i_binding.type_id = binding_compression_itr->second.i_type_id;
-    i_binding.kind = ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_NO_ALLOCATION;
+    i_binding.setTypeId(binding_compression_itr->second.i_type_id);
+    i_binding.setKind(ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_NO_ALLOCATION);
     i_binding.binding_for_object_to_construct = binding_compression_itr->second.i_binding;
 
     new_bindings_vector.push_back(std::move(c_binding));
@@ -744,25 +753,37 @@ void BindingNormalization::normalizeBindingsAndAddTo(
 template <typename SaveCompressedBindingUndoInfo>
 std::vector<ComponentStorageEntry, ArenaAllocator<ComponentStorageEntry>> BindingNormalization::performBindingCompression(
     HashMapWithArenaAllocator<TypeId, ComponentStorageEntry>&& binding_data_map,
+    const BindingArrays& binding_arrays,
     HashMapWithArenaAllocator<TypeId, BindingCompressionInfo>&& compressed_bindings_map,
+    HashMapWithArenaAllocator<TypeId, ChainedBindingCompressionInfo>&& chained_compressed_bindings_map,
     MemoryPool& memory_pool,
     const multibindings_vector_t& multibindings_vector,
     const std::vector<TypeId, ArenaAllocator<TypeId>>& exposed_types,
+    const std::vector<TypeId, ArenaAllocator<TypeId>>& shared_types,
+    bool bindings_are_final,
+    FixedSizeAllocator::FixedSizeAllocatorData& fixed_size_allocator_data,
     SaveCompressedBindingUndoInfo save_compressed_binding_undo_info) {
   using result_t = std::vector<ComponentStorageEntry, ArenaAllocator<ComponentStorageEntry>>;
   result_t result = result_t(ArenaAllocator<ComponentStorageEntry>(memory_pool));
 
+  FruitAssert(bindings_are_final || chained_compressed_bindings_map.empty());
+  FruitAssert(!bindings_are_final || shared_types.empty());
+
+  // The types that can't be removed from the graph, even if they only have 1 dependent.
+  HashSetWithArenaAllocator<TypeId> pinned_types =
+      createHashSetWithArenaAllocator<TypeId>(exposed_types.size(), memory_pool);
+
   // We can't compress the binding if C is a dep of a multibinding.
   for (const std::pair<ComponentStorageEntry, ComponentStorageEntry>& multibinding_entry_pair : multibindings_vector) {
     const ComponentStorageEntry& entry = multibinding_entry_pair.first;
-    FruitAssert(entry.kind == ComponentStorageEntry::Kind::MULTIBINDING_FOR_CONSTRUCTED_OBJECT
-        || entry.kind == ComponentStorageEntry::Kind::MULTIBINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_ALLOCATION
-        || entry.kind == ComponentStorageEntry::Kind::MULTIBINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_NO_ALLOCATION);
-    if (entry.kind != ComponentStorageEntry::Kind::MULTIBINDING_FOR_CONSTRUCTED_OBJECT) {
-      const BindingDeps* deps = entry.multibinding_for_object_to_construct.deps;
+    FruitAssert(entry.getKind() == ComponentStorageEntry::Kind::MULTIBINDING_FOR_CONSTRUCTED_OBJECT
+        || entry.getKind() == ComponentStorageEntry::Kind::MULTIBINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_ALLOCATION
+        || entry.getKind() == ComponentStorageEntry::Kind::MULTIBINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_NO_ALLOCATION);
+    if (entry.getKind() != ComponentStorageEntry::Kind::MULTIBINDING_FOR_CONSTRUCTED_OBJECT) {
+      const BindingDeps* deps = &entry.multibinding_for_object_to_construct.data->deps;
       FruitAssert(deps != nullptr);
       for (std::size_t i = 0; i < deps->num_deps; ++i) {
-        compressed_bindings_map.erase(deps->deps[i]);
+        pinned_types.insert(deps->deps[i]);
 #ifdef FRUIT_EXTRA_DEBUG
         std::cout << "InjectorStorage: ignoring compressed binding for " << deps->deps[i] << " because it's a dep of a multibinding." << std::endl;
 #endif
@@ -772,72 +793,168 @@ std::vector<ComponentStorageEntry, ArenaAllocator<ComponentStorageEntry>> Bindin
 
   // We can't compress the binding if C is an exposed type (but I is likely to be exposed instead).
   for (TypeId type : exposed_types) {
-    compressed_bindings_map.erase(type);
+    pinned_types.insert(type);
 #ifdef FRUIT_EXTRA_DEBUG
     std::cout << "InjectorStorage: ignoring compressed binding for " << type << " because it's an exposed type." << std::endl;
 #endif
   }
 
-  // We can't compress the binding if some type X depends on C and X!=I.
-  for (auto& binding_data_map_entry : binding_data_map) {
-    TypeId x_id = binding_data_map_entry.first;
-    ComponentStorageEntry entry = binding_data_map_entry.second;
-    FruitAssert(entry.kind == ComponentStorageEntry::Kind::BINDING_FOR_CONSTRUCTED_OBJECT
-        || entry.kind == ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_ALLOCATION
-        || entry.kind == ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_NO_ALLOCATION);
-
-    if (entry.kind != ComponentStorageEntry::Kind::BINDING_FOR_CONSTRUCTED_OBJECT) {
-      for (std::size_t i = 0; i < entry.binding_for_object_to_construct.deps->num_deps; ++i) {
-        TypeId c_id = entry.binding_for_object_to_construct.deps->deps[i];
-        auto itr = compressed_bindings_map.find(c_id);
-        if (itr != compressed_bindings_map.end() && itr->second.i_type_id != x_id) {
-          compressed_bindings_map.erase(itr);
+  // We can't compress the binding if C might be constructed together with a shared singleton, since then the C object
+  // is shared with the injectors and the compression can't be undone in an injector that injects C directly.
+  std::vector<TypeId, ArenaAllocator<TypeId>> types_to_visit =
+      std::vector<TypeId, ArenaAllocator<TypeId>>(
+          shared_types.begin(), shared_types.end(), ArenaAllocator<TypeId>(memory_pool));
+  HashSetWithArenaAllocator<TypeId> visited_types = createHashSetWithArenaAllocator<TypeId>(memory_pool);
+  while (!types_to_visit.empty()) {
+    TypeId type = types_to_visit.back();
+    types_to_visit.pop_back();
+    if (!visited_types.insert(type).second) {
+      continue;
+    }
+    pinned_types.insert(type);
 #ifdef FRUIT_EXTRA_DEBUG
-          std::cout << "InjectorStorage: ignoring compressed binding for " << c_id << " because the type " <<  x_id << " depends on it." << std::endl;
+    std::cout << "InjectorStorage: ignoring compressed binding for " << type << " because it might be constructed together with a shared singleton." << std::endl;
 #endif
+    auto itr = binding_data_map.find(type);
+    if (itr != binding_data_map.end()
+        && itr->second.getKind() != ComponentStorageEntry::Kind::BINDING_FOR_CONSTRUCTED_OBJECT) {
+      const BindingDeps* deps = &itr->second.binding_for_object_to_construct.data->deps;
+      types_to_visit.insert(types_to_visit.end(), deps->deps, deps->deps + deps->num_deps);
+    }
+  }
+
+  // For each type, the only type that depends on it (if there's exactly one).
+  // Types with more than 1 dependent are mapped to themselves (a type never depends on itself).
+  HashMapWithArenaAllocator<TypeId, TypeId> only_dependent =
+      createHashMapWithArenaAllocator<TypeId, TypeId>(binding_data_map.size(), memory_pool);
+  FruitAssert(binding_arrays.size() == binding_data_map.size());
+  for (std::size_t binding_index = 0; binding_index < binding_arrays.size(); ++binding_index) {
+    TypeId x_id = binding_arrays.type_ids[binding_index];
+    ComponentStorageEntry::Kind kind = binding_arrays.kinds[binding_index];
+    FruitAssert(kind == ComponentStorageEntry::Kind::BINDING_FOR_CONSTRUCTED_OBJECT
+        || kind == ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_ALLOCATION
+        || kind == ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_NO_ALLOCATION);
+
+    if (kind != ComponentStorageEntry::Kind::BINDING_FOR_CONSTRUCTED_OBJECT) {
+      const BindingDeps* deps = binding_arrays.deps[binding_index];
+      for (std::size_t i = 0; i < deps->num_deps; ++i) {
+        TypeId c_id = deps->deps[i];
+        auto itr_and_inserted = only_dependent.emplace(c_id, x_id);
+        if (!itr_and_inserted.second && itr_and_inserted.first->second != x_id) {
+          itr_and_inserted.first->second = c_id;
         }
       }
     }
   }
 
-  // Two pairs of compressible bindings (I->C) and (C->X) can not exist (the C of a compressible binding is always bound either
-  // using constructor binding or provider binding, it can't be a binding itself). So no need to check for that.
+  // Returns true if `type' can be removed from the graph, merging its binding into the one of `dependent'.
+  auto can_be_merged_into = [&](TypeId type, TypeId dependent) {
+    if (pinned_types.count(type) != 0) {
+      return false;
+    }
+    auto itr = only_dependent.find(type);
+    FruitAssert(itr != only_dependent.end());
+    return itr->second == dependent;
+  };
+
+  std::size_t num_removed_bindings = 0;
+  std::size_t num_removed_allocator_slots = 0;
 
   // Now perform the binding compression.
   for (auto& entry : compressed_bindings_map) {
     TypeId c_id = entry.first;
     TypeId i_id = entry.second.i_type_id;
+    if (!can_be_merged_into(c_id, i_id)) {
+#ifdef FRUIT_EXTRA_DEBUG
+      std::cout << "InjectorStorage: ignoring compressed binding for " << c_id << " because a type other than " << i_id << " depends on it (or it's pinned)." << std::endl;
+#endif
+      continue;
+    }
     auto i_binding_data = binding_data_map.find(i_id);
     auto c_binding_data = binding_data_map.find(c_id);
     FruitAssert(i_binding_data != binding_data_map.end());
     FruitAssert(c_binding_data != binding_data_map.end());
     NormalizedComponentStorage::CompressedBindingUndoInfo undo_info;
     undo_info.i_type_id = i_id;
-    FruitAssert(i_binding_data->second.kind == ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_NO_ALLOCATION);
+    FruitAssert(i_binding_data->second.getKind() == ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_NO_ALLOCATION);
     undo_info.i_binding = i_binding_data->second.binding_for_object_to_construct;
     FruitAssert(
-        c_binding_data->second.kind == ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_NO_ALLOCATION
-        || c_binding_data->second.kind == ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_ALLOCATION);
+        c_binding_data->second.getKind() == ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_NO_ALLOCATION
+        || c_binding_data->second.getKind() == ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_ALLOCATION);
     undo_info.c_binding = c_binding_data->second.binding_for_object_to_construct;
     save_compressed_binding_undo_info(c_id, undo_info);
 
+    const ComponentStorageEntry::BindingForObjectToConstruct::Data* i_binding_with_compression =
+        entry.second.i_binding_with_compression;
+
+    // If I is in turn bound to other interfaces (I2 -> I -> C, I3 -> I2 -> I -> C, ...) we can compress the whole chain
+    // into the topmost binding. This is only done when bindings_are_final, otherwise chained_compressed_bindings_map
+    // is empty.
+    while (true) {
+      auto dependent_itr = only_dependent.find(i_id);
+      if (dependent_itr == only_dependent.end() || dependent_itr->second == i_id) {
+        break;
+      }
+      TypeId dependent_id = dependent_itr->second;
+      auto chained_itr = chained_compressed_bindings_map.find(dependent_id);
+      if (chained_itr == chained_compressed_bindings_map.end()
+          || chained_itr->second.c_type_id != c_id
+          || !can_be_merged_into(i_id, dependent_id)) {
+        break;
+      }
+      FruitAssert(i_binding_data->second.getKind() == ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_NO_ALLOCATION);
+      auto dependent_binding_data = binding_data_map.find(dependent_id);
+      FruitAssert(dependent_binding_data != binding_data_map.end());
+      FruitAssert(dependent_binding_data->second.getKind() == ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_NO_ALLOCATION);
+      FruitAssert(dependent_binding_data->second.binding_for_object_to_construct.data->deps.num_deps == 1);
+#ifdef FRUIT_EXTRA_DEBUG
+      std::cout << "InjectorStorage: performing binding compression for the edge " << dependent_id << "->" << i_id << std::endl;
+      dependent_binding_data->second.binding_for_object_to_construct.is_nonconst |=
+          i_binding_data->second.binding_for_object_to_construct.is_nonconst;
+#endif
+      binding_data_map.erase(i_binding_data);
+      // The interface binding for I no longer exists, so it won't need a slot in the allocator.
+      fixed_size_allocator_data.removeExternallyAllocatedType(i_id);
+      ++num_removed_bindings;
+      ++num_removed_allocator_slots;
+
+      i_id = dependent_id;
+      i_binding_data = dependent_binding_data;
+      i_binding_with_compression = chained_itr->second.i_binding_with_compression;
+    }
+
     // Note that even if I is the one that remains, C is the one that will be allocated, not I.
 
-    i_binding_data->second.kind = c_binding_data->second.kind;
-    i_binding_data->second.binding_for_object_to_construct.create = entry.second.create_i_with_compression;
-    i_binding_data->second.binding_for_object_to_construct.deps =
-        c_binding_data->second.binding_for_object_to_construct.deps;
+    i_binding_data->second.setKind(c_binding_data->second.getKind());
+    // The compressed binding has the same deps as C.
+    FruitAssert(i_binding_with_compression->deps.num_deps
+        == c_binding_data->second.binding_for_object_to_construct.data->deps.num_deps);
+    i_binding_data->second.binding_for_object_to_construct.data = i_binding_with_compression;
 #ifdef FRUIT_EXTRA_DEBUG
     i_binding_data->second.binding_for_object_to_construct.is_nonconst |=
         c_binding_data->second.binding_for_object_to_construct.is_nonconst;
 #endif
 
     binding_data_map.erase(c_binding_data);
+    ++num_removed_bindings;
+    if (bindings_are_final) {
+      // The topmost interface binding now allocates C, so the slot reserved for the interface binding isn't needed.
+      fixed_size_allocator_data.removeExternallyAllocatedType(i_id);
+      ++num_removed_allocator_slots;
+    }
 #ifdef FRUIT_EXTRA_DEBUG
-    std::cout << "InjectorStorage: performing binding compression for the edge " << i_id << "->" << c_id << std::endl;
+    std::cout << "InjectorStorage: performing binding compression for the edge " << entry.second.i_type_id << "->" << c_id << std::endl;
 #endif
   }
 
+#ifdef FRUIT_EXTRA_DEBUG
+  std::cout << "InjectorStorage: binding compression removed " << num_removed_bindings << " bindings and "
+            << num_removed_allocator_slots << " allocator slots." << std::endl;
+#else
+  (void)num_removed_bindings;
+  (void)num_removed_allocator_slots;
+#endif
+
   // Copy the normalized bindings into the result vector.
   result.reserve(binding_data_map.size());
   for (auto& p : binding_data_map) {
@@ -853,15 +970,18 @@ void BindingNormalization::normalizeBindingsWithBindingCompression(
     FixedSizeAllocator::FixedSizeAllocatorData& fixed_size_allocator_data,
     MemoryPool& memory_pool,
     const std::vector<TypeId, ArenaAllocator<TypeId>>& exposed_types,
+    const std::vector<TypeId, ArenaAllocator<TypeId>>& shared_types,
+    bool bindings_are_final,
     std::vector<ComponentStorageEntry, ArenaAllocator<ComponentStorageEntry>>& bindings_vector,
-    std::unordered_map<TypeId, NormalizedMultibindingSet>& multibindings,
+    NormalizedMultibindingSetMap& multibindings,
     SaveCompressedBindingUndoInfo save_compressed_binding_undo_info) {
 
   HashMapWithArenaAllocator<TypeId, ComponentStorageEntry> binding_data_map =
       createHashMapWithArenaAllocator<TypeId, ComponentStorageEntry>(memory_pool);
-  // CtypeId -> (ItypeId, bindingData)
-  HashMapWithArenaAllocator<TypeId, BindingNormalization::BindingCompressionInfo> compressed_bindings_map =
-      createHashMapWithArenaAllocator<TypeId, BindingCompressionInfo>(memory_pool);
+
+  std::vector<ComponentStorageEntry, ArenaAllocator<ComponentStorageEntry>> compressed_bindings_vector =
+      std::vector<ComponentStorageEntry, ArenaAllocator<ComponentStorageEntry>>(
+          ArenaAllocator<ComponentStorageEntry>(memory_pool));
 
   multibindings_vector_t multibindings_vector =
       multibindings_vector_t(ArenaAllocator<multibindings_vector_elem_t>(memory_pool));
@@ -870,13 +990,10 @@ void BindingNormalization::normalizeBindingsWithBindingCompression(
 
   normalizeBindings(
       std::move(toplevel_entries),
-      fixed_size_allocator_data,
       memory_pool,
       binding_data_map,
-      [&compressed_bindings_map](ComponentStorageEntry entry) {
-        BindingCompressionInfo& compression_info = compressed_bindings_map[entry.compressed_binding.c_type_id];
-        compression_info.i_type_id = entry.type_id;
-        compression_info.create_i_with_compression = entry.compressed_binding.create;
+      [&compressed_bindings_vector](ComponentStorageEntry entry) {
+        compressed_bindings_vector.push_back(entry);
       },
       [&multibindings_vector](ComponentStorageEntry multibinding,
                               ComponentStorageEntry multibinding_vector_creator) {
@@ -888,13 +1005,61 @@ void BindingNormalization::normalizeBindingsWithBindingCompression(
       [](DummyIterator) { return nullptr; },
       [](DummyIterator) { return nullptr; });
 
+  if (bindings_are_final) {
+    removeUnreachableBindings(
+        binding_data_map,
+        memory_pool,
+        multibindings_vector,
+        exposed_types);
+  }
+
+  // CtypeId -> (ItypeId, bindingData)
+  HashMapWithArenaAllocator<TypeId, BindingNormalization::BindingCompressionInfo> compressed_bindings_map =
+      createHashMapWithArenaAllocator<TypeId, BindingCompressionInfo>(compressed_bindings_vector.size(), memory_pool);
+  // ItypeId -> (CtypeId, bindingData)
+  HashMapWithArenaAllocator<TypeId, BindingNormalization::ChainedBindingCompressionInfo> chained_compressed_bindings_map =
+      createHashMapWithArenaAllocator<TypeId, ChainedBindingCompressionInfo>(memory_pool);
+
+  for (const ComponentStorageEntry& entry : compressed_bindings_vector) {
+    FruitAssert(entry.getKind() == ComponentStorageEntry::Kind::COMPRESSED_BINDING);
+    auto i_binding_data = binding_data_map.find(entry.getTypeId());
+    if (i_binding_data == binding_data_map.end()) {
+      // I was unreachable, so it has been removed.
+      continue;
+    }
+    FruitAssert(i_binding_data->second.getKind() != ComponentStorageEntry::Kind::BINDING_FOR_CONSTRUCTED_OBJECT);
+    const BindingDeps* i_deps = &i_binding_data->second.binding_for_object_to_construct.data->deps;
+    const ComponentStorageEntry::CompressedBinding::Data* compressed_binding_data = entry.compressed_binding.data;
+    if (i_deps->num_deps == 1 && i_deps->deps[0] == compressed_binding_data->c_type_id) {
+      // I is bound directly to C.
+      BindingCompressionInfo& compression_info = compressed_bindings_map[compressed_binding_data->c_type_id];
+      compression_info.i_type_id = entry.getTypeId();
+      compression_info.i_binding_with_compression = &compressed_binding_data->i_binding_with_compression;
+    } else if (bindings_are_final) {
+      ChainedBindingCompressionInfo& compression_info = chained_compressed_bindings_map[entry.getTypeId()];
+      compression_info.c_type_id = compressed_binding_data->c_type_id;
+      compression_info.i_binding_with_compression = &compressed_binding_data->i_binding_with_compression;
+    }
+  }
+
+  BindingArrays binding_arrays(binding_data_map, memory_pool);
+
+  // This must be done before binding compression, since the types that will be allocated are the ones in the bindings
+  // before compression.
+  addBindingsToFixedSizeAllocatorData(binding_arrays, fixed_size_allocator_data);
+
   bindings_vector =
       BindingNormalization::performBindingCompression(
           std::move(binding_data_map),
+          binding_arrays,
           std::move(compressed_bindings_map),
+          std::move(chained_compressed_bindings_map),
           memory_pool,
           multibindings_vector,
           exposed_types,
+          shared_types,
+          bindings_are_final,
+          fixed_size_allocator_data,
           save_compressed_binding_undo_info);
 
   addMultibindings(
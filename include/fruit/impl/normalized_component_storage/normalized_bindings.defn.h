@@ -23,7 +23,7 @@ namespace fruit {
 namespace impl {
 
 inline NormalizedBinding::NormalizedBinding(ComponentStorageEntry entry) {
-  switch (entry.kind) { // LCOV_EXCL_BR_LINE
+  switch (entry.getKind()) { // LCOV_EXCL_BR_LINE
   case ComponentStorageEntry::Kind::BINDING_FOR_CONSTRUCTED_OBJECT:
     object = entry.binding_for_constructed_object.object_ptr;
 #ifdef FRUIT_EXTRA_DEBUG
@@ -34,7 +34,7 @@ inline NormalizedBinding::NormalizedBinding(ComponentStorageEntry entry) {
   case ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_ALLOCATION:
   case ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_NO_ALLOCATION:
   case ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_WITH_UNKNOWN_ALLOCATION:
-    create = entry.binding_for_object_to_construct.create;
+    create = entry.binding_for_object_to_construct.data->create;
 #ifdef FRUIT_EXTRA_DEBUG
     is_nonconst = entry.binding_for_object_to_construct.is_nonconst;
 #endif
@@ -42,12 +42,28 @@ inline NormalizedBinding::NormalizedBinding(ComponentStorageEntry entry) {
 
   default:
 #ifdef FRUIT_EXTRA_DEBUG
-      std::cerr << "Unexpected kind: " << (std::size_t)entry.kind << std::endl;
+      std::cerr << "Unexpected kind: " << (std::size_t)entry.getKind() << std::endl;
 #endif
     FRUIT_UNREACHABLE; // LCOV_EXCL_LINE
   }
 }
 
+inline NormalizedMultibindingSet::NormalizedMultibindingSet(elems_allocator_t allocator)
+  : elems(allocator) {
+}
+
+inline NormalizedMultibindingSet::NormalizedMultibindingSet(
+    const NormalizedMultibindingSet& other, elems_allocator_t allocator)
+  : elems(other.elems, allocator),
+    get_multibindings_vector(other.get_multibindings_vector),
+    v(other.v) {
+}
+
+inline ConstructionPlans::ConstructionPlans(MemoryResource* memory_resource)
+  : plan_offsets(ResourceAllocator<std::size_t>(memory_resource)),
+    plan_nodes(ResourceAllocator<std::size_t>(memory_resource)) {
+}
+
 } // namespace impl
 } // namespace fruit
 
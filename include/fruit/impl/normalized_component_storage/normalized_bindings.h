@@ -18,7 +18,12 @@
 #define FRUIT_NORMALIZED_BINDINGS_H
 
 #include <fruit/impl/component_storage/component_storage_entry.h>
+#include <fruit/impl/data_structures/resource_allocator.h>
+#include <fruit/fruit_forward_decls.h>
 #include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
 
 namespace fruit {
 namespace impl {
@@ -31,6 +36,10 @@ struct NormalizedBinding {
 
     // Valid iff this is not a terminal node  (in the SemistaticGraph that contains this NormalizedBinding object).
     ComponentStorageEntry::BindingForObjectToConstruct::create_t create;
+
+    // Valid iff this is an inline terminal node (in the SemistaticGraph that contains this NormalizedBinding object).
+    // This is the object itself, for the types where IsStoredInline is true.
+    alignas(void*) char inline_object[sizeof(void*)];
   };
 
 #ifdef FRUIT_EXTRA_DEBUG
@@ -47,6 +56,26 @@ struct NormalizedBinding {
   explicit NormalizedBinding(ComponentStorageEntry entry);
 };
 
+/**
+ * Whether the C objects that an injector constructs with C's constructor are constructed in their NormalizedBinding
+ * (instead of in the injector's allocator), so that getting them doesn't need to load (and likely miss the cache on) a
+ * separate location. This is opt-in (see fruit::StoredInline), since it's only valid for small types that don't
+ * need to be destroyed.
+ */
+template <typename C>
+struct IsStoredInline {
+  static constexpr bool value = fruit::StoredInline<C>::value;
+
+  static_assert(!value || (sizeof(C) <= sizeof(void*)
+                           && alignof(C) <= alignof(void*)
+                           && std::is_trivially_copyable<C>::value
+                           && std::is_trivially_destructible<C>::value),
+                "Types marked with fruit::StoredInline must be trivially copyable, trivially destructible and at most "
+                "as large (and aligned) as a pointer.");
+  static_assert(!value || !fruit::IsolatedInCacheLine<C>::value,
+                "A type can't be marked with both fruit::StoredInline and fruit::IsolatedInCacheLine.");
+};
+
 /** A single normalized multibinding. */
 struct NormalizedMultibinding {
 
@@ -64,17 +93,60 @@ struct NormalizedMultibinding {
 /** This stores all multibindings for a given type_id. */
 struct NormalizedMultibindingSet {
 
-  // Can be empty, but only if v is present and non-empty.
-  std::vector<NormalizedMultibinding> elems;
+  using elems_allocator_t = ResourceAllocator<NormalizedMultibinding>;
 
-  // TODO: Check this comment.
-  // Returns the std::vector<T*> of instances, or nullptr if none.
+  // Never empty. The size is known at normalization time, and is also the size of the array in `v'.
+  std::vector<NormalizedMultibinding, elems_allocator_t> elems;
+
+  // Returns the (casted) array of T* instances, constructing it first if needed.
   // Caches the result in the `v' member.
   ComponentStorageEntry::MultibindingVectorCreator::get_multibindings_vector_t get_multibindings_vector;
 
-  // A (casted) pointer to the std::vector<T*> of objects, or nullptr if the vector hasn't been constructed yet.
-  // Can't be empty.
-  std::shared_ptr<char> v;
+  // A (casted) pointer to the array of T* pointers to the objects (with elems.size() elements), or nullptr if the array
+  // hasn't been constructed yet. The array is stored in the injector's FixedSizeAllocator.
+  void* v = nullptr;
+
+  // A (casted) std::vector<T*> with the same elements as the array in `v', only created by the first
+  // Injector::getMultibindings() call (Injector::getMultibindingsSpan() uses the array directly).
+  // Only accessed through std::atomic_load() and std::atomic_compare_exchange_strong().
+  std::shared_ptr<char> vector;
+
+  explicit NormalizedMultibindingSet(elems_allocator_t allocator);
+
+  // Creates a copy of `other' that uses `allocator' (instead of the allocator of `other') to allocate `elems'.
+  NormalizedMultibindingSet(const NormalizedMultibindingSet& other, elems_allocator_t allocator);
+};
+
+// Maps the type index of a type T to the corresponding NormalizedMultibindingSet.
+// The NormalizedMultibindingSet objects in the map must use the same MemoryResource as the map itself.
+using NormalizedMultibindingSetMap = std::unordered_map<
+    TypeId,
+    NormalizedMultibindingSet,
+    std::hash<TypeId>,
+    std::equal_to<TypeId>,
+    ResourceAllocator<std::pair<const TypeId, NormalizedMultibindingSet>>>;
+
+/**
+ * For the nodes of the exposed types in the bindings graph of a NormalizedComponentStorage, the other nodes that are
+ * constructed together with them, in construction order (each node comes after its deps).
+ * Nodes are identified by their index in the graph (see SemistaticGraph::getNodeIndex()), so that these can also be
+ * used in the graphs of the injectors, that are copies of that graph.
+ *
+ * Before constructing a node that has a plan, InjectorStorage constructs the nodes in the plan in a loop. Then no
+ * create() call finds non-terminal deps, so the stack depth doesn't grow with the length of the chains of deps.
+ * Lazy deps (e.g. injected with a Provider) are not in the plans, since they might not be constructed at all.
+ * Exposed types are in the plans of other types, but their deps aren't (they're in their own plan instead).
+ */
+struct ConstructionPlans {
+  using index_vector_t = std::vector<std::size_t, ResourceAllocator<std::size_t>>;
+
+  // The plan of the node with index i is in [plan_nodes[plan_offsets[i]], plan_nodes[plan_offsets[i+1]]).
+  // This has an element more than the graph has nodes, or is empty if no plans were computed.
+  index_vector_t plan_offsets;
+
+  index_vector_t plan_nodes;
+
+  explicit ConstructionPlans(MemoryResource* memory_resource);
 };
 
 } // namespace impl
@@ -18,11 +18,15 @@
 #define FRUIT_NORMALIZED_COMPONENT_STORAGE_DEFN_H
 
 #include <fruit/impl/normalized_component_storage/normalized_component_storage.h>
+#include <fruit/impl/injector/injector_storage.h>
 
 namespace fruit {
 namespace impl {
 
 inline NormalizedComponentStorage& NormalizedComponentStorage::operator=(NormalizedComponentStorage&& other) {
+  // The shared singletons must be destroyed before `bindings', see the comment on shared_singletons_storage.
+  shared_singletons_storage = std::unique_ptr<InjectorStorage>();
+
   bindings = std::move(other.bindings);
   multibindings = std::move(other.multibindings);
   fixed_size_allocator_data = std::move(other.fixed_size_allocator_data);
@@ -30,9 +34,14 @@ inline NormalizedComponentStorage& NormalizedComponentStorage::operator=(Normali
   // We must destroy `bindingCompressionInfoMap` before its memory pool, so we clear it explicitly.
   bindingCompressionInfoMap = std::unique_ptr<BindingCompressionInfoMap>();
   bindingCompressionInfoMap = std::move(other.bindingCompressionInfoMap);
+  sharedSingletonCreateMap = std::unique_ptr<SharedSingletonCreateMap>();
+  sharedSingletonCreateMap = std::move(other.sharedSingletonCreateMap);
 
   bindingCompressionInfoMapMemoryPool = std::move(other.bindingCompressionInfoMapMemoryPool);
 
+  shared_singletons_storage = std::move(other.shared_singletons_storage);
+  construction_plans = std::move(other.construction_plans);
+
   return *this;
 }
 
@@ -55,26 +55,63 @@ public:
   using BindingCompressionInfoMap = HashMapWithArenaAllocator<TypeId, CompressedBindingUndoInfo>;
   using BindingCompressionInfoMapAllocator = BindingCompressionInfoMap::allocator_type;
 
+  // A map from the type_id of each shared singleton (and of each of its deps that was constructed with it) to the
+  // `create' function of its binding.
+  using SharedSingletonCreateMap =
+      HashMapWithArenaAllocator<TypeId, ComponentStorageEntry::BindingForObjectToConstruct::create_t>;
+
 private:
   // A graph with types as nodes (each node stores the BindingData for the type) and dependencies as edges.
   // For types that have a constructed object already, the corresponding node is stored as terminal node.
   SemistaticGraph<TypeId, NormalizedBinding> bindings;
 
   // Maps the type index of a type T to the corresponding NormalizedMultibindingSet.
-  std::unordered_map<TypeId, NormalizedMultibindingSet> multibindings;
+  NormalizedMultibindingSetMap multibindings;
   
   // Contains data on the set of types that can be allocated using this component.
   FixedSizeAllocator::FixedSizeAllocatorData fixed_size_allocator_data;
 
-  // The MemoryPool used to allocate bindingCompressionInfoMap.
+  // The MemoryPool used to allocate bindingCompressionInfoMap and sharedSingletonCreateMap.
   MemoryPool bindingCompressionInfoMapMemoryPool;
 
   // Stores information on binding compression that was performed in bindings of this object.
   // See also the documentation for BindingCompressionInfoMap.
   // We hold this via a unique_ptr to avoid including Boost's hashmap implementation.
   std::unique_ptr<BindingCompressionInfoMap> bindingCompressionInfoMap;
+
+  // The storage that constructed (and owns) the shared singletons, if there are any. Their nodes in `bindings' are
+  // terminal nodes.
+  // This is declared after `bindings' because it must be destroyed first (its graph shares data with `bindings').
+  std::unique_ptr<InjectorStorage> shared_singletons_storage;
+
+  // Their nodes are terminal, but injectors can still contain bindings for these types (e.g. when they're
+  // auto-injected), and those are fine as long as they're the same bindings used to construct the shared objects.
+  // This is nullptr if there are no shared singletons.
+  std::unique_ptr<SharedSingletonCreateMap> sharedSingletonCreateMap;
+
+  // The construction plans of the exposed types (see ConstructionPlans).
+  ConstructionPlans construction_plans;
   
   friend class InjectorStorage;
+
+  using bindings_vector_t = std::vector<ComponentStorageEntry, ArenaAllocator<ComponentStorageEntry>>;
+
+  // Fills construction_plans. `bindings_vector' must contain the bindings in `bindings'.
+  void computeConstructionPlans(
+      const bindings_vector_t& bindings_vector,
+      const std::vector<TypeId, ArenaAllocator<TypeId>>& exposed_types,
+      MemoryPool& memory_pool);
+
+  // Constructs the objects for the types in `shared_types' (and their dependencies) in shared_singletons_storage, and
+  // turns their nodes in `bindings' into terminal nodes. `bindings_vector' must contain the bindings in `bindings'.
+  void constructSharedSingletons(
+      const bindings_vector_t& bindings_vector,
+      const std::vector<TypeId, ArenaAllocator<TypeId>>& shared_types,
+      MemoryPool& memory_pool);
+
+  // Returns the `create' function that was used to construct the shared object for type_id, or nullptr if type_id is
+  // not shared.
+  ComponentStorageEntry::BindingForObjectToConstruct::create_t getSharedSingletonCreate(TypeId type_id) const;
   
 public:
   using Graph = SemistaticGraph<TypeId, NormalizedBinding>;
@@ -86,11 +123,14 @@ public:
   struct WithPermanentCompression {};
 
   /**
+   * The objects for the types in `shared_types' are constructed here, and shared with all injectors created from this
+   * object.
    * The MemoryPool is only used during construction, the constructed object *can* outlive the memory pool.
    */
   NormalizedComponentStorage(
       ComponentStorage&& component,
       const std::vector<TypeId, ArenaAllocator<TypeId>>& exposed_types,
+      const std::vector<TypeId, ArenaAllocator<TypeId>>& shared_types,
       MemoryPool& memory_pool,
       WithUndoableCompression);
 
@@ -48,11 +48,14 @@ public:
   NormalizedComponentStorageHolder() = default;
   
   /**
+   * The objects for the types in `shared_types' are constructed here, and shared with all injectors created from this
+   * object.
    * The MemoryPool is only used during construction, the constructed object *can* outlive the memory pool.
    */
   NormalizedComponentStorageHolder(
       ComponentStorage&& component,
       const std::vector<TypeId, ArenaAllocator<TypeId>>& exposed_types,
+      const std::vector<TypeId, ArenaAllocator<TypeId>>& shared_types,
       MemoryPool& memory_pool,
       WithUndoableCompression);
 
@@ -0,0 +1,42 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_POOLED_PTR_DEFN_H
+#define FRUIT_POOLED_PTR_DEFN_H
+
+#include <fruit/impl/data_structures/object_pool.h>
+#include <fruit/impl/fruit_assert.h>
+
+// Redundant, but makes KDevelop happy.
+#include <fruit/pooled_ptr.h>
+
+namespace fruit {
+
+template <typename C>
+inline PoolDeleter<C>::PoolDeleter(fruit::impl::ObjectPool* pool)
+  : pool(pool) {
+}
+
+template <typename C>
+inline void PoolDeleter<C>::operator()(C* p) const {
+  FruitAssert(pool != nullptr);
+  p->~C();
+  pool->deallocate(p);
+}
+
+} // namespace fruit
+
+#endif // FRUIT_POOLED_PTR_DEFN_H
@@ -0,0 +1,71 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_SPAN_DEFN_H
+#define FRUIT_SPAN_DEFN_H
+
+#include <fruit/impl/fruit_assert.h>
+
+// Redundant, but makes KDevelop happy.
+#include <fruit/span.h>
+
+namespace fruit {
+
+template <typename T>
+inline Span<T>::Span(T* array_begin, std::size_t array_size)
+  : array_begin(array_begin), array_size(array_size) {
+}
+
+template <typename T>
+inline T* Span<T>::begin() const {
+  return array_begin;
+}
+
+template <typename T>
+inline T* Span<T>::end() const {
+  return array_begin + array_size;
+}
+
+template <typename T>
+inline T* Span<T>::data() const {
+  return array_begin;
+}
+
+template <typename T>
+inline std::size_t Span<T>::size() const {
+  return array_size;
+}
+
+template <typename T>
+inline bool Span<T>::empty() const {
+  return array_size == 0;
+}
+
+template <typename T>
+inline T& Span<T>::operator[](std::size_t i) const {
+  FruitAssert(i < array_size);
+  return array_begin[i];
+}
+
+template <typename T>
+inline Span<T>::operator std::vector<typename Span<T>::value_type>() const {
+  return std::vector<value_type>(begin(), end());
+}
+
+} // namespace fruit
+
+
+#endif // FRUIT_SPAN_DEFN_H
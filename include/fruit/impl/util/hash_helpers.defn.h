@@ -69,6 +69,13 @@ inline HashMapWithArenaAllocator<Key, Value> createHashMapWithArenaAllocator(
       std::equal_to<Key>());
 }
 
+template <typename Key, typename Value>
+inline HashMapWithArenaAllocator<Key, Value> createHashMapWithArenaAllocator(
+    size_t capacity, MemoryPool& memory_pool) {
+  return HashMapWithArenaAllocator<Key, Value>(
+      capacity, std::hash<Key>(), std::equal_to<Key>(), ArenaAllocator<std::pair<const Key, Value>>(memory_pool));
+}
+
 template <typename Key, typename Value, typename Hasher, typename EqualityComparator>
 inline HashMapWithArenaAllocator<Key, Value, Hasher, EqualityComparator> createHashMapWithArenaAllocatorAndCustomFunctors(
     MemoryPool& memory_pool, Hasher hasher, EqualityComparator equality_comparator) {
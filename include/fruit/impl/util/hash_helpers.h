@@ -19,6 +19,7 @@
 
 #include <fruit/impl/fruit-config.h>
 #include <fruit/impl/data_structures/arena_allocator.h>
+#include <fruit/impl/data_structures/flat_hash_table.h>
 
 #ifndef IN_FRUIT_CPP_FILE
 // We don't want to include it in public headers to save some compile time.
@@ -40,32 +41,27 @@ namespace impl {
 template <typename T, typename Hasher = std::hash<T>, typename EqualityComparator = std::equal_to<T>>
 using HashSet = boost::unordered_set<T, Hasher, EqualityComparator>;
 
-template <typename T, typename Hasher = std::hash<T>, typename EqualityComparator = std::equal_to<T>>
-using HashSetWithArenaAllocator = boost::unordered_set<T, Hasher, EqualityComparator, ArenaAllocator<T>>;
-
 template <typename Key, typename Value, typename Hasher = std::hash<Key>>
 using HashMap = boost::unordered_map<Key, Value, Hasher>;
 
-template <typename Key, typename Value, typename Hasher = std::hash<Key>, typename EqualityComparator = std::equal_to<Key>>
-using HashMapWithArenaAllocator =
-    boost::unordered_map<Key, Value, Hasher, EqualityComparator, ArenaAllocator<std::pair<const Key, Value>>>;
-
 #else
 template <typename T, typename Hasher = std::hash<T>, typename EqualityComparator = std::equal_to<T>>
 using HashSet = std::unordered_set<T, Hasher, EqualityComparator>;
 
-template <typename T, typename Hasher = std::hash<T>, typename EqualityComparator = std::equal_to<T>>
-using HashSetWithArenaAllocator = std::unordered_set<T, Hasher, EqualityComparator, ArenaAllocator<T>>;
-
 template <typename Key, typename Value, typename Hasher = std::hash<Key>>
 using HashMap = std::unordered_map<Key, Value, Hasher>;
 
-template <typename Key, typename Value, typename Hasher = std::hash<Key>, typename EqualityComparator = std::equal_to<Key>>
-using HashMapWithArenaAllocator =
-    std::unordered_map<Key, Value, Hasher, EqualityComparator, ArenaAllocator<std::pair<const Key, Value>>>;
-
 #endif
 
+// The containers used during binding normalization. These are flat open-addressing tables backed by a MemoryPool, so
+// inserting an element doesn't allocate unless the table needs to grow. See FlatHashTable for the differences from
+// std::unordered_{set,map}.
+template <typename T, typename Hasher = std::hash<T>, typename EqualityComparator = std::equal_to<T>>
+using HashSetWithArenaAllocator = FlatHashSet<T, Hasher, EqualityComparator>;
+
+template <typename Key, typename Value, typename Hasher = std::hash<Key>, typename EqualityComparator = std::equal_to<Key>>
+using HashMapWithArenaAllocator = FlatHashMap<Key, Value, Hasher, EqualityComparator>;
+
 template <typename T>
 HashSet<T> createHashSet();
 
@@ -88,6 +84,9 @@ HashMap<Key, Value> createHashMap(size_t capacity);
 template <typename Key, typename Value>
 HashMapWithArenaAllocator<Key, Value> createHashMapWithArenaAllocator(MemoryPool& memory_pool);
 
+template <typename Key, typename Value>
+HashMapWithArenaAllocator<Key, Value> createHashMapWithArenaAllocator(size_t capacity, MemoryPool& memory_pool);
+
 template <typename Key, typename Value, typename Hasher, typename EqualityComparator>
 HashMapWithArenaAllocator<Key, Value, Hasher, EqualityComparator> createHashMapWithArenaAllocatorAndCustomFunctors(
     MemoryPool& memory_pool, Hasher, EqualityComparator);
@@ -32,9 +32,9 @@ template <typename T, bool is_abstract = std::is_abstract<T>::value>
 struct GetConcreteTypeInfo {
   constexpr TypeInfo::ConcreteTypeInfo operator()() const {
     return TypeInfo::ConcreteTypeInfo{
-        sizeof(T),
-        alignof(T),
-        std::is_trivially_destructible<T>::value,
+        AllocationSizeAndAlignment<T>::size,
+        AllocationSizeAndAlignment<T>::alignment,
+        std::is_trivially_destructible<T>::value || fruit::ProcessLifetime<T>::value,
 #ifdef FRUIT_EXTRA_DEBUG
         false /* is_abstract */,
 #endif
@@ -151,7 +151,7 @@ template <typename L>
 struct GetTypeIdsForListHelper;
 
 template <typename... Ts>
-struct GetTypeIdsForListHelper<fruit::impl::meta::Vector<Ts...>> {
+struct GetTypeIdsForListHelper<fruit::impl::meta::Vector<fruit::impl::meta::Type<Ts>...>> {
   std::vector<TypeId, ArenaAllocator<TypeId>> operator()(MemoryPool& memory_pool) {
     return std::vector<TypeId, ArenaAllocator<TypeId>>(
         std::initializer_list<TypeId>{getTypeId<Ts>()...},
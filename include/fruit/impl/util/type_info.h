@@ -18,6 +18,8 @@
 #define FRUIT_TYPE_INFO_H
 
 #include <typeinfo>
+#include <fruit/fruit_forward_decls.h>
+#include <fruit/impl/fruit-config.h>
 #include <fruit/impl/util/demangle_type_name.h>
 #include <fruit/impl/meta/vector.h>
 
@@ -27,13 +29,16 @@ namespace fruit {
 namespace impl {
 
 // Similar to std::type_index, but with a constexpr constructor and also storing the type size and alignment.
-// Also guaranteed to be aligned, to allow storing a TypeInfo and 1 bit together in the size of a void*.
-struct alignas(1) alignas(void*) TypeInfo {
+// Also guaranteed to be aligned to (at least) 32 bytes, to allow storing a TypeInfo* and a few bits (e.g. the Kind of a
+// ComponentStorageEntry) together in the size of a void*. This doesn't waste memory, a TypeInfo is 32 bytes anyway on
+// 64-bit platforms.
+struct alignas(32) TypeInfo {
 
   struct ConcreteTypeInfo {
     // These fields are allowed to have dummy values for abstract types.
     std::size_t type_size;
     std::size_t type_alignment;
+    // Also true for the types marked with fruit::ProcessLifetime, since injectors never destroy those.
     bool is_trivially_destructible;
 
 #ifdef FRUIT_EXTRA_DEBUG
@@ -71,6 +76,18 @@ struct TypeId {
   bool operator<(TypeId x) const;
 };
 
+// The size and alignment that injectors use to allocate an object of type T (that must not be abstract).
+// These are sizeof(T) and alignof(T), except for types marked with fruit::IsolatedInCacheLine: those are aligned to
+// (at least) a cache line, and their size is rounded up so that the next object starts on a different cache line.
+template <typename T>
+struct AllocationSizeAndAlignment {
+  static constexpr bool is_isolated = fruit::IsolatedInCacheLine<T>::value;
+  static constexpr std::size_t alignment =
+      (is_isolated && alignof(T) < FRUIT_CACHE_LINE_SIZE) ? FRUIT_CACHE_LINE_SIZE : alignof(T);
+  static constexpr std::size_t size =
+      is_isolated ? (sizeof(T) + alignment - 1) / alignment * alignment : sizeof(T);
+};
+
 // Returns the TypeId for the type T.
 // Multiple invocations for the same type return the same value.
 // This has special support for types of the form Annotated<SomeAnnotation, SomeType>, it reports
@@ -23,6 +23,11 @@
 #include <fruit/component.h>
 #include <fruit/provider.h>
 #include <fruit/normalized_component.h>
+#include <fruit/memory_resource.h>
+#include <fruit/span.h>
+
+#include <tuple>
+#include <vector>
 
 namespace fruit {
 
@@ -57,6 +62,10 @@ public:
   
   // Copying injectors is forbidden.
   Injector(const Injector&) = delete;
+
+  // Destroys the objects constructed by this injector, in reverse construction order. See setProcessLifetime() for an
+  // exception.
+  ~Injector();
   
   /**
    * Creation of an injector from a component function (that can optionally have parameters).
@@ -117,6 +126,52 @@ public:
   Injector(NormalizedComponent<NormalizedComponentParams...>&& normalized_component, 
            Component<ComponentParams...>(*)(FormalArgs...), Args&&... args) = delete;
   
+  /**
+   * Similar to the constructors above, but all the memory needed by this injector is allocated from `memory_resource'
+   * instead of using the global operator new (see MemoryResource for details). E.g.:
+   *
+   * Injector<Foo, Bar> injector(request_arena, normalizedComponent, getRequestComponent, &request);
+   *
+   * The MemoryResource must outlive the injector.
+   */
+  template <typename... FormalArgs, typename... Args>
+  Injector(MemoryResource& memory_resource, Component<P...>(*)(FormalArgs...), Args&&... args);
+
+  template <typename... NormalizedComponentParams, typename... ComponentParams, typename... FormalArgs, typename... Args>
+  Injector(MemoryResource& memory_resource,
+           const NormalizedComponent<NormalizedComponentParams...>& normalized_component,
+           Component<ComponentParams...>(*)(FormalArgs...), Args&&... args);
+
+  template <typename... NormalizedComponentParams, typename... ComponentParams, typename... FormalArgs, typename... Args>
+  Injector(MemoryResource& memory_resource,
+           NormalizedComponent<NormalizedComponentParams...>&& normalized_component,
+           Component<ComponentParams...>(*)(FormalArgs...), Args&&... args) = delete;
+
+  /**
+   * Similar to the constructors above, but the storage for the objects constructed by this injector is allocated in
+   * small chunks as the objects are constructed, instead of allocating upfront the space for all the types that the
+   * injector could construct. E.g.:
+   *
+   * Injector<Foo, Bar> injector(fruit::LazyObjectStorage(), normalizedComponent, getRequestComponent, &request);
+   *
+   * This reduces the memory used by injectors that only construct a few of the types bound in their components (e.g. when
+   * using a large NormalizedComponent for many short-lived injectors that each only get() a small part of it), at the cost
+   * of a few more allocations for injectors that construct most of them.
+   * The constructed objects never move, so pointers to them remain valid for the lifetime of the injector (as usual).
+   */
+  template <typename... FormalArgs, typename... Args>
+  Injector(LazyObjectStorage, Component<P...>(*)(FormalArgs...), Args&&... args);
+
+  template <typename... NormalizedComponentParams, typename... ComponentParams, typename... FormalArgs, typename... Args>
+  Injector(LazyObjectStorage,
+           const NormalizedComponent<NormalizedComponentParams...>& normalized_component,
+           Component<ComponentParams...>(*)(FormalArgs...), Args&&... args);
+
+  template <typename... NormalizedComponentParams, typename... ComponentParams, typename... FormalArgs, typename... Args>
+  Injector(LazyObjectStorage,
+           NormalizedComponent<NormalizedComponentParams...>&& normalized_component,
+           Component<ComponentParams...>(*)(FormalArgs...), Args&&... args) = delete;
+  
   /**
    * Returns an instance of the specified type. For any class C in the Injector's template parameters, the following variations
    * are allowed:
@@ -144,6 +199,19 @@ public:
    */
   template <typename T>
   RemoveAnnotations<T> get();
+
+  /**
+   * Returns a tuple with an instance of each of the specified types, e.g.:
+   *
+   * std::tuple<Foo*, Bar&, fruit::Provider<Baz>> t = injector.getAll<Foo*, Bar&, fruit::Provider<Baz>>();
+   *
+   * Each T can be any of the variations allowed by get(), and the result is the same as calling get<T>() for each T.
+   * This is faster than multiple get() calls: the types are looked up together (so that the memory accesses of the
+   * lookups can overlap) and the objects that are not constructed yet are all constructed before returning.
+   * As with get(), types requested as a Provider are not constructed.
+   */
+  template <typename... T>
+  std::tuple<RemoveAnnotations<T>...> getAll();
   
   /**
    * This is a convenient way to call get(). E.g.:
@@ -176,6 +244,17 @@ public:
    */
   template <typename T>
   const std::vector<RemoveAnnotations<T>*>& getMultibindings();
+
+  /**
+   * Same as getMultibindings(), but returns a fruit::Span of T* elements (or of SomeClass* elements, for an annotated
+   * T=Annotated<Annotation, SomeClass>) instead of a vector. This returns an empty span if there are no multibindings.
+   *
+   * This avoids the heap allocation of the vector: the span refers to a pointer array that is stored in the injector
+   * and sized when the injector is created, so it remains valid (and doesn't change) for the whole lifetime of the
+   * injector.
+   */
+  template <typename T>
+  Span<RemoveAnnotations<T>* const> getMultibindingsSpan();
   
   /**
    * Eagerly injects all reachable bindings and multibindings of this injector.
@@ -193,6 +272,88 @@ public:
    * unless it has been called before on the same injector and returned.
    */
   void eagerlyInjectAll();
+
+  /**
+   * Marks this injector as living until the end of the process, e.g. for the main injector of an application.
+   * When a process-lifetime injector is destroyed, it doesn't destroy its objects nor free its storage: all of that is
+   * intentionally leaked, since the process is about to exit anyway. This avoids running the destructors of thousands
+   * of singletons at shutdown when they only free memory.
+   *
+   * Objects that must still be destroyed at exit (e.g. because their destructor flushes a file) can be opted in by
+   * specializing fruit::RunDestructorAtExit for their type:
+   *
+   * namespace fruit {
+   * template <>
+   * struct RunDestructorAtExit<LogWriter> : public std::true_type {};
+   * }
+   *
+   * Those objects are destroyed (in reverse construction order) when the injector is destroyed, as usual.
+   *
+   * To leak the objects of some types in any injector, specialize fruit::ProcessLifetime instead (see PartialComponent).
+   */
+  void setProcessLifetime();
+
+  /**
+   * Creates a child injector, that exposes the types ChildP... .
+   *
+   * The child's bindings come from the component returned by getComponent(args...). That component can require
+   * (e.g. with fruit::Required<Foo>) any of the types P... provided by this injector, and the child can also expose
+   * some of the types P... directly.
+   * The objects provided by this injector are shared with the child (and with any other child of this injector): the
+   * child only allocates and constructs the objects bound in its own component. So creating a child for each request
+   * only costs as much as the request-scoped objects, no matter how many singletons they depend on.
+   *
+   * The objects of this injector that the child needs are constructed (if they weren't already) when the child is
+   * created, and the child accesses them in read-only mode. When creating children from multiple threads
+   * concurrently, call eagerlyInjectAll() on this injector first.
+   *
+   * Multibindings are not merged: for each type T, getMultibindings<T>() on the child returns the multibindings of T
+   * in the child's component if there are any, otherwise the ones in this injector.
+   *
+   * This injector must outlive the child.
+   *
+   * Note that a PartialComponent<...> can NOT be used as argument, so if the component is defined inline it must be
+   * explicitly casted to the desired Component<...> type.
+   *
+   * Example usage:
+   *
+   * // In the global scope.
+   * Component<Required<Bar>, Foo> getRequestComponent(Request* request) {
+   *   return fruit::createComponent()
+   *       .bindInstance(*request)
+   *       .registerConstructor<Foo(Request&, Bar&)>();
+   * }
+   *
+   * // At startup (e.g. inside main()).
+   * Injector<Bar> injector(getBarComponent);
+   *
+   * ...
+   * for (...) {
+   *   // For each request.
+   *   Request request = ...;
+   *
+   *   Injector<Foo> request_injector = injector.createChild<Foo>(getRequestComponent, &request);
+   *   Foo* foo = request_injector.get<Foo*>();
+   *   ...
+   * }
+   *
+   * The memory needed by the child injector is allocated from the MemoryResource of this injector (or using the global
+   * operator new, if this injector doesn't use one).
+   */
+  template <typename... ChildP, typename... ComponentParams, typename... FormalArgs, typename... Args>
+  Injector<ChildP...> createChild(Component<ComponentParams...>(*getComponent)(FormalArgs...), Args&&... args);
+
+  /**
+   * Similar to the createChild() above, but the memory needed by the child injector is allocated from
+   * `memory_resource' instead, e.g. to put the child injectors created for each request in a per-request arena:
+   *
+   * Injector<Foo> request_injector = injector.createChild<Foo>(request_arena, getRequestComponent, &request);
+   *
+   * The MemoryResource must outlive the child injector.
+   */
+  template <typename... ChildP, typename... ComponentParams, typename... FormalArgs, typename... Args>
+  Injector<ChildP...> createChild(MemoryResource& memory_resource,
+                                  Component<ComponentParams...>(*getComponent)(FormalArgs...), Args&&... args);
   
 private:
   using Check1 = typename fruit::impl::meta::CheckIfError<fruit::impl::meta::Eval<
@@ -216,6 +377,30 @@ private:
   static_assert(true || sizeof(Check3), "");
 
   friend struct fruit::impl::InjectorAccessorForTests;
+
+  template <typename... OtherP>
+  friend class Injector;
+
+  friend class InjectorReclaimer;
+
+  // Used by createChild().
+  explicit Injector(std::unique_ptr<fruit::impl::InjectorStorage> storage);
+
+  // Used by the public createChild() overloads. `memory_resource' can be nullptr, to use the global operator new.
+  template <typename... ChildP, typename... ComponentParams, typename... FormalArgs, typename... Args>
+  Injector<ChildP...> createChildWithMemoryResource(fruit::MemoryResource* memory_resource,
+                                                    Component<ComponentParams...>(*getComponent)(FormalArgs...),
+                                                    Args&&... args);
+
+  // These are used by the public constructors. The MemoryPool is only used during construction.
+  template <typename... FormalArgs, typename... Args>
+  Injector(fruit::impl::MemoryPool memory_pool, bool lazy_object_storage,
+           Component<P...>(*)(FormalArgs...), Args&&... args);
+
+  template <typename... NormalizedComponentParams, typename... ComponentParams, typename... FormalArgs, typename... Args>
+  Injector(fruit::impl::MemoryPool memory_pool, bool lazy_object_storage,
+           const NormalizedComponent<NormalizedComponentParams...>& normalized_component,
+           Component<ComponentParams...>(*)(FormalArgs...), Args&&... args);
   
   std::unique_ptr<fruit::impl::InjectorStorage> storage;
 };
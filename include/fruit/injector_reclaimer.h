@@ -0,0 +1,118 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_INJECTOR_RECLAIMER_H
+#define FRUIT_INJECTOR_RECLAIMER_H
+
+#include <fruit/fruit_forward_decls.h>
+#include <fruit/impl/fruit_internal_forward_decls.h>
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace fruit {
+
+/**
+ * An InjectorReclaimer destroys injectors in background threads, so that the thread that was using an injector doesn't
+ * have to wait for the destruction of all the objects that the injector constructed (e.g. a server can send the response
+ * to a request before the per-request injector is destroyed).
+ *
+ * Example usage:
+ *
+ * // At startup (e.g. inside main()).
+ * fruit::InjectorReclaimer reclaimer;
+ * ...
+ * for (...) {
+ *   // For each request.
+ *   fruit::Injector<Foo> injector(normalizedComponent, getRequestComponent, &request);
+ *   ...
+ *   reclaimer.reclaim(std::move(injector));
+ * }
+ *
+ * Each injector is destroyed as usual (its objects are destroyed in reverse construction order) but in one of the
+ * reclaimer's threads, so the destructors of the injected objects must be safe to run in a different thread.
+ * With more than 1 thread, different injectors can be destroyed in parallel.
+ *
+ * Anything that an injector refers to must outlive its destruction: e.g. the NormalizedComponent it was created from,
+ * the parent of a child injector, instances bound with bindInstance() and the MemoryResource (if any).
+ * Call waitUntilIdle() (or destroy the reclaimer) before destroying those.
+ */
+class InjectorReclaimer {
+public:
+  /**
+   * Starts num_threads threads (at least 1) that will destroy the injectors passed to reclaim().
+   */
+  explicit InjectorReclaimer(std::size_t num_threads = 1);
+
+  /**
+   * Waits for the destruction of all the injectors passed to reclaim(), then stops the threads.
+   */
+  ~InjectorReclaimer();
+
+  InjectorReclaimer(const InjectorReclaimer&) = delete;
+  InjectorReclaimer(InjectorReclaimer&&) = delete;
+  InjectorReclaimer& operator=(const InjectorReclaimer&) = delete;
+  InjectorReclaimer& operator=(InjectorReclaimer&&) = delete;
+
+  /**
+   * Schedules the destruction of `injector' in one of the reclaimer's threads. The injector is left in a moved-from
+   * state, so it must not be used after this call (but it can be destroyed as usual).
+   * This is thread-safe.
+   */
+  template <typename... P>
+  void reclaim(Injector<P...>&& injector);
+
+  /**
+   * Blocks until all the injectors passed to reclaim() so far have been destroyed.
+   */
+  void waitUntilIdle();
+
+private:
+  std::mutex mutex;
+
+  // Notified when an injector is added to `pending' or when the reclaimer is being destroyed.
+  std::condition_variable work_available;
+
+  // Notified when `pending' becomes empty and no injector is being destroyed.
+  std::condition_variable idle;
+
+  // The injectors that haven't been destroyed yet, in the order they were passed to reclaim().
+  std::deque<std::unique_ptr<fruit::impl::InjectorStorage>> pending;
+
+  // The number of injectors that are being destroyed right now.
+  std::size_t num_in_progress = 0;
+
+  // Set when the reclaimer is being destroyed. The threads exit when this is set and `pending' is empty.
+  bool stopping = false;
+
+  std::vector<std::thread> threads;
+
+  void reclaimStorage(std::unique_ptr<fruit::impl::InjectorStorage> storage);
+
+  // The loop executed by each of the threads.
+  void run();
+};
+
+} // namespace fruit
+
+#include <fruit/impl/injector_reclaimer.defn.h>
+
+#endif // FRUIT_INJECTOR_RECLAIMER_H
@@ -0,0 +1,74 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef FRUIT_MEMORY_RESOURCE_H
+#define FRUIT_MEMORY_RESOURCE_H
+
+#include <cstddef>
+
+namespace fruit {
+
+/**
+ * An interface for a source of memory, similar to C++17's std::pmr::memory_resource.
+ *
+ * By default, injectors and normalized components allocate memory with the global operator new. If a MemoryResource is
+ * passed to the constructor of an Injector or of a NormalizedComponent, all the memory that it needs (the injected
+ * objects and their destruction lists, the binding graph, the multibinding data and the temporary data used to normalize
+ * the bindings) is allocated from that MemoryResource instead. Child injectors (see Injector::createChild) use the
+ * MemoryResource of their parent, unless a different one is passed to createChild(). The bindings of the components
+ * themselves, the small Injector/NormalizedComponent bookkeeping objects and the vectors returned by
+ * Injector::getMultibindings() are still allocated with operator new (Injector::getMultibindingsSpan() doesn't allocate).
+ * For example, this can be used to put the injectors created for each request in a per-request arena, or to allocate
+ * them in huge pages or in NUMA-local memory.
+ *
+ * Example usage:
+ *
+ * class ArenaMemoryResource : public fruit::MemoryResource {
+ * public:
+ *   void* allocate(std::size_t bytes, std::size_t alignment) override {...}
+ *   void deallocate(void* p, std::size_t bytes, std::size_t alignment) override {...}
+ * };
+ *
+ * ArenaMemoryResource arena;
+ * fruit::Injector<Foo> injector(arena, getFooComponent);
+ *
+ * The MemoryResource must outlive the Injector or NormalizedComponent that uses it. Note that an Injector created from a
+ * NormalizedComponent uses its own MemoryResource (or operator new) for its allocations, not the one of the
+ * NormalizedComponent.
+ * A MemoryResource can be shared by multiple injectors. Each injector only calls it from the thread that is constructing,
+ * using or destroying that injector, so a MemoryResource that's shared by injectors used concurrently must be
+ * thread-safe.
+ */
+class MemoryResource {
+public:
+  virtual ~MemoryResource() = default;
+
+  /**
+   * Allocates at least `bytes' bytes, aligned to `alignment' (that is always a power of 2).
+   * This can throw an exception (e.g. std::bad_alloc) if the memory can't be allocated, but must not return nullptr.
+   */
+  virtual void* allocate(std::size_t bytes, std::size_t alignment) = 0;
+
+  /**
+   * Deallocates the memory in `p', that was previously returned by allocate(bytes, alignment) (with the same arguments).
+   */
+  virtual void deallocate(void* p, std::size_t bytes, std::size_t alignment) = 0;
+};
+
+} // namespace fruit
+
+#endif // FRUIT_MEMORY_RESOURCE_H
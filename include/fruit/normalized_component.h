@@ -24,6 +24,7 @@
 #include <fruit/impl/fruit_internal_forward_decls.h>
 #include <fruit/impl/meta/component.h>
 #include <fruit/impl/normalized_component_storage/normalized_component_storage_holder.h>
+#include <fruit/memory_resource.h>
 #include <memory>
 
 namespace fruit {
@@ -53,6 +54,19 @@ namespace fruit {
  * }
  * 
  * See the 2-argument Injector constructor for more details.
+ *
+ * Some of the types provided by a NormalizedComponent can be marked as shared singletons, passing a
+ * fruit::SharedSingletons<...> as first argument of the constructor. E.g.:
+ *
+ * NormalizedComponent<Required<Request>, Bar, Bar2> normalizedComponent(
+ *     fruit::SharedSingletons<Bar2>(), getBarComponent);
+ *
+ * The objects for those types (and for the types they depend on) are constructed once, when the NormalizedComponent is
+ * constructed, and then shared by all injectors created from it. Those injectors neither construct them again nor
+ * reserve memory for them. This is useful for stateless objects or objects that are otherwise safe to use from
+ * multiple injectors (e.g. configuration objects, codecs or lookup tables).
+ * The shared singletons can't depend (directly or indirectly) on the requirements of the NormalizedComponent, since
+ * those are only bound in each injector. They are destroyed when the NormalizedComponent is destroyed.
  */
 template <typename... Params>
 class NormalizedComponent {
@@ -61,6 +75,24 @@ public:
   // Component<Required<...>, ...>.
   template <typename... FormalArgs, typename... Args>
   NormalizedComponent(Component<Params...>(*)(FormalArgs...), Args&&... args);
+
+  // Similar to the constructor above, but also constructs the objects for the types in SharedTypes... (that must be
+  // provided by this NormalizedComponent) and shares them with all the injectors created from this NormalizedComponent.
+  template <typename... SharedTypes, typename... FormalArgs, typename... Args>
+  NormalizedComponent(SharedSingletons<SharedTypes...>, Component<Params...>(*)(FormalArgs...), Args&&... args);
+
+  // Similar to the constructors above, but all the memory needed by this NormalizedComponent is allocated from
+  // `memory_resource' instead of using the global operator new (see MemoryResource for details). The MemoryResource must
+  // outlive this object. Note that the injectors created from this NormalizedComponent don't use this MemoryResource.
+  template <typename... FormalArgs, typename... Args>
+  NormalizedComponent(MemoryResource& memory_resource, Component<Params...>(*)(FormalArgs...), Args&&... args);
+
+  template <typename... SharedTypes, typename... FormalArgs, typename... Args>
+  NormalizedComponent(
+      MemoryResource& memory_resource,
+      SharedSingletons<SharedTypes...>,
+      Component<Params...>(*)(FormalArgs...),
+      Args&&... args);
   
   NormalizedComponent(NormalizedComponent&&) = default;
   NormalizedComponent(const NormalizedComponent&) = delete;
@@ -71,6 +103,10 @@ public:
 private:
   NormalizedComponent(fruit::impl::ComponentStorage&& storage, fruit::impl::MemoryPool memory_pool);
 
+  template <typename... SharedTypes>
+  NormalizedComponent(
+      SharedSingletons<SharedTypes...>, fruit::impl::ComponentStorage&& storage, fruit::impl::MemoryPool memory_pool);
+
   // This is held via a unique_ptr to avoid including normalized_component_storage.h
   // in fruit.h.
   fruit::impl::NormalizedComponentStorageHolder storage;
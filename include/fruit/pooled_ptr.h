@@ -0,0 +1,86 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_POOLED_PTR_H
+#define FRUIT_POOLED_PTR_H
+
+#include <fruit/fruit_forward_decls.h>
+#include <fruit/impl/fruit_internal_forward_decls.h>
+
+#include <memory>
+
+namespace fruit {
+
+/**
+ * The deleter of a PooledPtr<C>. It destroys the C object and returns its memory to the pool that it was allocated from.
+ */
+template <typename C>
+class PoolDeleter {
+public:
+  /**
+   * Constructs a deleter that's not associated to any pool. This is only meant to be used for null PooledPtr objects.
+   */
+  PoolDeleter() = default;
+
+  void operator()(C* p) const;
+
+private:
+  // The pool that owns the memory of the object. This is NOT owned by the PoolDeleter.
+  fruit::impl::ObjectPool* pool = nullptr;
+
+  explicit PoolDeleter(fruit::impl::ObjectPool* pool);
+
+  friend class fruit::impl::InjectorStorage;
+};
+
+/**
+ * A PooledPtr<C> is a std::unique_ptr<C> whose memory comes from an object pool owned by the injector, instead of being
+ * allocated with new.
+ *
+ * When a std::function<fruit::PooledPtr<C>(Args...)> (or a fruit::FactoryRef<fruit::PooledPtr<C>(Args...)>) is
+ * injected, Fruit automatically binds it using the std::function<C(Args...)> factory of C, that can be registered with
+ * registerFactory() or with an Inject typedef / INJECT macro with assisted parameters. E.g.:
+ *
+ * class Foo {
+ * public:
+ *   INJECT(Foo(Bar* bar, ASSISTED(int) n));
+ * };
+ *
+ * class Baz {
+ * public:
+ *   INJECT(Baz(std::function<fruit::PooledPtr<Foo>(int)> fooFactory)) {
+ *     fruit::PooledPtr<Foo> foo = fooFactory(42);
+ *     ...
+ *   }
+ * };
+ *
+ * Each such factory has its own pool, so objects that are created and destroyed repeatedly (e.g. once per request)
+ * reuse the same memory instead of calling malloc/free each time.
+ *
+ * Note that:
+ * - The pool is owned by the injector, so all PooledPtr objects must be destroyed before the injector.
+ * - The pool is not thread-safe: the objects created by the same factory must not be created or destroyed concurrently
+ *   from multiple threads.
+ * - C must be a concrete class. A PooledPtr<C> can't be converted to a PooledPtr<I> for a base class I of C.
+ */
+template <typename C>
+using PooledPtr = std::unique_ptr<C, PoolDeleter<C>>;
+
+} // namespace fruit
+
+#include <fruit/impl/pooled_ptr.defn.h>
+
+#endif // FRUIT_POOLED_PTR_H
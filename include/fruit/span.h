@@ -0,0 +1,71 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRUIT_SPAN_H
+#define FRUIT_SPAN_H
+
+#include <fruit/fruit_forward_decls.h>
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace fruit {
+
+/**
+ * A non-owning view over a contiguous array of T objects, e.g. the one returned by Injector::getMultibindingsSpan().
+ * The storage must outlive the span (and any copy of it).
+ */
+template <typename T>
+class Span {
+private:
+  T* array_begin = nullptr;
+  std::size_t array_size = 0;
+
+public:
+  using value_type = typename std::remove_cv<T>::type;
+  using iterator = T*;
+  using const_iterator = T*;
+
+  // Constructs an empty span.
+  Span() = default;
+
+  Span(T* array_begin, std::size_t array_size);
+
+  Span(const Span&) = default;
+  Span& operator=(const Span&) = default;
+
+  T* begin() const;
+  T* end() const;
+
+  T* data() const;
+
+  std::size_t size() const;
+  bool empty() const;
+
+  T& operator[](std::size_t i) const;
+
+  // Copies the elements into a new vector.
+  // This is mostly for compatibility with code that expects a std::vector.
+  operator std::vector<value_type>() const;
+};
+
+} // namespace fruit
+
+#include <fruit/impl/span.defn.h>
+
+
+#endif // FRUIT_SPAN_H
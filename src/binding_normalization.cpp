@@ -43,10 +43,10 @@ void BindingNormalization::printLazyComponentInstallationLoop(
   std::cerr << "Found a loop while expanding components passed to PartialComponent::install()." << std::endl;
   std::cerr << "Component installation trace (from top-level to the most deeply-nested):" << std::endl;
   for (const ComponentStorageEntry& entry : entries_to_process) {
-    switch (entry.kind) {
+    switch (entry.getKind()) {
     case ComponentStorageEntry::Kind::COMPONENT_WITH_ARGS_END_MARKER:
-      if (entry.type_id == last_entry.type_id
-          && last_entry.kind == ComponentStorageEntry::Kind::LAZY_COMPONENT_WITH_ARGS
+      if (entry.getTypeId() == last_entry.getTypeId()
+          && last_entry.getKind() == ComponentStorageEntry::Kind::LAZY_COMPONENT_WITH_ARGS
           && *entry.lazy_component_with_args.component == *last_entry.lazy_component_with_args.component) {
         std::cerr << "<-- The loop starts here" << std::endl;
       }
@@ -54,12 +54,12 @@ void BindingNormalization::printLazyComponentInstallationLoop(
       break;
 
     case ComponentStorageEntry::Kind::COMPONENT_WITHOUT_ARGS_END_MARKER:
-      if (entry.type_id == last_entry.type_id
-          && last_entry.kind == ComponentStorageEntry::Kind::LAZY_COMPONENT_WITH_NO_ARGS
+      if (entry.getTypeId() == last_entry.getTypeId()
+          && last_entry.getKind() == ComponentStorageEntry::Kind::LAZY_COMPONENT_WITH_NO_ARGS
           && entry.lazy_component_with_no_args.erased_fun == last_entry.lazy_component_with_no_args.erased_fun) {
         std::cerr << "<-- The loop starts here" << std::endl;
       }
-      std::cerr << std::string(entry.type_id) << std::endl;
+      std::cerr << std::string(entry.getTypeId()) << std::endl;
       break;
 
     default:
@@ -67,13 +67,13 @@ void BindingNormalization::printLazyComponentInstallationLoop(
     }
   }
 
-  switch (last_entry.kind) { // LCOV_EXCL_BR_LINE
+  switch (last_entry.getKind()) { // LCOV_EXCL_BR_LINE
   case ComponentStorageEntry::Kind::LAZY_COMPONENT_WITH_ARGS:
     std::cerr << std::string(last_entry.lazy_component_with_args.component->getFunTypeId()) << std::endl;
     break;
 
   case ComponentStorageEntry::Kind::LAZY_COMPONENT_WITH_NO_ARGS:
-    std::cerr << std::string(last_entry.type_id) << std::endl;
+    std::cerr << std::string(last_entry.getTypeId()) << std::endl;
     break;
 
   default:
@@ -103,7 +103,7 @@ void BindingNormalization::printIncompatibleComponentReplacementsError(
   using fun_t = void(*)();
 
   fun_t replaced_fun_address;
-  switch (replaced_component_entry.kind) {
+  switch (replaced_component_entry.getKind()) {
   case ComponentStorageEntry::Kind::REPLACED_LAZY_COMPONENT_WITH_ARGS:
     replaced_fun_address = replaced_component_entry.lazy_component_with_args.component->erased_fun;
     break;
@@ -117,7 +117,7 @@ void BindingNormalization::printIncompatibleComponentReplacementsError(
   }
 
   fun_t replacement_fun_address1;
-  switch (replacement_component_entry1.kind) {
+  switch (replacement_component_entry1.getKind()) {
   case ComponentStorageEntry::Kind::REPLACEMENT_LAZY_COMPONENT_WITH_ARGS:
     replacement_fun_address1 = replacement_component_entry1.lazy_component_with_args.component->erased_fun;
     break;
@@ -131,7 +131,7 @@ void BindingNormalization::printIncompatibleComponentReplacementsError(
   }
 
   fun_t replacement_fun_address2;
-  switch (replacement_component_entry2.kind) {
+  switch (replacement_component_entry2.getKind()) {
   case ComponentStorageEntry::Kind::REPLACEMENT_LAZY_COMPONENT_WITH_ARGS:
     replacement_fun_address2 = replacement_component_entry2.lazy_component_with_args.component->erased_fun;
     break;
@@ -148,20 +148,20 @@ void BindingNormalization::printIncompatibleComponentReplacementsError(
   if (function_pointers_have_same_size) {
     std::cerr << "Fatal injection error: the component function at "
               << reinterpret_cast<void*>(replaced_fun_address)
-              << " with signature " << std::string(replaced_component_entry.type_id)
+              << " with signature " << std::string(replaced_component_entry.getTypeId())
               << " was replaced (using .replace(...).with(...)) with both the component function at "
               << reinterpret_cast<void *>(replacement_fun_address1) << " with signature "
-              << std::string(replacement_component_entry1.type_id)
+              << std::string(replacement_component_entry1.getTypeId())
               << " and the component function at " << reinterpret_cast<void *>(replacement_fun_address2)
               << " with signature "
-              << std::string(replacement_component_entry2.type_id) << " ." << std::endl;
+              << std::string(replacement_component_entry2.getTypeId()) << " ." << std::endl;
   } else {
     std::cerr << "Fatal injection error: a component function with signature "
-              << std::string(replaced_component_entry.type_id)
+              << std::string(replaced_component_entry.getTypeId())
               << " was replaced (using .replace(...).with(...)) with both a component function with signature "
-              << std::string(replacement_component_entry1.type_id)
+              << std::string(replacement_component_entry1.getTypeId())
               << " and another component function with signature "
-              << std::string(replacement_component_entry2.type_id) << " ." << std::endl;
+              << std::string(replacement_component_entry2.getTypeId()) << " ." << std::endl;
   }
   exit(1);
 }
@@ -172,7 +172,7 @@ void BindingNormalization::printComponentReplacementFailedBecauseTargetAlreadyEx
   using fun_t = void(*)();
 
   fun_t replaced_fun_address;
-  switch (replaced_component_entry.kind) {
+  switch (replaced_component_entry.getKind()) {
   case ComponentStorageEntry::Kind::REPLACED_LAZY_COMPONENT_WITH_ARGS:
     replaced_fun_address = replaced_component_entry.lazy_component_with_args.component->erased_fun;
     break;
@@ -186,7 +186,7 @@ void BindingNormalization::printComponentReplacementFailedBecauseTargetAlreadyEx
   }
 
   fun_t replacement_fun_address1;
-  switch (replacement_component_entry.kind) {
+  switch (replacement_component_entry.getKind()) {
   case ComponentStorageEntry::Kind::REPLACEMENT_LAZY_COMPONENT_WITH_ARGS:
     replacement_fun_address1 = replacement_component_entry.lazy_component_with_args.component->erased_fun;
     break;
@@ -203,17 +203,17 @@ void BindingNormalization::printComponentReplacementFailedBecauseTargetAlreadyEx
   if (function_pointers_have_same_size) {
     std::cerr << "Fatal injection error: unable to replace (using .replace(...).with(...)) the component function at "
               << reinterpret_cast<void*>(replaced_fun_address)
-              << " with signature " << std::string(replaced_component_entry.type_id)
+              << " with signature " << std::string(replaced_component_entry.getTypeId())
               << " with the component function at "
               << reinterpret_cast<void*>(replacement_fun_address1) << " with signature "
-              << std::string(replacement_component_entry.type_id)
+              << std::string(replacement_component_entry.getTypeId())
               << " because the former component function was installed before the .replace(...).with(...)." << std::endl
               << "You should change the order of installation of subcomponents so that .replace(...).with(...) is "
               << "processed before the installation of the component to replace.";
   } else {
     std::cerr << "Fatal injection error: unable to replace (using .replace(...).with(...)) a component function with "
-              << "signature " << std::string(replaced_component_entry.type_id)
-              << " with a component function at with signature " << std::string(replacement_component_entry.type_id)
+              << "signature " << std::string(replaced_component_entry.getTypeId())
+              << " with a component function at with signature " << std::string(replacement_component_entry.getTypeId())
               << " because the former component function was installed before the .replace(...).with(...)." << std::endl
               << "You should change the order of installation of subcomponents so that .replace(...).with(...) is "
               << "processed before the installation of the component to replace.";
@@ -222,8 +222,7 @@ void BindingNormalization::printComponentReplacementFailedBecauseTargetAlreadyEx
 
 }
 
-void BindingNormalization::addMultibindings(std::unordered_map<TypeId, NormalizedMultibindingSet>&
-                                                multibindings,
+void BindingNormalization::addMultibindings(NormalizedMultibindingSetMap& multibindings,
                                             FixedSizeAllocator::FixedSizeAllocatorData& fixed_size_allocator_data,
                                             const multibindings_vector_t& multibindingsVector) {
 
@@ -235,16 +234,24 @@ void BindingNormalization::addMultibindings(std::unordered_map<TypeId, Normalize
     const ComponentStorageEntry& multibinding_entry = i->first;
     const ComponentStorageEntry& multibinding_vector_creator_entry = i->second;
     FruitAssert(
-        multibinding_entry.kind == ComponentStorageEntry::Kind::MULTIBINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_NO_ALLOCATION
-        || multibinding_entry.kind == ComponentStorageEntry::Kind::MULTIBINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_ALLOCATION
-        || multibinding_entry.kind == ComponentStorageEntry::Kind::MULTIBINDING_FOR_CONSTRUCTED_OBJECT);
-    FruitAssert(multibinding_vector_creator_entry.kind == ComponentStorageEntry::Kind::MULTIBINDING_VECTOR_CREATOR);
-    NormalizedMultibindingSet& b = multibindings[multibinding_entry.type_id];
+        multibinding_entry.getKind() == ComponentStorageEntry::Kind::MULTIBINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_NO_ALLOCATION
+        || multibinding_entry.getKind() == ComponentStorageEntry::Kind::MULTIBINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_ALLOCATION
+        || multibinding_entry.getKind() == ComponentStorageEntry::Kind::MULTIBINDING_FOR_CONSTRUCTED_OBJECT);
+    FruitAssert(multibinding_vector_creator_entry.getKind() == ComponentStorageEntry::Kind::MULTIBINDING_VECTOR_CREATOR);
+    auto multibindings_itr = multibindings.find(multibinding_entry.getTypeId());
+    if (multibindings_itr == multibindings.end()) {
+      // First multibinding for this type, we'll need an array (of pointers) in the injector to store the results.
+      fixed_size_allocator_data.addPointerArray();
+      multibindings_itr = multibindings.emplace(
+          multibinding_entry.getTypeId(), NormalizedMultibindingSet(multibindings.get_allocator())).first;
+    }
+    NormalizedMultibindingSet& b = multibindings_itr->second;
+    fixed_size_allocator_data.addPointerArrayElement();
 
     // Might be set already, but we need to set it if there was no multibinding for this type.
     b.get_multibindings_vector = multibinding_vector_creator_entry.multibinding_vector_creator.get_multibindings_vector;
 
-    switch (i->first.kind) { // LCOV_EXCL_BR_LINE
+    switch (i->first.getKind()) { // LCOV_EXCL_BR_LINE
     case ComponentStorageEntry::Kind::MULTIBINDING_FOR_CONSTRUCTED_OBJECT:
       {
         NormalizedMultibinding normalized_multibinding;
@@ -256,27 +263,130 @@ void BindingNormalization::addMultibindings(std::unordered_map<TypeId, Normalize
 
     case ComponentStorageEntry::Kind::MULTIBINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_NO_ALLOCATION:
       {
-        fixed_size_allocator_data.addExternallyAllocatedType(i->first.type_id);
+        fixed_size_allocator_data.addExternallyAllocatedType(i->first.getTypeId());
         NormalizedMultibinding normalized_multibinding;
         normalized_multibinding.is_constructed = false;
-        normalized_multibinding.create = i->first.multibinding_for_object_to_construct.create;
+        normalized_multibinding.create = i->first.multibinding_for_object_to_construct.data->create;
         b.elems.push_back(std::move(normalized_multibinding));
       }
       break;
 
     case ComponentStorageEntry::Kind::MULTIBINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_ALLOCATION:
       {
-        fixed_size_allocator_data.addType(i->first.type_id);
+        fixed_size_allocator_data.addType(i->first.getTypeId());
         NormalizedMultibinding normalized_multibinding;
         normalized_multibinding.is_constructed = false;
-        normalized_multibinding.create = i->first.multibinding_for_object_to_construct.create;
+        normalized_multibinding.create = i->first.multibinding_for_object_to_construct.data->create;
         b.elems.push_back(std::move(normalized_multibinding));
       }
       break;
 
     default:
 #ifdef FRUIT_EXTRA_DEBUG
-      std::cerr << "Unexpected kind: " << (std::size_t)i->first.kind << std::endl;
+      std::cerr << "Unexpected kind: " << (std::size_t)i->first.getKind() << std::endl;
+#endif
+      FRUIT_UNREACHABLE; // LCOV_EXCL_LINE
+    }
+  }
+}
+
+void BindingNormalization::removeUnreachableBindings(
+    HashMapWithArenaAllocator<TypeId, ComponentStorageEntry>& binding_data_map,
+    MemoryPool& memory_pool,
+    const multibindings_vector_t& multibindings_vector,
+    const std::vector<TypeId, ArenaAllocator<TypeId>>& exposed_types) {
+
+  HashSetWithArenaAllocator<TypeId> reachable_types =
+      createHashSetWithArenaAllocator<TypeId>(binding_data_map.size(), memory_pool);
+  std::vector<TypeId, ArenaAllocator<TypeId>> types_to_visit =
+      std::vector<TypeId, ArenaAllocator<TypeId>>(
+          exposed_types.begin(), exposed_types.end(), ArenaAllocator<TypeId>(memory_pool));
+
+  // Multibindings can always be retrieved with getMultibindings(), so their dependencies are reachable.
+  for (const std::pair<ComponentStorageEntry, ComponentStorageEntry>& multibinding_entry_pair : multibindings_vector) {
+    const ComponentStorageEntry& entry = multibinding_entry_pair.first;
+    if (entry.getKind() != ComponentStorageEntry::Kind::MULTIBINDING_FOR_CONSTRUCTED_OBJECT) {
+      const BindingDeps* deps = &entry.multibinding_for_object_to_construct.data->deps;
+      FruitAssert(deps != nullptr);
+      types_to_visit.insert(types_to_visit.end(), deps->deps, deps->deps + deps->num_deps);
+    }
+  }
+
+  while (!types_to_visit.empty()) {
+    TypeId type = types_to_visit.back();
+    types_to_visit.pop_back();
+    if (!reachable_types.insert(type).second) {
+      // Already visited.
+      continue;
+    }
+    auto itr = binding_data_map.find(type);
+    FruitAssert(itr != binding_data_map.end());
+    const ComponentStorageEntry& entry = itr->second;
+    if (entry.getKind() != ComponentStorageEntry::Kind::BINDING_FOR_CONSTRUCTED_OBJECT) {
+      const BindingDeps* deps = &entry.binding_for_object_to_construct.data->deps;
+      for (std::size_t i = 0; i < deps->num_deps; ++i) {
+        if (reachable_types.count(deps->deps[i]) == 0) {
+          types_to_visit.push_back(deps->deps[i]);
+        }
+      }
+    }
+  }
+
+  for (auto itr = binding_data_map.begin(); itr != binding_data_map.end(); ) {
+    if (reachable_types.count(itr->first) == 0) {
+#ifdef FRUIT_EXTRA_DEBUG
+      std::cout << "InjectorStorage: removing the binding for " << itr->first << " because it's unreachable." << std::endl;
+#endif
+      itr = binding_data_map.erase(itr);
+    } else {
+      ++itr;
+    }
+  }
+}
+
+BindingNormalization::BindingArrays::BindingArrays(
+    const HashMapWithArenaAllocator<TypeId, ComponentStorageEntry>& binding_data_map, MemoryPool& memory_pool)
+  : kinds(ArenaAllocator<ComponentStorageEntry::Kind>(memory_pool)),
+    type_ids(ArenaAllocator<TypeId>(memory_pool)),
+    deps(ArenaAllocator<const BindingDeps*>(memory_pool)) {
+  kinds.reserve(binding_data_map.size());
+  type_ids.reserve(binding_data_map.size());
+  deps.reserve(binding_data_map.size());
+  for (const auto& binding_data_map_entry : binding_data_map) {
+    const ComponentStorageEntry& entry = binding_data_map_entry.second;
+    kinds.push_back(entry.getKind());
+    type_ids.push_back(binding_data_map_entry.first);
+    if (entry.getKind() == ComponentStorageEntry::Kind::BINDING_FOR_CONSTRUCTED_OBJECT) {
+      deps.push_back(nullptr);
+    } else {
+      deps.push_back(&entry.binding_for_object_to_construct.data->deps);
+    }
+  }
+}
+
+std::size_t BindingNormalization::BindingArrays::size() const {
+  return kinds.size();
+}
+
+void BindingNormalization::addBindingsToFixedSizeAllocatorData(
+    const BindingArrays& binding_arrays,
+    FixedSizeAllocator::FixedSizeAllocatorData& fixed_size_allocator_data) {
+  for (std::size_t i = 0; i < binding_arrays.size(); ++i) {
+    switch (binding_arrays.kinds[i]) { // LCOV_EXCL_BR_LINE
+    case ComponentStorageEntry::Kind::BINDING_FOR_CONSTRUCTED_OBJECT:
+      break;
+
+    case ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_ALLOCATION:
+      fixed_size_allocator_data.addType(binding_arrays.type_ids[i]);
+      break;
+
+    case ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_NO_ALLOCATION:
+      fixed_size_allocator_data.addExternallyAllocatedType(binding_arrays.type_ids[i]);
+      break;
+
+    default:
+#ifdef FRUIT_EXTRA_DEBUG
+      std::cerr << "Unexpected kind: " << (std::size_t)binding_arrays.kinds[i] << std::endl;
 #endif
       FRUIT_UNREACHABLE; // LCOV_EXCL_LINE
     }
@@ -288,8 +398,9 @@ void BindingNormalization::normalizeBindingsWithUndoableBindingCompression(
     FixedSizeAllocator::FixedSizeAllocatorData& fixed_size_allocator_data,
     MemoryPool& memory_pool,
     const std::vector<TypeId, ArenaAllocator<TypeId>>& exposed_types,
+    const std::vector<TypeId, ArenaAllocator<TypeId>>& shared_types,
     std::vector<ComponentStorageEntry, ArenaAllocator<ComponentStorageEntry>>& bindings_vector,
-    std::unordered_map<TypeId, NormalizedMultibindingSet>& multibindings,
+    NormalizedMultibindingSetMap& multibindings,
     BindingCompressionInfoMap& bindingCompressionInfoMap) {
 
   FruitAssert(bindingCompressionInfoMap.empty());
@@ -299,6 +410,8 @@ void BindingNormalization::normalizeBindingsWithUndoableBindingCompression(
       fixed_size_allocator_data,
       memory_pool,
       exposed_types,
+      shared_types,
+      false /* bindings_are_final */,
       bindings_vector,
       multibindings,
       [&bindingCompressionInfoMap](
@@ -314,12 +427,14 @@ void BindingNormalization::normalizeBindingsWithPermanentBindingCompression(
     MemoryPool& memory_pool,
     const std::vector<TypeId, ArenaAllocator<TypeId>>& exposed_types,
     std::vector<ComponentStorageEntry, ArenaAllocator<ComponentStorageEntry>>& bindings_vector,
-    std::unordered_map<TypeId, NormalizedMultibindingSet>& multibindings) {
+    NormalizedMultibindingSetMap& multibindings) {
   normalizeBindingsWithBindingCompression(
       std::move(toplevel_entries),
       fixed_size_allocator_data,
       memory_pool,
       exposed_types,
+      std::vector<TypeId, ArenaAllocator<TypeId>>(ArenaAllocator<TypeId>(memory_pool)) /* shared_types */,
+      true /* bindings_are_final */,
       bindings_vector,
       multibindings,
       [](TypeId, NormalizedComponentStorage::CompressedBindingUndoInfo) {});
@@ -19,20 +19,93 @@
 #include <fruit/impl/data_structures/fixed_size_allocator.h>
 #include <fruit/impl/data_structures/fixed_size_vector.templates.h>
 
+#include <algorithm>
+
+#ifdef FRUIT_EXTRA_DEBUG
+#include <iostream>
+#endif
+
 using namespace fruit::impl;
 
 namespace fruit {
 namespace impl {
 
 FixedSizeAllocator::~FixedSizeAllocator() {
+#ifdef FRUIT_EXTRA_DEBUG
+  printObjectsSharingCacheLines();
+#endif
+
   // Destroy all objects in reverse order.
   std::pair<destroy_t, void*>* p = on_destruction.end();
   while (p != on_destruction.begin()) {
     --p;
     p->first(p->second);
   }
-  delete [] storage_begin;
+  while (last_chunk != nullptr) {
+    ChunkHeader* previous = last_chunk->previous;
+    deallocateFromResource(memory_resource, last_chunk, last_chunk->size, alignof(std::max_align_t));
+    last_chunk = previous;
+  }
+}
+
+void FixedSizeAllocator::runAtExitDestructors() {
+  for (auto i = on_destruction_at_exit.rbegin(), i_end = on_destruction_at_exit.rend(); i != i_end; ++i) {
+    i->first(i->second);
+  }
+  on_destruction_at_exit.clear();
+}
+
+void FixedSizeAllocator::allocateChunk(std::size_t required_space) {
+  if (last_chunk != nullptr) {
+    // The rest of the current chunk is wasted, but we only need to subtract the space that was actually used: the
+    // types constructed so far never use more than the space reserved for them.
+    char* storage_begin = reinterpret_cast<char*>(last_chunk) + CHUNK_HEADER_SIZE;
+    std::size_t used_space = storage_last_used + 1 - storage_begin;
+    FruitAssert(remaining_size >= used_space);
+    remaining_size -= used_space;
+  }
+  
+  // We allocate a bit more than required, so that the next few objects don't each need a chunk of their own, but never
+  // more than what's left of the space reserved for all types (so in the eager case this is exactly total_size).
+  std::size_t storage_size = std::max(required_space, std::min(LAZY_CHUNK_SIZE - CHUNK_HEADER_SIZE, remaining_size));
+  std::size_t chunk_size = CHUNK_HEADER_SIZE + storage_size;
+  
+  ChunkHeader* chunk = reinterpret_cast<ChunkHeader*>(
+      allocateFromResource(memory_resource, chunk_size, alignof(std::max_align_t)));
+  chunk->previous = last_chunk;
+  chunk->size = chunk_size;
+  last_chunk = chunk;
+  
+  char* storage_begin = reinterpret_cast<char*>(chunk) + CHUNK_HEADER_SIZE;
+  // storage_last_used points to the last byte of the header, so that the storage (that's already aligned to
+  // alignof(std::max_align_t)) starts right after it.
+  storage_last_used = storage_begin - 1;
+  storage_end = storage_begin + storage_size;
+}
+
+#ifdef FRUIT_EXTRA_DEBUG
+void FixedSizeAllocator::printObjectsSharingCacheLines() const {
+  // The objects are allocated sequentially, so only consecutive objects can share a cache line.
+  bool first = true;
+  for (std::size_t i = 1; i < constructed_objects.size(); ++i) {
+    const ConstructedObject& previous = constructed_objects[i - 1];
+    const ConstructedObject& current = constructed_objects[i];
+    if (previous.size == 0 || current.size == 0) {
+      continue;
+    }
+    std::uintptr_t previous_last_line = (std::uintptr_t(previous.begin) + previous.size - 1) / FRUIT_CACHE_LINE_SIZE;
+    std::uintptr_t current_first_line = std::uintptr_t(current.begin) / FRUIT_CACHE_LINE_SIZE;
+    if (previous_last_line == current_first_line) {
+      if (first) {
+        std::cerr << "Injected objects that share a cache line (mark the types that are written frequently from "
+                  << "different threads with fruit::IsolatedInCacheLine to avoid false sharing):" << std::endl;
+        first = false;
+      }
+      std::cerr << "  " << previous.type << " and " << current.type << std::endl;
+    }
+  }
 }
+#endif
 
 } // namespace impl
 } // namespace fruit
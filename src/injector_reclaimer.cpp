@@ -0,0 +1,88 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#define IN_FRUIT_CPP_FILE
+
+#include <fruit/injector_reclaimer.h>
+#include <fruit/impl/injector/injector_storage.h>
+
+#include <utility>
+
+namespace fruit {
+
+InjectorReclaimer::InjectorReclaimer(std::size_t num_threads) {
+  if (num_threads == 0) {
+    num_threads = 1;
+  }
+  threads.reserve(num_threads);
+  for (std::size_t i = 0; i < num_threads; ++i) {
+    threads.emplace_back([this]() { run(); });
+  }
+}
+
+InjectorReclaimer::~InjectorReclaimer() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  work_available.notify_all();
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+}
+
+void InjectorReclaimer::reclaimStorage(std::unique_ptr<fruit::impl::InjectorStorage> storage) {
+  if (storage == nullptr) {
+    // The injector was already moved from, there's nothing to destroy.
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    pending.push_back(std::move(storage));
+  }
+  work_available.notify_one();
+}
+
+void InjectorReclaimer::waitUntilIdle() {
+  std::unique_lock<std::mutex> lock(mutex);
+  idle.wait(lock, [this]() { return pending.empty() && num_in_progress == 0; });
+}
+
+void InjectorReclaimer::run() {
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true) {
+    work_available.wait(lock, [this]() { return stopping || !pending.empty(); });
+    if (pending.empty()) {
+      // stopping is true and there's nothing left to destroy.
+      return;
+    }
+    std::unique_ptr<fruit::impl::InjectorStorage> storage = std::move(pending.front());
+    pending.pop_front();
+    ++num_in_progress;
+
+    lock.unlock();
+    fruit::impl::InjectorStorage::destroy(std::move(storage));
+    lock.lock();
+
+    --num_in_progress;
+    if (pending.empty() && num_in_progress == 0) {
+      idle.notify_all();
+    }
+  }
+}
+
+} // namespace fruit
@@ -65,22 +65,34 @@ namespace {
 }
 // LCOV_EXCL_STOP
 
+namespace {
+  // A node of the graph of a NormalizedComponentStorage, together with its type.
+  struct NormalizedBindingItr {
+    NormalizedComponentStorage::Graph::const_node_iterator itr;
+    TypeId type_id;
+  };
+}
+
 InjectorStorage::InjectorStorage(
     ComponentStorage&& component,
     const std::vector<TypeId, ArenaAllocator<TypeId>>& exposed_types,
-    MemoryPool& memory_pool)
+    MemoryPool& memory_pool,
+    bool lazy_object_storage)
   : normalized_component_storage_ptr(
       new NormalizedComponentStorage(
           std::move(component),
           exposed_types,
           memory_pool,
           NormalizedComponentStorage::WithPermanentCompression())),
-    allocator(normalized_component_storage_ptr->fixed_size_allocator_data),
+    allocator(normalized_component_storage_ptr->fixed_size_allocator_data,
+              memory_pool.getMemoryResource(),
+              lazy_object_storage),
     bindings(normalized_component_storage_ptr->bindings,
              (DummyNode<TypeId, NormalizedBinding>*)nullptr,
              (DummyNode<TypeId, NormalizedBinding>*)nullptr,
              memory_pool),
-    multibindings(std::move(normalized_component_storage_ptr->multibindings)) {
+    multibindings(std::move(normalized_component_storage_ptr->multibindings)),
+    construction_plans(&normalized_component_storage_ptr->construction_plans) {
 
 #ifdef FRUIT_EXTRA_DEBUG
   bindings.checkFullyConstructed();
@@ -89,7 +101,10 @@ InjectorStorage::InjectorStorage(
 
 InjectorStorage::InjectorStorage(const NormalizedComponentStorage& normalized_component,
                                  ComponentStorage&& component,
-                                 MemoryPool& memory_pool) {
+                                 MemoryPool& memory_pool,
+                                 bool lazy_object_storage)
+  : multibindings(NormalizedMultibindingSetMap::allocator_type(memory_pool.getMemoryResource())),
+    construction_plans(&normalized_component.construction_plans) {
 
   FixedSizeAllocator::FixedSizeAllocatorData fixed_size_allocator_data;
   using new_bindings_vector_t = std::vector<ComponentStorageEntry, ArenaAllocator<ComponentStorageEntry>>;
@@ -105,14 +120,22 @@ InjectorStorage::InjectorStorage(const NormalizedComponentStorage& normalized_co
       fixed_size_allocator_data,
       new_bindings_vector,
       multibindings,
-      [&normalized_component](TypeId type_id) { return normalized_component.bindings.find(type_id); },
-      [&normalized_component](Graph::const_node_iterator itr) { return !(itr == normalized_component.bindings.end()); },
-      [](Graph::const_node_iterator itr) { return itr.isTerminal(); },
-      [](Graph::const_node_iterator itr) { return itr.getNode().object; },
-      [](Graph::const_node_iterator itr) { return itr.getNode().create; });
+      [&normalized_component](TypeId type_id) {
+        return NormalizedBindingItr{normalized_component.bindings.find(type_id), type_id};
+      },
+      [&normalized_component](NormalizedBindingItr x) { return !(x.itr == normalized_component.bindings.end()); },
+      // The nodes of shared singletons are terminal, but they're not bindings for constructed objects.
+      [&normalized_component](NormalizedBindingItr x) {
+        return x.itr.isTerminal() && normalized_component.getSharedSingletonCreate(x.type_id) == nullptr;
+      },
+      [](NormalizedBindingItr x) { return x.itr.getNode().object; },
+      [&normalized_component](NormalizedBindingItr x) {
+        auto create = normalized_component.getSharedSingletonCreate(x.type_id);
+        return create != nullptr ? create : x.itr.getNode().create;
+      });
 
 
-  allocator = FixedSizeAllocator(fixed_size_allocator_data);
+  allocator = FixedSizeAllocator(fixed_size_allocator_data, memory_pool.getMemoryResource(), lazy_object_storage);
 
   bindings = Graph(normalized_component.bindings,
                    BindingDataNodeIter{new_bindings_vector.begin()},
@@ -123,9 +146,106 @@ InjectorStorage::InjectorStorage(const NormalizedComponentStorage& normalized_co
 #endif
 }
 
+InjectorStorage::InjectorStorage(
+    InjectorStorage& parent,
+    ComponentStorage&& component,
+    const std::vector<TypeId, ArenaAllocator<TypeId>>& exposed_types,
+    const std::vector<ComponentStorageEntry, ArenaAllocator<ComponentStorageEntry>>& entries_from_parent,
+    MemoryPool& memory_pool)
+  : normalized_component_storage_ptr(
+      new NormalizedComponentStorage(
+          addBindingsFromParent(std::move(component), entries_from_parent),
+          exposed_types,
+          memory_pool,
+          NormalizedComponentStorage::WithPermanentCompression())),
+    allocator(normalized_component_storage_ptr->fixed_size_allocator_data, memory_pool.getMemoryResource()),
+    bindings(normalized_component_storage_ptr->bindings,
+             (DummyNode<TypeId, NormalizedBinding>*)nullptr,
+             (DummyNode<TypeId, NormalizedBinding>*)nullptr,
+             memory_pool),
+    multibindings(std::move(normalized_component_storage_ptr->multibindings)),
+    parent(&parent),
+    construction_plans(&normalized_component_storage_ptr->construction_plans) {
+
+#ifdef FRUIT_EXTRA_DEBUG
+  bindings.checkFullyConstructed();
+#endif
+}
+
+InjectorStorage::InjectorStorage(
+    const NormalizedComponentStorage& normalized_component,
+    MemoryPool& memory_pool,
+    ForSharedSingletons)
+  : allocator(normalized_component.fixed_size_allocator_data, memory_pool.getMemoryResource()),
+    bindings(normalized_component.bindings,
+             (DummyNode<TypeId, NormalizedBinding>*)nullptr,
+             (DummyNode<TypeId, NormalizedBinding>*)nullptr,
+             memory_pool) {
+}
+
+ComponentStorage InjectorStorage::addBindingsFromParent(
+    ComponentStorage&& component,
+    const std::vector<ComponentStorageEntry, ArenaAllocator<ComponentStorageEntry>>& entries_from_parent) {
+  FixedSizeVector<ComponentStorageEntry> component_entries = std::move(component).release();
+  FixedSizeVector<ComponentStorageEntry> entries(component_entries.size() + entries_from_parent.size());
+
+  for (const ComponentStorageEntry& entry : entries_from_parent) {
+    entries.push_back(entry);
+  }
+
+  // The ComponentStorageEntry objects are moved here, so they must not be destroyed in `component_entries'.
+  for (ComponentStorageEntry& entry : component_entries) {
+    entries.push_back(entry);
+  }
+  component_entries.clear();
+
+  return ComponentStorage(std::move(entries));
+}
+
 InjectorStorage::~InjectorStorage() {
 }
 
+MemoryResource* InjectorStorage::getMemoryResource() const {
+  return allocator.getMemoryResource();
+}
+
+void InjectorStorage::setProcessLifetime() {
+  is_process_lifetime = true;
+}
+
+void InjectorStorage::destroy(std::unique_ptr<InjectorStorage> storage) {
+  if (storage != nullptr && storage->is_process_lifetime) {
+    storage->allocator.runAtExitDestructors();
+    // Intentionally leaked.
+    (void)storage.release();
+  }
+}
+
+void InjectorStorage::executeConstructionPlan(Graph::node_iterator itr) {
+  std::size_t index = bindings.getNodeIndex(itr);
+  if (index + 1 >= construction_plans->plan_offsets.size()) {
+    // No plans were computed, or this node was added in the injector.
+    return;
+  }
+  const std::size_t* plan_begin = construction_plans->plan_nodes.data() + construction_plans->plan_offsets[index];
+  const std::size_t* plan_end = construction_plans->plan_nodes.data() + construction_plans->plan_offsets[index + 1];
+  for (const std::size_t* i = plan_begin; i != plan_end; ++i) {
+    Graph::node_iterator dep_itr = bindings.atNodeIndex(*i);
+    if (!dep_itr.isTerminal()) {
+      getPtrInternal(dep_itr);
+    }
+  }
+}
+
+void InjectorStorage::constructAll(const Graph::node_iterator* itrs, const bool* is_lazy, std::size_t n,
+                                   const void** ptrs) {
+  for (std::size_t i = 0; i < n; ++i) {
+    // For non-terminal nodes, this executes the construction plan of the node. Objects constructed by a previous plan
+    // are terminal by now, so each object is still constructed only once.
+    ptrs[i] = is_lazy[i] ? nullptr : getPtrInternal(itrs[i]);
+  }
+}
+
 void InjectorStorage::ensureConstructedMultibinding(
     NormalizedMultibindingSet& multibinding_set) {
   for (NormalizedMultibinding& multibinding : multibinding_set.elems) {
@@ -136,15 +256,6 @@ void InjectorStorage::ensureConstructedMultibinding(
   }
 }
 
-void* InjectorStorage::getMultibindings(TypeId typeInfo) {
-  NormalizedMultibindingSet* multibinding_set = getNormalizedMultibindingSet(typeInfo);
-  if (multibinding_set == nullptr) {
-    // Not registered.
-    return nullptr;
-  }
-  return multibinding_set->get_multibindings_vector(*this).get();
-}
-
 void InjectorStorage::eagerlyInjectMultibindings() {
   for (auto& typeInfoInfoPair : multibindings) {
     typeInfoInfoPair.second.get_multibindings_vector(*this);
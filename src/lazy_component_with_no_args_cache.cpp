@@ -0,0 +1,153 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define IN_FRUIT_CPP_FILE
+
+#include <fruit/impl/component_storage/lazy_component_with_no_args_cache.h>
+#include <fruit/impl/component_storage/component_storage_entry.h>
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#ifdef FRUIT_EXTRA_DEBUG
+#include <iostream>
+#endif
+
+using namespace fruit;
+using namespace fruit::impl;
+
+namespace {
+
+using erased_fun_t = LazyComponentWithNoArgsCache::erased_fun_t;
+
+using CachedEntries = std::vector<ComponentStorageEntry>;
+
+// ComponentStorageEntry has no destructor, so the entries must be destroyed explicitly before deleting the vector.
+struct CachedEntriesDeleter {
+  void operator()(const CachedEntries* cached_entries) const {
+    for (const ComponentStorageEntry& entry : *cached_entries) {
+      entry.destroy();
+    }
+    delete cached_entries;
+  }
+};
+
+// The cached entries for each component function, sorted by function.
+// A snapshot is never modified once published: adding or removing entries publishes a modified copy instead. So a
+// reader can use the snapshot that it got without holding any lock, and the entries in it stay alive (even if they're
+// evicted meanwhile) until the last reader drops it.
+using Snapshot = std::vector<std::pair<erased_fun_t, std::shared_ptr<const CachedEntries>>>;
+
+struct CacheData {
+  // Held only by writers, to serialize the publication of new snapshots.
+  std::mutex writer_mutex;
+  // Only accessed through std::atomic_load() and std::atomic_store().
+  std::shared_ptr<const Snapshot> snapshot = std::make_shared<const Snapshot>();
+};
+
+CacheData& getCacheData() {
+  // This is intentionally leaked, so that injectors can still be created while static objects are being destroyed.
+  static CacheData* cache_data = new CacheData();
+  return *cache_data;
+}
+
+Snapshot::const_iterator findInSnapshot(const Snapshot& snapshot, erased_fun_t erased_fun) {
+  return std::lower_bound(snapshot.begin(), snapshot.end(), erased_fun,
+      [](const Snapshot::value_type& x, erased_fun_t fun) {
+        return std::less<erased_fun_t>()(x.first, fun);
+      });
+}
+
+bool isInSnapshot(const Snapshot& snapshot, Snapshot::const_iterator itr, erased_fun_t erased_fun) {
+  return itr != snapshot.end() && itr->first == erased_fun;
+}
+
+} // namespace
+
+namespace fruit {
+namespace impl {
+
+bool LazyComponentWithNoArgsCache::appendCachedEntries(erased_fun_t erased_fun, entry_vector_t& entries) {
+  std::shared_ptr<const Snapshot> snapshot = std::atomic_load(&getCacheData().snapshot);
+  auto itr = findInSnapshot(*snapshot, erased_fun);
+  if (!isInSnapshot(*snapshot, itr, erased_fun)) {
+    return false;
+  }
+  const CachedEntries& cached_entries = *itr->second;
+
+#ifdef FRUIT_EXTRA_DEBUG
+  std::cout << "Reusing " << cached_entries.size() << " cached entries for a lazy component with no args." << std::endl;
+#endif
+
+  entries.reserve(entries.size() + cached_entries.size());
+  for (const ComponentStorageEntry& entry : cached_entries) {
+    // The entries in the vector will be destroyed during normalization, so we can't hand out the cached ones directly.
+    entries.push_back(entry.copy());
+  }
+  return true;
+}
+
+void LazyComponentWithNoArgsCache::storeEntries(
+    erased_fun_t erased_fun, const ComponentStorageEntry* first, const ComponentStorageEntry* last) {
+  std::unique_ptr<CachedEntries> copied_entries(new CachedEntries());
+  copied_entries->reserve(last - first);
+  for (const ComponentStorageEntry* itr = first; itr != last; ++itr) {
+    copied_entries->push_back(itr->copy());
+  }
+  std::shared_ptr<const CachedEntries> cached_entries(copied_entries.release(), CachedEntriesDeleter());
+
+  CacheData& cache_data = getCacheData();
+  std::lock_guard<std::mutex> lock(cache_data.writer_mutex);
+  std::shared_ptr<const Snapshot> snapshot = std::atomic_load(&cache_data.snapshot);
+  auto itr = findInSnapshot(*snapshot, erased_fun);
+  if (isInSnapshot(*snapshot, itr, erased_fun)) {
+    // Another thread expanded this component concurrently and stored its entries first. The entries copied above are
+    // destroyed when `cached_entries' goes out of scope.
+    return;
+  }
+  std::shared_ptr<Snapshot> new_snapshot = std::make_shared<Snapshot>();
+  new_snapshot->reserve(snapshot->size() + 1);
+  new_snapshot->insert(new_snapshot->end(), snapshot->begin(), itr);
+  new_snapshot->emplace_back(erased_fun, std::move(cached_entries));
+  new_snapshot->insert(new_snapshot->end(), itr, snapshot->end());
+  std::atomic_store(&cache_data.snapshot, std::shared_ptr<const Snapshot>(std::move(new_snapshot)));
+}
+
+void LazyComponentWithNoArgsCache::evict(erased_fun_t erased_fun) {
+  CacheData& cache_data = getCacheData();
+  std::lock_guard<std::mutex> lock(cache_data.writer_mutex);
+  std::shared_ptr<const Snapshot> snapshot = std::atomic_load(&cache_data.snapshot);
+  auto itr = findInSnapshot(*snapshot, erased_fun);
+  if (!isInSnapshot(*snapshot, itr, erased_fun)) {
+    return;
+  }
+  std::shared_ptr<Snapshot> new_snapshot = std::make_shared<Snapshot>();
+  new_snapshot->reserve(snapshot->size() - 1);
+  new_snapshot->insert(new_snapshot->end(), snapshot->begin(), itr);
+  new_snapshot->insert(new_snapshot->end(), itr + 1, snapshot->end());
+  std::atomic_store(&cache_data.snapshot, std::shared_ptr<const Snapshot>(std::move(new_snapshot)));
+}
+
+void LazyComponentWithNoArgsCache::clear() {
+  CacheData& cache_data = getCacheData();
+  std::lock_guard<std::mutex> lock(cache_data.writer_mutex);
+  std::atomic_store(&cache_data.snapshot, std::make_shared<const Snapshot>());
+}
+
+} // namespace impl
+} // namespace fruit
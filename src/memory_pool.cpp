@@ -14,14 +14,111 @@
  * limitations under the License.
  */
 
+
 #define IN_FRUIT_CPP_FILE
 
 #include <fruit/impl/data_structures/memory_pool.h>
 
+#include <cstddef>
+
 using namespace fruit::impl;
 
+namespace {
+
+// Set (for the current thread) when the thread-local ChunkCache is destroyed. This is trivially destructible, so it
+// can still be read after that (e.g. when destroying other thread-local or static objects that use a MemoryPool).
+thread_local bool chunk_cache_destroyed = false;
+
+} // namespace
+
+namespace fruit {
+namespace impl {
+
+struct MemoryPool::ChunkCache {
+  // free_chunks[i][0..num_free_chunks[i]) are the free chunks of size class i.
+  ChunkHeader* free_chunks[NUM_CHUNK_SIZE_CLASSES][MAX_CACHED_CHUNKS_PER_SIZE_CLASS];
+  std::size_t num_free_chunks[NUM_CHUNK_SIZE_CLASSES] = {};
+
+  ~ChunkCache() {
+    for (std::size_t size_class = 0; size_class < NUM_CHUNK_SIZE_CLASSES; ++size_class) {
+      for (std::size_t i = 0; i < num_free_chunks[size_class]; ++i) {
+        operator delete(free_chunks[size_class][i]);
+      }
+    }
+    chunk_cache_destroyed = true;
+  }
+};
+
+MemoryPool::ChunkCache* MemoryPool::getChunkCache() {
+  if (chunk_cache_destroyed) {
+    return nullptr;
+  }
+  thread_local ChunkCache chunk_cache;
+  return &chunk_cache;
+}
+
 void MemoryPool::destroy() {
-  for (void* p : allocated_chunks) {
-    operator delete(p);
+  ChunkCache* chunk_cache = nullptr;
+  if (memory_resource == nullptr && last_chunk != nullptr) {
+    chunk_cache = getChunkCache();
+  }
+  ChunkHeader* chunk = last_chunk;
+  while (chunk != nullptr) {
+    ChunkHeader* previous = chunk->previous;
+    std::size_t size_class = chunk->size_class;
+    if (chunk_cache != nullptr
+        && size_class != NUM_CHUNK_SIZE_CLASSES
+        && chunk_cache->num_free_chunks[size_class] != MAX_CACHED_CHUNKS_PER_SIZE_CLASS) {
+      chunk_cache->free_chunks[size_class][chunk_cache->num_free_chunks[size_class]++] = chunk;
+    } else {
+      deallocateFromResource(memory_resource, chunk, chunk->size, alignof(std::max_align_t));
+    }
+    chunk = previous;
   }
 }
+
+void* MemoryPool::allocateChunk(std::size_t required_space) {
+#ifdef FRUIT_DISABLE_ARENA_ALLOCATION
+  std::size_t size_class = NUM_CHUNK_SIZE_CLASSES;
+#else
+  // Use the next size class (or a bigger one if needed to fit required_space).
+  std::size_t size_class = num_chunks < NUM_CHUNK_SIZE_CLASSES - 1 ? num_chunks : NUM_CHUNK_SIZE_CLASSES - 1;
+  while (size_class != NUM_CHUNK_SIZE_CLASSES && chunkSize(size_class) - CHUNK_HEADER_SIZE < required_space) {
+    ++size_class;
+  }
+#endif
+
+  ChunkHeader* chunk = nullptr;
+  std::size_t size;
+  if (size_class == NUM_CHUNK_SIZE_CLASSES) {
+    size = required_space + CHUNK_HEADER_SIZE;
+  } else {
+    size = chunkSize(size_class);
+    if (memory_resource == nullptr) {
+      ChunkCache* chunk_cache = getChunkCache();
+      if (chunk_cache != nullptr && chunk_cache->num_free_chunks[size_class] != 0) {
+        chunk = chunk_cache->free_chunks[size_class][--chunk_cache->num_free_chunks[size_class]];
+      }
+    }
+  }
+  if (chunk == nullptr) {
+    chunk = static_cast<ChunkHeader*>(allocateFromResource(memory_resource, size, alignof(std::max_align_t)));
+  }
+  chunk->previous = last_chunk;
+  chunk->size = size;
+  chunk->size_class = size_class;
+  last_chunk = chunk;
+  ++num_chunks;
+
+  char* p = reinterpret_cast<char*>(chunk) + CHUNK_HEADER_SIZE;
+  if (size_class != NUM_CHUNK_SIZE_CLASSES) {
+    // The rest of this chunk will be used for the following allocations. Chunks that don't have a size class have no
+    // space left, so in that case we keep using the current chunk (if any).
+    first_free = p + required_space;
+    capacity = size - CHUNK_HEADER_SIZE - required_space;
+  }
+  return p;
+}
+
+} // namespace impl
+} // namespace fruit
@@ -45,8 +45,10 @@ NormalizedComponentStorage::NormalizedComponentStorage(
     const std::vector<TypeId, ArenaAllocator<TypeId>>& exposed_types,
     MemoryPool& memory_pool,
     WithPermanentCompression)
-  : bindingCompressionInfoMapMemoryPool(),
-    bindingCompressionInfoMap() {
+  : multibindings(NormalizedMultibindingSetMap::allocator_type(memory_pool.getMemoryResource())),
+    bindingCompressionInfoMapMemoryPool(memory_pool.getMemoryResource()),
+    bindingCompressionInfoMap(),
+    construction_plans(memory_pool.getMemoryResource()) {
 
   using bindings_vector_t = std::vector<ComponentStorageEntry, ArenaAllocator<ComponentStorageEntry>>;
   bindings_vector_t bindings_vector =
@@ -62,19 +64,24 @@ NormalizedComponentStorage::NormalizedComponentStorage(
   bindings = SemistaticGraph<TypeId, NormalizedBinding>(InjectorStorage::BindingDataNodeIter{bindings_vector.begin()},
                                                         InjectorStorage::BindingDataNodeIter{bindings_vector.end()},
                                                         memory_pool);
+
+  computeConstructionPlans(bindings_vector, exposed_types, memory_pool);
 }
 
 NormalizedComponentStorage::NormalizedComponentStorage(
     ComponentStorage&& component,
     const std::vector<TypeId, ArenaAllocator<TypeId>>& exposed_types,
+    const std::vector<TypeId, ArenaAllocator<TypeId>>& shared_types,
     MemoryPool& memory_pool,
     WithUndoableCompression)
-  : bindingCompressionInfoMapMemoryPool(),
+  : multibindings(NormalizedMultibindingSetMap::allocator_type(memory_pool.getMemoryResource())),
+    bindingCompressionInfoMapMemoryPool(memory_pool.getMemoryResource()),
     bindingCompressionInfoMap(
       std::unique_ptr<BindingCompressionInfoMap>(
           new BindingCompressionInfoMap(
               createHashMapWithArenaAllocator<TypeId, CompressedBindingUndoInfo>(
-                  bindingCompressionInfoMapMemoryPool)))) {
+                  bindingCompressionInfoMapMemoryPool)))),
+    construction_plans(memory_pool.getMemoryResource()) {
 
   using bindings_vector_t = std::vector<ComponentStorageEntry, ArenaAllocator<ComponentStorageEntry>>;
   bindings_vector_t bindings_vector =
@@ -84,6 +91,7 @@ NormalizedComponentStorage::NormalizedComponentStorage(
       fixed_size_allocator_data,
       memory_pool,
       exposed_types,
+      shared_types,
       bindings_vector,
       multibindings,
       *bindingCompressionInfoMap);
@@ -91,6 +99,216 @@ NormalizedComponentStorage::NormalizedComponentStorage(
   bindings = SemistaticGraph<TypeId, NormalizedBinding>(InjectorStorage::BindingDataNodeIter{bindings_vector.begin()},
                                                         InjectorStorage::BindingDataNodeIter{bindings_vector.end()},
                                                         memory_pool);
+
+  if (!shared_types.empty()) {
+    constructSharedSingletons(bindings_vector, shared_types, memory_pool);
+  }
+
+  // This is done after constructing the shared singletons, so that those (and their deps) are left out of the plans.
+  computeConstructionPlans(bindings_vector, exposed_types, memory_pool);
+}
+
+void NormalizedComponentStorage::computeConstructionPlans(
+    const bindings_vector_t& bindings_vector,
+    const std::vector<TypeId, ArenaAllocator<TypeId>>& exposed_types,
+    MemoryPool& memory_pool) {
+  HashMapWithArenaAllocator<TypeId, const ComponentStorageEntry*> entries_by_type =
+      createHashMapWithArenaAllocator<TypeId, const ComponentStorageEntry*>(bindings_vector.size(), memory_pool);
+  for (const ComponentStorageEntry& entry : bindings_vector) {
+    entries_by_type[entry.getTypeId()] = &entry;
+  }
+
+  // The (index, type) pairs of the nodes that get a plan, sorted by index so that the plans can be stored in that order.
+  using exposed_nodes_t = std::vector<std::pair<std::size_t, TypeId>, ArenaAllocator<std::pair<std::size_t, TypeId>>>;
+  exposed_nodes_t exposed_nodes = exposed_nodes_t(ArenaAllocator<std::pair<std::size_t, TypeId>>(memory_pool));
+  for (TypeId type : exposed_types) {
+    Graph::node_iterator itr = bindings.find(type);
+    if (itr == bindings.end() || itr.isTerminal() || entries_by_type.find(type) == entries_by_type.end()) {
+      // A requirement, or an object that's already constructed.
+      continue;
+    }
+    exposed_nodes.push_back(std::make_pair(bindings.getNodeIndex(itr), type));
+  }
+  std::sort(exposed_nodes.begin(), exposed_nodes.end());
+  exposed_nodes.erase(std::unique(exposed_nodes.begin(), exposed_nodes.end()), exposed_nodes.end());
+  if (exposed_nodes.empty()) {
+    return;
+  }
+
+  HashSetWithArenaAllocator<TypeId> exposed_types_set =
+      createHashSetWithArenaAllocator<TypeId>(exposed_nodes.size(), memory_pool);
+  for (const auto& p : exposed_nodes) {
+    exposed_types_set.insert(p.second);
+  }
+
+  // visit_stamps[i] is the index in exposed_nodes (plus 1) of the last plan that visited the node with index i, so that
+  // we don't need to clear it between plans.
+  using stamps_t = std::vector<std::size_t, ArenaAllocator<std::size_t>>;
+  stamps_t visit_stamps = stamps_t(bindings.numNodes(), 0, ArenaAllocator<std::size_t>(memory_pool));
+
+  struct StackEntry {
+    TypeId type;
+    std::size_t node_index;
+    // nullptr if the deps of this type must not be visited.
+    const BindingDeps* deps;
+    std::size_t next_dep;
+  };
+  using stack_t = std::vector<StackEntry, ArenaAllocator<StackEntry>>;
+  stack_t stack = stack_t(ArenaAllocator<StackEntry>(memory_pool));
+
+  construction_plans.plan_offsets.reserve(bindings.numNodes() + 1);
+  for (std::size_t i = 0; i < exposed_nodes.size(); ++i) {
+    std::size_t root_index = exposed_nodes[i].first;
+    TypeId root_type = exposed_nodes[i].second;
+    std::size_t stamp = i + 1;
+    while (construction_plans.plan_offsets.size() <= root_index) {
+      construction_plans.plan_offsets.push_back(construction_plans.plan_nodes.size());
+    }
+
+    visit_stamps[root_index] = stamp;
+    stack.push_back(StackEntry{root_type, root_index,
+                               &entries_by_type.find(root_type)->second->binding_for_object_to_construct.data->deps, 0});
+    // A non-recursive DFS, adding each node to the plan after its deps (i.e. in post-order).
+    while (!stack.empty()) {
+      StackEntry& current = stack.back();
+      if (current.deps == nullptr || current.next_dep == current.deps->num_deps) {
+        if (current.node_index != root_index) {
+          construction_plans.plan_nodes.push_back(current.node_index);
+        }
+        stack.pop_back();
+        continue;
+      }
+      std::size_t dep_position = current.next_dep++;
+      if (current.deps->is_lazy[dep_position]) {
+        continue;
+      }
+      TypeId dep_type = current.deps->deps[dep_position];
+      Graph::node_iterator dep_itr = bindings.at(dep_type);
+      std::size_t dep_index = bindings.getNodeIndex(dep_itr);
+      if (visit_stamps[dep_index] == stamp) {
+        continue;
+      }
+      visit_stamps[dep_index] = stamp;
+      auto entry_itr = entries_by_type.find(dep_type);
+      if (entry_itr == entries_by_type.end()) {
+        // A requirement of this component. Its deps are only known in the injectors, so they're left out.
+        stack.push_back(StackEntry{dep_type, dep_index, nullptr, 0});
+      } else if (dep_itr.isTerminal()) {
+        // Already constructed, nothing to do.
+      } else if (exposed_types_set.count(dep_type) != 0) {
+        // This has its own plan, that will be executed when it's constructed.
+        stack.push_back(StackEntry{dep_type, dep_index, nullptr, 0});
+      } else {
+        stack.push_back(StackEntry{dep_type, dep_index, &entry_itr->second->binding_for_object_to_construct.data->deps, 0});
+      }
+    }
+
+    std::size_t plan_size = construction_plans.plan_nodes.size() - construction_plans.plan_offsets.back();
+    if (plan_size <= 1) {
+      // Constructing the node recursively is just as fast, and it uses at most one more stack frame.
+      construction_plans.plan_nodes.resize(construction_plans.plan_offsets.back());
+    }
+    construction_plans.plan_offsets.push_back(construction_plans.plan_nodes.size());
+  }
+  while (construction_plans.plan_offsets.size() <= bindings.numNodes()) {
+    construction_plans.plan_offsets.push_back(construction_plans.plan_nodes.size());
+  }
+}
+
+void NormalizedComponentStorage::constructSharedSingletons(
+    const bindings_vector_t& bindings_vector,
+    const std::vector<TypeId, ArenaAllocator<TypeId>>& shared_types,
+    MemoryPool& memory_pool) {
+  HashMapWithArenaAllocator<TypeId, const ComponentStorageEntry*> entries_by_type =
+      createHashMapWithArenaAllocator<TypeId, const ComponentStorageEntry*>(bindings_vector.size(), memory_pool);
+  for (const ComponentStorageEntry& entry : bindings_vector) {
+    entries_by_type[entry.getTypeId()] = &entry;
+  }
+
+  // Step 1: find the types that might be constructed together with the shared types, checking that none of them is a
+  // requirement of this component (those are bound in each injector, so they can't be used here).
+  HashSetWithArenaAllocator<TypeId> reachable_types =
+      createHashSetWithArenaAllocator<TypeId>(memory_pool);
+  std::vector<TypeId, ArenaAllocator<TypeId>> types_to_visit =
+      std::vector<TypeId, ArenaAllocator<TypeId>>(
+          shared_types.begin(), shared_types.end(), ArenaAllocator<TypeId>(memory_pool));
+  while (!types_to_visit.empty()) {
+    TypeId type = types_to_visit.back();
+    types_to_visit.pop_back();
+    if (!reachable_types.insert(type).second) {
+      // Already visited.
+      continue;
+    }
+    auto itr = entries_by_type.find(type);
+    if (itr == entries_by_type.end()) {
+      std::cerr << "Fatal injection error: the type " << std::string(type)
+                << " is needed to construct the shared singletons of a NormalizedComponent, but it's a requirement of"
+                << " that NormalizedComponent. Shared singletons can't depend on requirements, since those are only"
+                << " bound in each injector." << std::endl;
+      exit(1);
+    }
+    const ComponentStorageEntry& entry = *itr->second;
+    if (entry.getKind() != ComponentStorageEntry::Kind::BINDING_FOR_CONSTRUCTED_OBJECT) {
+      const BindingDeps* deps = &entry.binding_for_object_to_construct.data->deps;
+      types_to_visit.insert(types_to_visit.end(), deps->deps, deps->deps + deps->num_deps);
+    }
+  }
+
+  // Step 2: construct the shared types (and their dependencies).
+  // This must be done before modifying fixed_size_allocator_data below, since the allocator of the new storage is
+  // sized based on that.
+  shared_singletons_storage = std::unique_ptr<InjectorStorage>(
+      new InjectorStorage(*this, memory_pool, InjectorStorage::ForSharedSingletons()));
+  for (TypeId type : shared_types) {
+    shared_singletons_storage->getPtrInternal(shared_singletons_storage->bindings.at(type));
+  }
+
+  sharedSingletonCreateMap = std::unique_ptr<SharedSingletonCreateMap>(
+      new SharedSingletonCreateMap(
+          createHashMapWithArenaAllocator<TypeId, ComponentStorageEntry::BindingForObjectToConstruct::create_t>(
+              reachable_types.size(), bindingCompressionInfoMapMemoryPool)));
+
+  // Step 3: share the constructed objects. Dependencies that haven't been constructed (e.g. because they're only
+  // injected through a Provider) are left unchanged.
+  for (TypeId type : reachable_types) {
+    Graph::node_iterator shared_itr = shared_singletons_storage->bindings.at(type);
+    Graph::node_iterator itr = bindings.at(type);
+    if (itr.isTerminal() || !shared_itr.isTerminal()) {
+      continue;
+    }
+    (*sharedSingletonCreateMap)[type] = itr.getNode().create;
+    itr.setTerminal();
+    // Not just shared_itr.getNode().object, the shared object might be stored inline.
+    itr.getNode().object = shared_singletons_storage->getPtrInternal(shared_itr);
+
+#ifdef FRUIT_EXTRA_DEBUG
+    std::cout << "NormalizedComponentStorage: sharing the object for " << type << " with all injectors." << std::endl;
+#endif
+
+    // The injectors no longer need to allocate this type.
+    // No binding was compressed into a type reachable from the shared types (see performBindingCompression()), so
+    // there's no compression to undo here and the type is allocated as itself.
+    FruitAssert(bindingCompressionInfoMap->count(type) == 0);
+    const ComponentStorageEntry& entry = *entries_by_type.find(type)->second;
+    if (entry.getKind() == ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_ALLOCATION) {
+      fixed_size_allocator_data.removeType(type);
+    } else {
+      FruitAssert(entry.getKind() == ComponentStorageEntry::Kind::BINDING_FOR_OBJECT_TO_CONSTRUCT_THAT_NEEDS_NO_ALLOCATION);
+      fixed_size_allocator_data.removeExternallyAllocatedType(type);
+    }
+  }
+}
+
+ComponentStorageEntry::BindingForObjectToConstruct::create_t NormalizedComponentStorage::getSharedSingletonCreate(
+    TypeId type_id) const {
+  if (sharedSingletonCreateMap == nullptr) {
+    return nullptr;
+  }
+  auto itr = sharedSingletonCreateMap->find(type_id);
+  if (itr == sharedSingletonCreateMap->end()) {
+    return nullptr;
+  }
+  return itr->second;
 }
 
 NormalizedComponentStorage::~NormalizedComponentStorage() {
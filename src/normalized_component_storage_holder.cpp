@@ -28,12 +28,14 @@ namespace impl {
 NormalizedComponentStorageHolder::NormalizedComponentStorageHolder(
   ComponentStorage&& component,
   const std::vector<TypeId, ArenaAllocator<TypeId>>& exposed_types,
+  const std::vector<TypeId, ArenaAllocator<TypeId>>& shared_types,
   MemoryPool& memory_pool,
   WithUndoableCompression)
   : storage(
       new NormalizedComponentStorage(
           std::move(component),
           exposed_types,
+          shared_types,
           memory_pool,
           NormalizedComponentStorage::WithUndoableCompression())) {
 }
@@ -0,0 +1,63 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#define IN_FRUIT_CPP_FILE
+
+#include <fruit/impl/data_structures/object_pool.h>
+
+#include <cstdint>
+#include <new>
+
+namespace fruit {
+namespace impl {
+
+ObjectPool::~ObjectPool() {
+  SlabHeader* slab = last_slab;
+  while (slab != nullptr) {
+    SlabHeader* previous = slab->previous;
+    operator delete(slab);
+    slab = previous;
+  }
+}
+
+void* ObjectPool::allocateSlab() {
+  std::size_t num_slots = num_slots_in_next_slab;
+  std::size_t max_num_slots = (MAX_SLAB_SIZE - SLAB_HEADER_SIZE) / slot_size;
+  if (num_slots > max_num_slots) {
+    num_slots = max_num_slots == 0 ? 1 : max_num_slots;
+  }
+  // operator new only guarantees that the memory is aligned for any fundamental type, so for over-aligned types we
+  // need some extra space to align the first slot.
+  std::size_t padding = slot_alignment > alignof(std::max_align_t) ? slot_alignment - 1 : 0;
+  std::size_t size = SLAB_HEADER_SIZE + padding + num_slots * slot_size;
+
+  SlabHeader* slab = static_cast<SlabHeader*>(operator new(size));
+  slab->previous = last_slab;
+  slab->size = size;
+  last_slab = slab;
+  num_slots_in_next_slab = num_slots * 2;
+
+  std::uintptr_t first_slot = std::uintptr_t(slab) + SLAB_HEADER_SIZE;
+  first_slot = (first_slot + slot_alignment - 1) / slot_alignment * slot_alignment;
+  char* p = reinterpret_cast<char*>(first_slot);
+  first_unused = p + slot_size;
+  unused_end = p + num_slots * slot_size;
+  return p;
+}
+
+} // namespace impl
+} // namespace fruit
@@ -0,0 +1,270 @@
+/*
+ * Copyright 2014 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#define IN_FRUIT_CPP_FILE
+
+#include <fruit/impl/injector/thread_local_objects.h>
+#include <fruit/impl/fruit_assert.h>
+
+#include <algorithm>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#ifdef FRUIT_EXTRA_DEBUG
+#include <iostream>
+#endif
+
+using namespace fruit;
+using namespace fruit::impl;
+
+namespace {
+
+// The objects stored by a single thread in a single ThreadLocalObjects.
+struct ThreadSlots {
+  // Indexed by binding index. nullptr for the bindings that this thread didn't construct.
+  std::vector<void*> objects;
+
+  // The objects in construction order, so that they can be destroyed in reverse order (an object might depend on
+  // another thread-local object constructed before it).
+  std::vector<std::pair<ThreadLocalObjects::destroy_t, void*>> on_destruction;
+
+  void destroyObjects() {
+    for (auto i = on_destruction.rbegin(), i_end = on_destruction.rend(); i != i_end; ++i) {
+      i->first(i->second);
+    }
+  }
+};
+
+} // namespace
+
+namespace fruit {
+namespace impl {
+
+struct ThreadLocalObjects::Registry {
+  std::mutex mutex;
+
+  // False once the ThreadLocalObjects has been destroyed. This can be read without holding the mutex.
+  std::atomic<bool> alive;
+
+  // Guarded by `mutex'. 1 for the ThreadLocalObjects (while it's alive), plus 1 for each thread that stored objects
+  // in it (until the thread exits). The last owner deletes this object.
+  std::size_t num_refs = 1;
+
+  // Guarded by `mutex'. The slots of all threads that stored objects in the ThreadLocalObjects and haven't exited
+  // yet. These are owned by this object.
+  std::vector<ThreadSlots*> thread_slots;
+
+  Registry()
+    : alive(true) {
+  }
+
+  // Drops a reference to `registry', deleting it if that was the last one. Must be called with `registry->mutex'
+  // locked, and unlocks it.
+  static void release(Registry* registry, std::unique_lock<std::mutex>& lock) {
+    FruitAssert(registry->num_refs > 0);
+    bool last = --registry->num_refs == 0;
+    lock.unlock();
+    if (last) {
+      delete registry;
+    }
+  }
+};
+
+} // namespace impl
+} // namespace fruit
+
+namespace {
+
+// The ThreadLocalObjects that the current thread stored objects in.
+class ThreadData {
+private:
+  struct Entry {
+    ThreadLocalObjects::Registry* registry;
+    // Only valid while registry->alive is true.
+    ThreadSlots* slots;
+  };
+
+  std::vector<Entry> entries;
+
+  // The index in `entries' of the last entry found by find(). Most threads use a single injector at a time, so this
+  // avoids a linear search in most cases.
+  std::size_t last_used_index = 0;
+
+  // When `entries' grows to this size, the entries for ThreadLocalObjects that have been destroyed are removed.
+  std::size_t next_cleanup_size = 16;
+
+  // Releases the current thread's reference to `entry.registry', destroying the thread's objects first if the
+  // ThreadLocalObjects is still alive.
+  static void release(Entry entry) {
+    std::unique_lock<std::mutex> lock(entry.registry->mutex);
+    ThreadSlots* slots = nullptr;
+    if (entry.registry->alive) {
+      std::vector<ThreadSlots*>& thread_slots = entry.registry->thread_slots;
+      thread_slots.erase(std::find(thread_slots.begin(), thread_slots.end(), entry.slots));
+      slots = entry.slots;
+    }
+    ThreadLocalObjects::Registry::release(entry.registry, lock);
+
+    // This is done after releasing the lock, in case the destructors use the injector.
+    if (slots != nullptr) {
+      slots->destroyObjects();
+      delete slots;
+    }
+  }
+
+  void removeEntriesOfDestroyedObjects() {
+    auto new_end = std::remove_if(entries.begin(), entries.end(), [](const Entry& entry) {
+      if (entry.registry->alive) {
+        return false;
+      }
+      release(entry);
+      return true;
+    });
+    entries.erase(new_end, entries.end());
+    last_used_index = 0;
+    next_cleanup_size = std::max(next_cleanup_size, 2 * entries.size());
+  }
+
+public:
+  ThreadData() = default;
+
+  ThreadData(const ThreadData&) = delete;
+  ThreadData& operator=(const ThreadData&) = delete;
+
+  // Called at thread exit.
+  ~ThreadData() {
+    for (const Entry& entry : entries) {
+      release(entry);
+    }
+  }
+
+  // Returns the slots of the current thread in `registry', or nullptr if there are none.
+  ThreadSlots* find(ThreadLocalObjects::Registry* registry) {
+    if (last_used_index < entries.size() && entries[last_used_index].registry == registry) {
+      return entries[last_used_index].slots;
+    }
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+      if (entries[i].registry == registry) {
+        last_used_index = i;
+        return entries[i].slots;
+      }
+    }
+    return nullptr;
+  }
+
+  // Adds new (empty) slots for the current thread in `registry'. There must be none already.
+  ThreadSlots* add(ThreadLocalObjects::Registry* registry) {
+    FruitAssert(find(registry) == nullptr);
+    if (entries.size() >= next_cleanup_size) {
+      removeEntriesOfDestroyedObjects();
+    }
+
+    ThreadSlots* slots = new ThreadSlots();
+    {
+      std::lock_guard<std::mutex> lock(registry->mutex);
+      FruitAssert(registry->alive);
+      registry->thread_slots.push_back(slots);
+      ++registry->num_refs;
+    }
+    entries.push_back(Entry{registry, slots});
+    last_used_index = entries.size() - 1;
+    return slots;
+  }
+};
+
+thread_local ThreadData thread_data;
+
+} // namespace
+
+namespace fruit {
+namespace impl {
+
+ThreadLocalObjects::~ThreadLocalObjects() {
+  Registry* r = registry.load(std::memory_order_acquire);
+  if (r == nullptr) {
+    return;
+  }
+
+  std::vector<ThreadSlots*> thread_slots;
+  {
+    std::unique_lock<std::mutex> lock(r->mutex);
+    r->alive = false;
+    thread_slots = std::move(r->thread_slots);
+    r->thread_slots.clear();
+    Registry::release(r, lock);
+  }
+
+#ifdef FRUIT_EXTRA_DEBUG
+  std::cout << "ThreadLocalObjects: destroying the thread-local objects of " << thread_slots.size() << " threads."
+            << std::endl;
+#endif
+
+  // This is done after releasing the lock, in case the destructors use the injector.
+  for (ThreadSlots* slots : thread_slots) {
+    slots->destroyObjects();
+    delete slots;
+  }
+}
+
+std::size_t ThreadLocalObjects::newBindingIndex() {
+  static std::atomic<std::size_t> next_binding_index(0);
+  return next_binding_index++;
+}
+
+ThreadLocalObjects::Registry* ThreadLocalObjects::getOrCreateRegistry() {
+  Registry* r = registry.load(std::memory_order_acquire);
+  if (r == nullptr) {
+    Registry* new_registry = new Registry();
+    if (registry.compare_exchange_strong(r, new_registry, std::memory_order_acq_rel)) {
+      r = new_registry;
+    } else {
+      // Another thread created it first, `r' now points to that one.
+      delete new_registry;
+    }
+  }
+  return r;
+}
+
+void* ThreadLocalObjects::get(std::size_t binding_index) {
+  Registry* r = registry.load(std::memory_order_acquire);
+  if (r == nullptr) {
+    return nullptr;
+  }
+  ThreadSlots* slots = thread_data.find(r);
+  if (slots == nullptr || binding_index >= slots->objects.size()) {
+    return nullptr;
+  }
+  return slots->objects[binding_index];
+}
+
+void ThreadLocalObjects::set(std::size_t binding_index, void* object, destroy_t destroy) {
+  Registry* r = getOrCreateRegistry();
+  ThreadSlots* slots = thread_data.find(r);
+  if (slots == nullptr) {
+    slots = thread_data.add(r);
+  }
+  if (binding_index >= slots->objects.size()) {
+    slots->objects.resize(binding_index + 1, nullptr);
+  }
+  FruitAssert(slots->objects[binding_index] == nullptr);
+  slots->objects[binding_index] = object;
+  slots->on_destruction.emplace_back(destroy, object);
+}
+
+} // namespace impl
+} // namespace fruit
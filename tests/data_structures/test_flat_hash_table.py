@@ -0,0 +1,146 @@
+#!/usr/bin/env python3
+#  Copyright 2016 Google Inc. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS-IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+from fruit_test_common import *
+
+COMMON_DEFINITIONS = '''
+    #include "test_common.h"
+
+    #define IN_FRUIT_CPP_FILE
+    #include <fruit/impl/util/hash_helpers.h>
+
+    using namespace std;
+    using namespace fruit::impl;
+    '''
+
+def test_empty():
+    source = '''
+        int main() {
+          MemoryPool memory_pool;
+          HashSetWithArenaAllocator<int> set = createHashSetWithArenaAllocator<int>(0, memory_pool);
+          Assert(set.empty());
+          Assert(set.size() == 0);
+          Assert(set.count(5) == 0);
+          Assert(set.find(5) == set.end());
+          Assert(set.begin() == set.end());
+          Assert(set.erase(5) == 0);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_insert_and_find_many():
+    source = '''
+        int main() {
+          MemoryPool memory_pool;
+          HashMapWithArenaAllocator<int*, int> map = createHashMapWithArenaAllocator<int*, int>(memory_pool);
+          // Pointers with the low bits always 0, to check that identity hashes work.
+          std::vector<int> v(1000);
+          for (int i = 0; i < 1000; ++i) {
+            Assert(map.emplace(&v[i], i).second);
+          }
+          Assert(!map.emplace(&v[3], 42).second);
+          Assert(map.size() == 1000);
+          for (int i = 0; i < 1000; ++i) {
+            auto itr = map.find(&v[i]);
+            Assert(itr != map.end());
+            Assert(itr->first == &v[i]);
+            Assert(itr->second == i);
+          }
+          int num_elements = 0;
+          for (const auto& p : map) {
+            Assert(p.second == p.first - &v[0]);
+            ++num_elements;
+          }
+          Assert(num_elements == 1000);
+          map[&v[7]] = 70;
+          Assert(map.find(&v[7])->second == 70);
+          int x;
+          Assert(map[&x] == 0);
+          Assert(map.size() == 1001);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_erase_while_iterating():
+    source = '''
+        int main() {
+          MemoryPool memory_pool;
+          HashSetWithArenaAllocator<int> set = createHashSetWithArenaAllocator<int>(10, memory_pool);
+          for (int i = 0; i < 100; ++i) {
+            set.insert(i);
+          }
+          for (auto itr = set.begin(); itr != set.end(); ) {
+            if (*itr % 2 == 0) {
+              itr = set.erase(itr);
+            } else {
+              ++itr;
+            }
+          }
+          Assert(set.size() == 50);
+          for (int i = 0; i < 100; ++i) {
+            Assert(set.count(i) == (i % 2 == 0 ? 0 : 1));
+          }
+          // The tombstones left by erase() must be reused or cleaned up on insertion.
+          for (int n = 0; n < 20; ++n) {
+            for (int i = 0; i < 100; i += 2) {
+              Assert(set.insert(i).second);
+            }
+            for (int i = 0; i < 100; i += 2) {
+              Assert(set.erase(i) == 1);
+            }
+          }
+          Assert(set.size() == 50);
+          set.clear();
+          Assert(set.empty());
+          Assert(set.begin() == set.end());
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_copy_and_move():
+    source = '''
+        int main() {
+          MemoryPool memory_pool;
+          HashMapWithArenaAllocator<int, std::string> map = createHashMapWithArenaAllocator<int, std::string>(memory_pool);
+          for (int i = 0; i < 50; ++i) {
+            map[i] = std::to_string(i);
+          }
+          HashMapWithArenaAllocator<int, std::string> map2 = map;
+          HashMapWithArenaAllocator<int, std::string> map3 = std::move(map);
+          Assert(map.empty());
+          Assert(map2.size() == 50);
+          Assert(map3.size() == 50);
+          for (int i = 0; i < 50; ++i) {
+            Assert(map2[i] == std::to_string(i));
+            Assert(map3[i] == std::to_string(i));
+          }
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+if __name__== '__main__':
+    main(__file__)
@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+#  Copyright 2016 Google Inc. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS-IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+from fruit_test_common import *
+
+COMMON_DEFINITIONS = '''
+    #include "test_common.h"
+
+    #define IN_FRUIT_CPP_FILE
+    #include <fruit/impl/data_structures/memory_pool.h>
+
+    #include <cstdint>
+    #include <cstring>
+
+    using namespace std;
+    using namespace fruit::impl;
+
+    template <typename T>
+    bool isAligned(T* p) {
+      return std::uintptr_t(p) % alignof(T) == 0;
+    }
+    '''
+
+def test_allocations_are_aligned():
+    source = '''
+        int main() {
+          MemoryPool memory_pool;
+          for (int i = 0; i < 1000; ++i) {
+            Assert(isAligned(memory_pool.allocate<char>(1 + i % 3)));
+            Assert(isAligned(memory_pool.allocate<int>(1 + i % 5)));
+            Assert(isAligned(memory_pool.allocate<double>(1)));
+            Assert(isAligned(memory_pool.allocate<long double>(2)));
+          }
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_allocations_do_not_overlap():
+    source = '''
+        int main() {
+          MemoryPool memory_pool;
+          std::vector<std::pair<char*, std::size_t>> blocks;
+          for (std::size_t i = 0; i < 500; ++i) {
+            // This also covers allocations bigger than all chunk sizes.
+            std::size_t n = (i % 50 == 0) ? 100000 : (i % 7) * 31;
+            char* p = memory_pool.allocate<char>(n);
+            std::memset(p, int(i), n);
+            blocks.emplace_back(p, n);
+          }
+          for (std::size_t i = 0; i < blocks.size(); ++i) {
+            for (std::size_t j = 0; j < blocks[i].second; ++j) {
+              Assert(blocks[i].first[j] == char(i));
+            }
+          }
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_chunks_reused_by_pools_in_the_same_thread():
+    source = '''
+        int main() {
+          int* p1;
+          {
+            MemoryPool memory_pool;
+            p1 = memory_pool.allocate<int>(10);
+          }
+          MemoryPool memory_pool;
+          int* p2 = memory_pool.allocate<int>(10);
+          Assert(p1 == p2);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+if __name__== '__main__':
+    main(__file__)
@@ -0,0 +1,84 @@
+#!/usr/bin/env python3
+#  Copyright 2016 Google Inc. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS-IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+from fruit_test_common import *
+
+COMMON_DEFINITIONS = '''
+    #include "test_common.h"
+
+    #define IN_FRUIT_CPP_FILE
+    #include <fruit/impl/data_structures/object_pool.h>
+
+    #include <cstdint>
+    #include <cstring>
+
+    using namespace std;
+    using namespace fruit::impl;
+    '''
+
+@pytest.mark.parametrize('Size,Alignment', [
+    ('1', '1'),
+    ('12', '4'),
+    ('24', '8'),
+    ('100', '4'),
+    ('128', '128'),
+    ('70000', '8'),
+])
+def test_allocations_are_aligned_and_do_not_overlap(Size, Alignment):
+    source = '''
+        int main() {
+          ObjectPool object_pool(Size, Alignment);
+          std::vector<char*> slots;
+          for (std::size_t i = 0; i < 300; ++i) {
+            char* p = static_cast<char*>(object_pool.allocate());
+            Assert(std::uintptr_t(p) % Alignment == 0);
+            std::memset(p, int(i), Size);
+            slots.push_back(p);
+          }
+          for (std::size_t i = 0; i < slots.size(); ++i) {
+            for (std::size_t j = 0; j < Size; ++j) {
+              Assert(slots[i][j] == char(i));
+            }
+          }
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_deallocated_slots_are_reused():
+    source = '''
+        int main() {
+          ObjectPool object_pool(sizeof(int), alignof(int));
+          void* p1 = object_pool.allocate();
+          void* p2 = object_pool.allocate();
+          object_pool.deallocate(p1);
+          Assert(object_pool.allocate() == p1);
+          object_pool.deallocate(p2);
+          object_pool.deallocate(p1);
+          Assert(object_pool.allocate() == p1);
+          Assert(object_pool.allocate() == p2);
+          Assert(object_pool.allocate() != p2);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+if __name__== '__main__':
+    main(__file__)
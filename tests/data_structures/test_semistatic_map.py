@@ -70,7 +70,7 @@ def test_1_inserted_elem():
           vector<pair<int, std::string>, ArenaAllocator<pair<int, std::string>>> new_values(
             {{2, "bar"}}, 
             ArenaAllocator<pair<int, std::string>>(memory_pool));
-          SemistaticMap<int, std::string> map(old_map, std::move(new_values));
+          SemistaticMap<int, std::string> map(old_map, std::move(new_values), memory_pool);
           Assert(map.find(0) == nullptr);
           Assert(map.find(2) != nullptr);
           Assert(map.at(2) == "bar");
@@ -115,7 +115,7 @@ def test_1_elem_2_inserted():
           vector<pair<int, std::string>, ArenaAllocator<pair<int, std::string>>> new_values(
               {{3, "bar"}, {4, "baz"}}, 
               ArenaAllocator<pair<int, std::string>>(memory_pool));
-          SemistaticMap<int, std::string> map(old_map, std::move(new_values));
+          SemistaticMap<int, std::string> map(old_map, std::move(new_values), memory_pool);
           Assert(map.find(0) == nullptr);
           Assert(map.find(1) != nullptr);
           Assert(map.at(1) == "foo");
@@ -141,7 +141,7 @@ def test_3_elem_3_inserted():
           vector<pair<int, std::string>, ArenaAllocator<pair<int, std::string>>> new_values(
               {{2, "2"}, {4, "4"}, {16, "16"}}, 
               ArenaAllocator<pair<int, std::string>>(memory_pool));
-          SemistaticMap<int, std::string> map(old_map, std::move(new_values));
+          SemistaticMap<int, std::string> map(old_map, std::move(new_values), memory_pool);
           Assert(map.find(0) == nullptr);
           Assert(map.find(1) != nullptr);
           Assert(map.at(1) == "1");
@@ -107,6 +107,126 @@ def test_provider_returning_pointer_success_with_annotation(IAnnot, XAnnot, XPtr
         source,
         locals())
 
+@pytest.mark.parametrize('I1Annot,I2Annot,XAnnot,WithAnnot', [
+    ('I1', 'I2', 'X', 'WithNoAnnot'),
+    ('fruit::Annotated<Annotation1, I1>', 'fruit::Annotated<Annotation2, I2>', 'fruit::Annotated<Annotation2, X>', 'WithAnnot1'),
+])
+@pytest.mark.parametrize('XBinding', [
+    'registerConstructor<XAnnot()>()',
+    'registerProvider<XAnnot()>([](){return X();})',
+])
+def test_chained_compression_success(XBinding, I1Annot, I2Annot, XAnnot, WithAnnot):
+    source = '''
+        struct I1 {
+          int value = 5;
+        };
+
+        struct Padding {
+          int padding = 7;
+        };
+
+        // Padding is the first base so that the casts X->I2->I1 change the pointer.
+        struct I2 : public Padding, public I1 {
+        };
+
+        struct X : public I2, ConstructionTracker<X> {
+        };
+
+        fruit::Component<I1Annot> getComponent() {
+          return fruit::createComponent()
+            .XBinding
+            .bind<I1Annot, I2Annot>()
+            .bind<I2Annot, XAnnot>();
+        }
+
+        int main() {
+          fruit::Injector<I1Annot> injector(getComponent);
+          Assert((injector.get<WithAnnot<I1*>>()->value == 5));
+          Assert((injector.get<WithAnnot<const I1&>>().value == 5));
+          // Both the I1->I2 and the I2->X edges have been compressed.
+          Assert(fruit::impl::InjectorAccessorForTests::unsafeGet<I2Annot>(injector) == nullptr);
+          Assert(fruit::impl::InjectorAccessorForTests::unsafeGet<XAnnot>(injector) == nullptr);
+          Assert(X::num_objects_constructed == 1);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_chained_compression_stops_at_type_with_other_dependents():
+    source = '''
+        struct I1 {
+          int value = 5;
+        };
+
+        struct I2 : public I1 {
+        };
+
+        struct X : public I2, ConstructionTracker<X> {
+          INJECT(X()) = default;
+        };
+
+        struct Y {
+          // Y depends on I2, so the I1->I2 edge can't be compressed.
+          INJECT(Y(I2* i2)) {
+            Assert(i2->value == 5);
+          }
+        };
+
+        fruit::Component<I1, Y> getComponent() {
+          return fruit::createComponent()
+            .bind<I1, I2>()
+            .bind<I2, X>();
+        }
+
+        int main() {
+          fruit::Injector<I1, Y> injector(getComponent);
+          Assert(injector.get<I1*>()->value == 5);
+          injector.get<Y*>();
+          Assert(fruit::impl::InjectorAccessorForTests::unsafeGet<I2>(injector) != nullptr);
+          Assert(fruit::impl::InjectorAccessorForTests::unsafeGet<X>(injector) == nullptr);
+          Assert(X::num_objects_constructed == 1);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source)
+
+def test_chained_compression_with_normalized_component():
+    source = '''
+        struct I1 {
+          int value = 5;
+        };
+
+        struct I2 : public I1 {
+        };
+
+        struct X : public I2, ConstructionTracker<X> {
+          INJECT(X()) = default;
+        };
+
+        fruit::Component<I1> getComponent() {
+          return fruit::createComponent()
+            .bind<I1, I2>()
+            .bind<I2, X>();
+        }
+
+        fruit::Component<> getEmptyComponent() {
+          return fruit::createComponent();
+        }
+
+        int main() {
+          fruit::NormalizedComponent<I1> normalizedComponent(getComponent);
+          fruit::Injector<I1> injector(normalizedComponent, getEmptyComponent);
+          Assert(injector.get<I1*>()->value == 5);
+          Assert(X::num_objects_constructed == 1);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source)
+
 def test_compression_undone():
     source = '''
         struct I1 {};
@@ -20,12 +20,18 @@ COMMON_DEFINITIONS = '''
 
 FRUIT_PUBLIC_HEADERS = [
     "component.h",
+    "emplacer.h",
+    "factory_ref.h",
     "fruit.h",
     "fruit_forward_decls.h",
     "injector.h",
+    "injector_reclaimer.h",
     "macro.h",
+    "memory_resource.h",
     "normalized_component.h",
+    "pooled_ptr.h",
     "provider.h",
+    "span.h",
 ]
 
 @pytest.mark.parametrize('HeaderFile', FRUIT_PUBLIC_HEADERS)
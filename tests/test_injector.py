@@ -252,6 +252,167 @@ def test_injector_get_const_binding_ok(XBindingInInjector, XInjectorGetParam):
         source,
         locals())
 
+@pytest.mark.parametrize('XBindingInInjector,XInjectorGetParam', [
+    ('X', 'X'),
+    ('X', 'const X&'),
+    ('X', 'X*'),
+    ('X', 'std::shared_ptr<X>'),
+    ('fruit::Annotated<Annotation1, X>', 'fruit::Annotated<Annotation1, X>'),
+    ('fruit::Annotated<Annotation1, X>', 'fruit::Annotated<Annotation1, X&>'),
+    ('fruit::Annotated<Annotation1, X>', 'fruit::Annotated<Annotation1, const X*>'),
+])
+def test_injector_get_all_ok(XBindingInInjector, XInjectorGetParam):
+    source = '''
+        static bool z_constructed = false;
+
+        struct X {
+          using Inject = X();
+        };
+
+        struct Y {
+          using Inject = Y();
+        };
+
+        struct Z {
+          INJECT(Z()) {
+            z_constructed = true;
+          }
+        };
+
+        fruit::Component<XBindingInInjector, Y, Z> getComponent() {
+          return fruit::createComponent();
+        }
+
+        int main() {
+          fruit::Injector<XBindingInInjector, Y, Z> injector(getComponent);
+
+          auto t = injector.getAll<XInjectorGetParam, Y*, fruit::Provider<Z>>();
+          auto x = std::get<0>(t);
+          (void)x;
+          Assert(std::get<1>(t) == injector.get<Y*>());
+          // Types requested as a Provider are not constructed.
+          Assert(!z_constructed);
+          Assert(std::get<2>(t).get<Z*>() == injector.get<Z*>());
+          Assert(z_constructed);
+
+          std::tuple<> empty = injector.getAll<>();
+          (void)empty;
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_injector_get_all_same_objects_as_get():
+    source = '''
+        struct X {
+          INJECT(X()) = default;
+        };
+
+        struct Y {
+          X& x;
+          INJECT(Y(X& x)) : x(x) {}
+        };
+
+        struct Z {
+          Y& y;
+          INJECT(Z(Y& y)) : y(y) {}
+        };
+
+        fruit::Component<X, Y, Z> getComponent() {
+          return fruit::createComponent();
+        }
+
+        int main() {
+          fruit::Injector<X, Y, Z> injector(getComponent);
+          Y* y = injector.get<Y*>();
+
+          // Z and its deps are constructed together, while Y was already constructed.
+          std::tuple<Z&, Y*, X*> t = injector.getAll<Z&, Y*, X*>();
+          Assert(std::get<1>(t) == y);
+          Assert(&(std::get<0>(t).y) == y);
+          Assert(std::get<2>(t) == &(y->x));
+          Assert(&(injector.get<Z&>()) == &(std::get<0>(t)));
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_injector_get_all_thread_local():
+    source = '''
+        #include <thread>
+
+        struct I {
+          virtual ~I() = default;
+        };
+
+        struct X : public I, public ConstructionTracker<X> {
+        };
+
+        struct Y {
+          INJECT(Y()) = default;
+        };
+
+        fruit::Component<X, I, Y> getComponent() {
+          return fruit::createComponent()
+            .registerThreadLocal<X()>()
+            .bind<I, X>();
+        }
+
+        int main() {
+          fruit::Injector<X, I, Y> injector(getComponent);
+          std::tuple<X*, I*, Y*> t = injector.getAll<X*, I*, Y*>();
+          Assert(std::get<0>(t) == injector.get<X*>());
+          Assert(std::get<1>(t) == injector.get<I*>());
+          Assert(std::get<1>(t) == static_cast<I*>(std::get<0>(t)));
+          Assert(std::get<2>(t) == injector.get<Y*>());
+
+          std::thread thread([&]() {
+            std::tuple<I*, X*> threadT = injector.getAll<I*, X*>();
+            Assert(std::get<1>(threadT) != std::get<0>(t));
+            Assert(std::get<1>(threadT) == injector.get<X*>());
+            Assert(std::get<0>(threadT) == static_cast<I*>(std::get<1>(threadT)));
+          });
+          thread.join();
+
+          Assert(X::num_objects_constructed == 2);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source)
+
+@pytest.mark.parametrize('XAnnot,YAnnot', [
+    ('X', 'Y'),
+    ('fruit::Annotated<Annotation1, X>', 'fruit::Annotated<Annotation2, Y>'),
+])
+def test_injector_get_all_error_type_not_provided(XAnnot, YAnnot):
+    source = '''
+        struct X {
+          using Inject = X();
+        };
+
+        struct Y {};
+
+        fruit::Component<XAnnot> getComponent() {
+          return fruit::createComponent();
+        }
+
+        int main() {
+          fruit::Injector<XAnnot> injector(getComponent);
+          injector.getAll<XAnnot, YAnnot>();
+        }
+        '''
+    expect_compile_error(
+        'TypeNotProvidedError<YAnnot>',
+        'Trying to get an instance of T, but it is not provided by this Provider/Injector.',
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
 @pytest.mark.parametrize('XVariant,XVariantRegex', [
     ('X**', r'X\*\*'),
     ('std::shared_ptr<X>*', r'std::shared_ptr<X>\*'),
@@ -299,5 +460,706 @@ def test_injector_get_error_array_type(XVariant,XVariantRegex):
         source,
         locals())
 
+@pytest.mark.parametrize('XAnnot,X_ANNOT,XPtrAnnot', [
+    ('X', 'X&', 'X*'),
+    ('fruit::Annotated<Annotation1, X>', 'ANNOTATED(Annotation1, X&)', 'fruit::Annotated<Annotation1, X*>'),
+])
+def test_create_child_shares_parent_objects(XAnnot, X_ANNOT, XPtrAnnot):
+    source = '''
+        struct X : public ConstructionTracker<X> {
+          INJECT(X()) = default;
+        };
+
+        struct Request {
+          int id;
+        };
+
+        struct Y : public ConstructionTracker<Y> {
+          X& x;
+          Request& request;
+          INJECT(Y(X_ANNOT x, Request& request)) : x(x), request(request) {}
+        };
+
+        struct Listener {};
+
+        fruit::Component<XAnnot> getParentComponent() {
+          static Listener listener;
+          return fruit::createComponent()
+            .addInstanceMultibinding(listener);
+        }
+
+        fruit::Component<fruit::Required<XAnnot>, Y> getRequestComponent(Request* request) {
+          return fruit::createComponent()
+            .bindInstance(*request);
+        }
+
+        int main() {
+          fruit::Injector<XAnnot> injector(getParentComponent);
+          X* x = injector.get<XPtrAnnot>();
+
+          for (int i = 0; i < 3; ++i) {
+            Request request{i};
+            fruit::Injector<Y, XAnnot> child = injector.createChild<Y, XAnnot>(getRequestComponent, &request);
+            Y& y = child.get<Y&>();
+            Assert(&(y.x) == x);
+            Assert(y.request.id == i);
+            Assert(child.get<XPtrAnnot>() == x);
+            Assert(child.getMultibindings<Listener>().size() == 1);
+          }
+
+          Assert(X::num_objects_constructed == 1);
+          Assert(Y::num_objects_constructed == 3);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_create_child_gets_parent_objects_when_needed():
+    source = '''
+        struct X : public ConstructionTracker<X> {
+          INJECT(X()) = default;
+        };
+
+        struct Y : public ConstructionTracker<Y> {
+          X& x;
+          INJECT(Y(X& x)) : x(x) {}
+        };
+
+        fruit::Component<X> getParentComponent() {
+          return fruit::createComponent();
+        }
+
+        fruit::Component<fruit::Required<X>, Y> getChildComponent() {
+          return fruit::createComponent();
+        }
+
+        int main() {
+          fruit::Injector<X> injector(getParentComponent);
+          fruit::Injector<Y> child = injector.createChild<Y>(getChildComponent);
+          Assert(X::num_objects_constructed == 0);
+
+          Y& y = child.get<Y&>();
+          Assert(X::num_objects_constructed == 1);
+          Assert(&(y.x) == injector.get<X*>());
+          Assert(X::num_objects_constructed == 1);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source)
+
+@pytest.mark.parametrize('XAnnot,XPtrAnnot', [
+    ('X', 'X*'),
+    ('fruit::Annotated<Annotation1, X>', 'fruit::Annotated<Annotation1, X*>'),
+])
+def test_create_child_uses_thread_local_objects_of_parent(XAnnot, XPtrAnnot):
+    source = '''
+        #include <thread>
+
+        struct X {
+          static std::atomic<int> num_objects_constructed;
+          X() {
+            ++num_objects_constructed;
+          }
+        };
+
+        std::atomic<int> X::num_objects_constructed(0);
+
+        fruit::Component<XAnnot> getParentComponent() {
+          return fruit::createComponent()
+            .registerThreadLocal<XAnnot()>();
+        }
+
+        fruit::Component<fruit::Required<XAnnot>> getChildComponent() {
+          return fruit::createComponent();
+        }
+
+        int main() {
+          fruit::Injector<XAnnot> injector(getParentComponent);
+          fruit::Injector<XAnnot> child = injector.createChild<XAnnot>(getChildComponent);
+          X* x = child.get<XPtrAnnot>();
+          Assert(x == injector.get<XPtrAnnot>());
+
+          const int num_threads = 4;
+          bool same_as_parent[num_threads] = {};
+          bool same_as_main_thread[num_threads] = {};
+          std::thread threads[num_threads];
+          for (int i = 0; i < num_threads; ++i) {
+            threads[i] = std::thread([&, i]() {
+              X* thread_x = child.get<XPtrAnnot>();
+              same_as_parent[i] = injector.get<XPtrAnnot>() == thread_x && child.get<XPtrAnnot>() == thread_x;
+              same_as_main_thread[i] = thread_x == x;
+            });
+          }
+          for (std::thread& thread : threads) {
+            thread.join();
+          }
+
+          for (int i = 0; i < num_threads; ++i) {
+            Assert(same_as_parent[i]);
+            Assert(!same_as_main_thread[i]);
+          }
+          Assert(X::num_objects_constructed == 1 + num_threads);
+          Assert(child.get<XPtrAnnot>() == x);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+@pytest.mark.parametrize('XAnnot', [
+    'X',
+    'fruit::Annotated<Annotation1, X>',
+])
+def test_create_child_error_requirement_not_provided_by_parent(XAnnot):
+    source = '''
+        struct X {};
+
+        fruit::Component<fruit::Required<XAnnot>> getChildComponent();
+
+        void f(fruit::Injector<> injector) {
+          injector.createChild<>(getChildComponent);
+        }
+        '''
+    expect_compile_error(
+        'UnsatisfiedRequirementsInChildInjectorError<XAnnot>',
+        'The requirements in UnsatisfiedRequirements are required by the component passed to createChild\(\) but are not provided by the parent injector.',
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+@pytest.mark.parametrize('XAnnot,XPtrAnnot', [
+    ('X', 'X*'),
+    ('fruit::Annotated<Annotation1, X>', 'fruit::Annotated<Annotation1, X*>'),
+])
+def test_memory_resource(XAnnot, XPtrAnnot):
+    source = '''
+        struct X {
+          INJECT(X()) = default;
+        };
+
+        struct Request {
+          int id;
+        };
+
+        struct Listener {};
+
+        struct CountingMemoryResource : public fruit::MemoryResource {
+          std::size_t num_allocations = 0;
+          std::size_t num_live_allocations = 0;
+
+          void* allocate(std::size_t bytes, std::size_t alignment) override {
+            void* p = operator new(bytes);
+            Assert(std::uintptr_t(p) % alignment == 0);
+            ++num_allocations;
+            ++num_live_allocations;
+            return p;
+          }
+
+          void deallocate(void* p, std::size_t, std::size_t) override {
+            --num_live_allocations;
+            operator delete(p);
+          }
+        };
+
+        fruit::Component<fruit::Required<Request>, XAnnot> getComponent() {
+          static Listener listener;
+          return fruit::createComponent()
+            .addInstanceMultibinding(listener);
+        }
+
+        fruit::Component<Request> getRequestComponent(Request* request) {
+          return fruit::createComponent()
+            .bindInstance(*request);
+        }
+
+        fruit::Component<XAnnot> getRootComponent() {
+          static Request request{0};
+          return fruit::createComponent()
+            .install(getComponent)
+            .install(getRequestComponent, &request);
+        }
+
+        int main() {
+          CountingMemoryResource normalized_component_resource;
+          CountingMemoryResource injector_resource;
+          {
+            fruit::Injector<XAnnot> injector(injector_resource, getRootComponent);
+            Assert(injector.get<XPtrAnnot>() != nullptr);
+            Assert(injector.getMultibindings<Listener>().size() == 1);
+            Assert(injector_resource.num_allocations != 0);
+          }
+          Assert(injector_resource.num_live_allocations == 0);
+
+          {
+            fruit::NormalizedComponent<fruit::Required<Request>, XAnnot> normalized_component(
+                normalized_component_resource, getComponent);
+            std::size_t num_normalized_component_allocations = normalized_component_resource.num_allocations;
+            Assert(num_normalized_component_allocations != 0);
+            for (int i = 0; i < 3; ++i) {
+              injector_resource.num_allocations = 0;
+              Request request{i};
+              fruit::Injector<XAnnot> injector(injector_resource, normalized_component, getRequestComponent, &request);
+              Assert(injector.get<XPtrAnnot>() != nullptr);
+              Assert(injector.getMultibindings<Listener>().size() == 1);
+              Assert(injector_resource.num_allocations != 0);
+            }
+            Assert(injector_resource.num_live_allocations == 0);
+            Assert(normalized_component_resource.num_allocations == num_normalized_component_allocations);
+          }
+          Assert(normalized_component_resource.num_live_allocations == 0);
+
+          {
+            CountingMemoryResource child_resource;
+            fruit::Injector<XAnnot> parent(injector_resource, getRootComponent);
+            std::size_t num_parent_allocations = injector_resource.num_allocations;
+            for (int i = 0; i < 3; ++i) {
+              Request request{i};
+              {
+                // By default, the child uses the MemoryResource of the parent.
+                fruit::Injector<XAnnot, Request> child =
+                    parent.createChild<XAnnot, Request>(getRequestComponent, &request);
+                Assert(child.get<XPtrAnnot>() == parent.get<XPtrAnnot>());
+                Assert(child.get<Request*>() == &request);
+                Assert(injector_resource.num_allocations > num_parent_allocations);
+              }
+              num_parent_allocations = injector_resource.num_allocations;
+              {
+                fruit::Injector<XAnnot, Request> child =
+                    parent.createChild<XAnnot, Request>(child_resource, getRequestComponent, &request);
+                Assert(child.get<XPtrAnnot>() == parent.get<XPtrAnnot>());
+                Assert(child.get<Request*>() == &request);
+                Assert(child_resource.num_allocations != 0);
+                Assert(injector_resource.num_allocations == num_parent_allocations);
+              }
+              Assert(child_resource.num_live_allocations == 0);
+            }
+          }
+          Assert(injector_resource.num_live_allocations == 0);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+@pytest.mark.parametrize('XAnnot,XPtrAnnot', [
+    ('X', 'X*'),
+    ('fruit::Annotated<Annotation1, X>', 'fruit::Annotated<Annotation1, X*>'),
+])
+def test_lazy_object_storage(XAnnot, XPtrAnnot):
+    source = '''
+        static int num_objects_destroyed = 0;
+
+        struct X {
+          INJECT(X()) = default;
+          ~X() {
+            ++num_objects_destroyed;
+          }
+        };
+
+        template <int N>
+        struct Y {
+          INJECT(Y()) = default;
+          ~Y() {
+            ++num_objects_destroyed;
+          }
+          // Large enough that the objects can't all fit in a single chunk.
+          char data[1000];
+        };
+
+        struct Listener {};
+
+        fruit::Component<XAnnot, Y<1>, Y<2>, Y<3>, Y<4>, Y<5>> getComponent() {
+          static Listener listener;
+          return fruit::createComponent()
+            .addInstanceMultibinding(listener);
+        }
+
+        fruit::Component<> getEmptyComponent() {
+          return fruit::createComponent();
+        }
+
+        int main() {
+          {
+            fruit::Injector<XAnnot, Y<1>, Y<2>, Y<3>, Y<4>, Y<5>> injector(fruit::LazyObjectStorage(), getComponent);
+            Y<1>* y1 = injector.get<Y<1>*>();
+            Y<5>* y5 = injector.get<Y<5>*>();
+            Y<3>* y3 = injector.get<Y<3>*>();
+            Assert(injector.get<Y<1>*>() == y1);
+            Assert(injector.get<Y<5>*>() == y5);
+            Assert(injector.get<Y<3>*>() == y3);
+            Assert(injector.getMultibindings<Listener>().size() == 1);
+          }
+          Assert(num_objects_destroyed == 3);
+
+          num_objects_destroyed = 0;
+          {
+            fruit::NormalizedComponent<XAnnot, Y<1>, Y<2>, Y<3>, Y<4>, Y<5>> normalized_component(getComponent);
+            for (int i = 0; i < 3; ++i) {
+              fruit::Injector<XAnnot, Y<1>, Y<2>, Y<3>, Y<4>, Y<5>> injector(
+                  fruit::LazyObjectStorage(), normalized_component, getEmptyComponent);
+              if (i != 0) {
+                Assert(injector.get<XPtrAnnot>() != nullptr);
+                injector.eagerlyInjectAll();
+              }
+            }
+          }
+          Assert(num_objects_destroyed == 2 * 6);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+@pytest.mark.parametrize('NumThreads', [
+    '1',
+    '4',
+])
+def test_injector_reclaimer(NumThreads):
+    source = '''
+        static std::atomic<int> num_objects_destroyed(0);
+        static std::thread::id main_thread_id;
+        static std::atomic<bool> destroyed_in_main_thread(false);
+
+        struct Y {
+          bool alive = true;
+
+          INJECT(Y()) = default;
+          ~Y() {
+            if (std::this_thread::get_id() == main_thread_id) {
+              destroyed_in_main_thread = true;
+            }
+            alive = false;
+            ++num_objects_destroyed;
+          }
+        };
+
+        struct X {
+          Y* y;
+          INJECT(X(Y* y)) : y(y) {}
+          ~X() {
+            // Y is destroyed after X.
+            Assert(y->alive);
+            ++num_objects_destroyed;
+          }
+        };
+
+        fruit::Component<X> getComponent() {
+          return fruit::createComponent();
+        }
+
+        fruit::Component<> getEmptyComponent() {
+          return fruit::createComponent();
+        }
+
+        int main() {
+          main_thread_id = std::this_thread::get_id();
+          fruit::NormalizedComponent<X> normalized_component(getComponent);
+          {
+            fruit::InjectorReclaimer reclaimer(NumThreads);
+            for (int i = 0; i < 100; ++i) {
+              fruit::Injector<X> injector(normalized_component, getEmptyComponent);
+              Assert(injector.get<X*>()->y != nullptr);
+              reclaimer.reclaim(std::move(injector));
+            }
+            reclaimer.waitUntilIdle();
+            Assert(num_objects_destroyed == 200);
+
+            fruit::Injector<X> injector(normalized_component, getEmptyComponent);
+            injector.get<X*>();
+            reclaimer.reclaim(std::move(injector));
+          }
+          Assert(num_objects_destroyed == 202);
+          Assert(!destroyed_in_main_thread);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_process_lifetime_types():
+    source = '''
+        static int num_objects_destroyed = 0;
+
+        struct Y {
+          INJECT(Y()) = default;
+          ~Y() {
+            ++num_objects_destroyed;
+          }
+        };
+
+        struct X {
+          INJECT(X(Y*)) {}
+          ~X() {
+            // X is never destroyed.
+            Assert(false);
+          }
+        };
+
+        namespace fruit {
+        template <>
+        struct ProcessLifetime<X> : public std::true_type {};
+        }
+
+        fruit::Component<X> getComponent() {
+          return fruit::createComponent();
+        }
+
+        int main() {
+          {
+            fruit::Injector<X> injector(getComponent);
+            injector.get<X*>();
+          }
+          Assert(num_objects_destroyed == 1);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+@pytest.mark.skipif(
+    run_under_valgrind,
+    reason = 'The storage of a process-lifetime injector is intentionally leaked, so Valgrind reports it.')
+def test_process_lifetime_injector():
+    source = '''
+        static std::vector<int> destroyed;
+
+        struct Z {
+          INJECT(Z()) = default;
+          ~Z() {
+            destroyed.push_back(3);
+          }
+        };
+
+        struct Y {
+          INJECT(Y(Z*)) {}
+          ~Y() {
+            destroyed.push_back(2);
+          }
+        };
+
+        struct X {
+          INJECT(X(Y*)) {}
+          ~X() {
+            destroyed.push_back(1);
+          }
+        };
+
+        namespace fruit {
+        template <>
+        struct RunDestructorAtExit<X> : public std::true_type {};
+        template <>
+        struct RunDestructorAtExit<Z> : public std::true_type {};
+        }
+
+        fruit::Component<X> getComponent() {
+          return fruit::createComponent();
+        }
+
+        int main() {
+          {
+            fruit::Injector<X> injector(getComponent);
+            injector.get<X*>();
+            injector.setProcessLifetime();
+          }
+          // Y is leaked, X and Z are still destroyed in reverse construction order.
+          Assert(destroyed == std::vector<int>({1, 3}));
+
+          destroyed.clear();
+          {
+            fruit::Injector<X> injector(getComponent);
+            injector.get<X*>();
+          }
+          Assert(destroyed == std::vector<int>({1, 2, 3}));
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+@pytest.mark.parametrize('XAnnot,X_ANNOT,XPtrAnnot,XRefAnnot', [
+    ('X', 'X&', 'X*', 'X&'),
+    ('fruit::Annotated<Annotation1, X>', 'ANNOTATED(Annotation1, X&)', 'fruit::Annotated<Annotation1, X*>', 'fruit::Annotated<Annotation1, X&>'),
+])
+def test_small_objects_stored_inline(XAnnot, X_ANNOT, XPtrAnnot, XRefAnnot):
+    source = '''
+        // Marked with fruit::StoredInline, so these objects are constructed in the injector's graph.
+        struct X {
+          X* self;
+          INJECT(X()) : self(this) {}
+        };
+
+        // Also small and trivially copyable, but not marked.
+        struct Size {
+          std::size_t value;
+        };
+
+        struct Port {
+          Port* self;
+          int value;
+        };
+
+        namespace fruit {
+        template <>
+        struct StoredInline<X> : public std::true_type {};
+
+        template <>
+        struct StoredInline<Port> : public std::true_type {};
+        }
+
+        Port* emplaced_port = nullptr;
+
+        struct Y {
+          X& x;
+          Size size;
+          Port& port;
+          INJECT(Y(X_ANNOT x, Size size, Port& port)) : x(x), size(size), port(port) {}
+        };
+
+        fruit::Component<XAnnot, Size, Port, Y> getComponent() {
+          return fruit::createComponent()
+            .registerProvider([]() { return Size{42}; })
+            // Providers are never stored inline, even for types marked with fruit::StoredInline.
+            .registerProvider([](fruit::Emplacer<Port> emplace) {
+              Port* port = emplace(Port{nullptr, 3});
+              port->self = port;
+              emplaced_port = port;
+              return port;
+            });
+        }
+
+        struct Z {
+          X& x;
+          Size& size;
+          INJECT(Z(X_ANNOT x, Size& size)) : x(x), size(size) {}
+        };
+
+        fruit::Component<fruit::Required<XAnnot, Size>, Z> getChildComponent() {
+          return fruit::createComponent();
+        }
+
+        fruit::Component<> getEmptyComponent() {
+          return fruit::createComponent();
+        }
+
+        int main() {
+          fruit::Injector<XAnnot, Size, Port, Y> injector(getComponent);
+          Y* y = injector.get<Y*>();
+          X* x = injector.get<XPtrAnnot>();
+          Assert(&(y->x) == x);
+          // The object is constructed in place, so `this' in the constructor is the object returned by get().
+          Assert(x->self == x);
+          Assert(&(injector.get<XRefAnnot>()) == x);
+          Assert(injector.get<Size>().value == 42);
+          Assert(injector.get<Size*>() == injector.get<Size*>());
+          Assert(injector.get<Port*>() == emplaced_port);
+          Assert(&(y->port) == emplaced_port);
+          Assert(emplaced_port->self == emplaced_port);
+
+          fruit::Injector<Z> child = injector.createChild<Z>(getChildComponent);
+          Assert(&(child.get<Z&>().x) == x);
+          Assert(&(child.get<Z&>().size) == injector.get<Size*>());
+
+          fruit::NormalizedComponent<XAnnot, Size, Port, Y> normalized_component(
+              fruit::SharedSingletons<XAnnot>(), getComponent);
+          X* shared_x = nullptr;
+          for (int i = 0; i < 2; ++i) {
+            fruit::Injector<XAnnot, Size, Port, Y> injector2(normalized_component, getEmptyComponent);
+            if (shared_x == nullptr) {
+              shared_x = injector2.get<XPtrAnnot>();
+            }
+            Assert(shared_x->self == shared_x);
+            Assert(&(injector2.get<Y&>().x) == shared_x);
+            Assert(injector2.get<Size>().value == 42);
+          }
+
+          fruit::NormalizedComponent<XAnnot, Size, Port, Y> normalized_component2(getComponent);
+          fruit::Injector<XAnnot, Size, Port, Y> injector3(normalized_component2, getEmptyComponent);
+          X* x3 = injector3.get<XPtrAnnot>();
+          Assert(x3->self == x3);
+          Assert(&(injector3.get<Y&>().x) == x3);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_long_chain_of_deps():
+    source = '''
+        static int num_constructed = 0;
+        static bool lazy_constructed = false;
+
+        struct Lazy {
+          INJECT(Lazy()) {
+            lazy_constructed = true;
+          }
+        };
+
+        template <int n>
+        struct Node {
+          int index;
+          INJECT(Node(Node<n - 1>& x)) : index(num_constructed++) {
+            // The deps are constructed before the objects that need them.
+            Assert(x.index < index);
+          }
+        };
+
+        template <>
+        struct Node<0> {
+          int index;
+          INJECT(Node(fruit::Provider<Lazy>)) : index(num_constructed++) {}
+        };
+
+        using Last = Node<12>;
+
+        fruit::Component<Last> getComponent() {
+          return fruit::createComponent();
+        }
+
+        fruit::Component<Node<6>, Last> getComponentWithMiddle() {
+          return fruit::createComponent();
+        }
+
+        fruit::Component<> getEmptyComponent() {
+          return fruit::createComponent();
+        }
+
+        int main() {
+          {
+            fruit::Injector<Last> injector(getComponent);
+            Assert(injector.get<Last&>().index == 12);
+            Assert(num_constructed == 13);
+          }
+          num_constructed = 0;
+          {
+            fruit::Injector<Node<6>, Last> injector(getComponentWithMiddle);
+            Assert(injector.get<Last&>().index == 12);
+            Assert(injector.get<Node<6>&>().index == 6);
+            Assert(num_constructed == 13);
+          }
+          num_constructed = 0;
+          {
+            fruit::NormalizedComponent<Last> normalized_component(getComponent);
+            fruit::Injector<Last> injector(normalized_component, getEmptyComponent);
+            Assert(injector.get<Last&>().index == 12);
+            Assert(num_constructed == 13);
+          }
+          Assert(!lazy_constructed);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
 if __name__== '__main__':
     main(__file__)
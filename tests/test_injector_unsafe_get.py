@@ -47,13 +47,13 @@ def test_success(XAnnot, YAnnot, ZAnnot):
           return fruit::createComponent();
         }
 
-        fruit::Component<> getRootComponent() {
+        fruit::Component<XAnnot> getRootComponent() {
           return fruit::createComponent()
               .install(getComponent);
         }
 
         int main() {
-          fruit::Injector<> injector(getRootComponent);
+          fruit::Injector<XAnnot> injector(getRootComponent);
           const X* x = fruit::impl::InjectorAccessorForTests::unsafeGet<XAnnot>(injector);
           const Y* y = fruit::impl::InjectorAccessorForTests::unsafeGet<YAnnot>(injector);
           const Z* z = fruit::impl::InjectorAccessorForTests::unsafeGet<ZAnnot>(injector);
@@ -71,5 +71,83 @@ def test_success(XAnnot, YAnnot, ZAnnot):
         source,
         locals())
 
+@pytest.mark.parametrize('XAnnot,YAnnot', [
+    ('X', 'Y'),
+    ('fruit::Annotated<Annotation1, X>', 'fruit::Annotated<Annotation2, Y>'),
+])
+def test_unreachable_bindings_removed(XAnnot, YAnnot):
+    source = '''
+        struct Y {
+          using Inject = Y();
+          Y() = default;
+        };
+
+        struct X {
+          using Inject = X(YAnnot);
+          X(Y) {
+          }
+        };
+
+        fruit::Component<XAnnot> getComponent() {
+          return fruit::createComponent();
+        }
+
+        fruit::Component<> getRootComponent() {
+          return fruit::createComponent()
+              .install(getComponent);
+        }
+
+        int main() {
+          // Nothing depends on X, so the injector doesn't keep the bindings for X and Y.
+          fruit::Injector<> injector(getRootComponent);
+          const X* x = fruit::impl::InjectorAccessorForTests::unsafeGet<XAnnot>(injector);
+          const Y* y = fruit::impl::InjectorAccessorForTests::unsafeGet<YAnnot>(injector);
+
+          (void) x;
+          (void) y;
+          Assert(x == nullptr);
+          Assert(y == nullptr);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_bindings_reachable_from_multibindings_kept():
+    source = '''
+        struct Y {
+          using Inject = Y();
+          Y() = default;
+        };
+
+        struct X {
+          using Inject = X(Y*);
+          X(Y*) {
+          }
+        };
+
+        struct Z {
+          using Inject = Z();
+          Z() = default;
+        };
+
+        fruit::Component<> getRootComponent() {
+          return fruit::createComponent()
+              .registerConstructor<Z()>()
+              .addMultibinding<X, X>();
+        }
+
+        int main() {
+          fruit::Injector<> injector(getRootComponent);
+          Assert(injector.getMultibindings<X>().size() == 1);
+          Assert(fruit::impl::InjectorAccessorForTests::unsafeGet<Y>(injector) != nullptr);
+          Assert(fruit::impl::InjectorAccessorForTests::unsafeGet<Z>(injector) == nullptr);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source)
+
 if __name__== '__main__':
     main(__file__)
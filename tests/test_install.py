@@ -883,6 +883,144 @@ def test_install_component_functions_different_args_not_deduped(XAnnot):
         source,
         locals())
 
+@pytest.mark.parametrize('XAnnot', [
+    'X',
+    'fruit::Annotated<Annotation1, X>',
+])
+def test_install_component_functions_with_no_args_cached_across_injectors(XAnnot):
+    source = '''
+        struct X {};
+
+        X x;
+
+        int num_calls_with_args = 0;
+        int num_calls_with_no_args = 0;
+
+        fruit::Component<> getComponent(int) {
+          ++num_calls_with_args;
+          return fruit::createComponent()
+            .addInstanceMultibinding<XAnnot, X>(x);
+        }
+
+        fruit::Component<> getComponent2() {
+          ++num_calls_with_no_args;
+          return fruit::createComponent()
+            .install(getComponent, 1)
+            .install(getComponent, 2);
+        }
+
+        int main() {
+          for (int i = 1; i <= 3; ++i) {
+            fruit::Injector<> injector(getComponent2);
+
+            std::vector<X*> multibindings = injector.getMultibindings<XAnnot>();
+            Assert(multibindings.size() == 2);
+            Assert(multibindings[0] == &x);
+            Assert(multibindings[1] == &x);
+
+            // getComponent2 is only called for the first injector, while components with args are not cached.
+            Assert(num_calls_with_no_args == 1);
+            Assert(num_calls_with_args == 2 * i);
+          }
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_install_component_functions_with_no_args_evicted_from_cache():
+    source = '''
+        struct X {
+          using Inject = X();
+        };
+
+        int num_calls = 0;
+
+        fruit::Component<X> getComponent() {
+          ++num_calls;
+          return fruit::createComponent();
+        }
+
+        void createInjector() {
+          fruit::Injector<X> injector(getComponent);
+          injector.get<X>();
+        }
+
+        int main() {
+          createInjector();
+          createInjector();
+          Assert(num_calls == 1);
+
+          fruit::evictComponentFromCache(getComponent);
+          createInjector();
+          createInjector();
+          Assert(num_calls == 2);
+
+          fruit::clearComponentCache();
+          createInjector();
+          Assert(num_calls == 3);
+
+          // Evicting a function that's not in the cache is a no-op.
+          fruit::clearComponentCache();
+          fruit::evictComponentFromCache(getComponent);
+          createInjector();
+          Assert(num_calls == 4);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_install_component_functions_with_no_args_cache_used_from_multiple_threads():
+    source = '''
+        #include <thread>
+
+        struct X {};
+
+        X x;
+
+        fruit::Component<> getComponent(int) {
+          return fruit::createComponent()
+            .addInstanceMultibinding(x);
+        }
+
+        fruit::Component<> getComponent2() {
+          return fruit::createComponent()
+            .install(getComponent, 1)
+            .install(getComponent, 2);
+        }
+
+        int main() {
+          const int num_threads = 4;
+          bool ok[num_threads] = {};
+          std::thread threads[num_threads];
+          for (int i = 0; i < num_threads; ++i) {
+            threads[i] = std::thread([&, i]() {
+              ok[i] = true;
+              for (int j = 0; j < 50; ++j) {
+                if (i == 0 && j % 10 == 0) {
+                  fruit::clearComponentCache();
+                }
+                fruit::Injector<> injector(getComponent2);
+                ok[i] = ok[i] && injector.getMultibindings<X>().size() == 2;
+              }
+            });
+          }
+          for (std::thread& thread : threads) {
+            thread.join();
+          }
+          for (int i = 0; i < num_threads; ++i) {
+            Assert(ok[i]);
+          }
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
 def test_install_component_functions_loop():
     source = '''
         struct X {};
@@ -45,6 +45,48 @@ def test_get_none():
         COMMON_DEFINITIONS,
         source)
 
+def test_get_span_returns_same_array_each_time():
+    source = '''
+        fruit::Component<> getComponent() {
+          static int n1 = 1;
+          static int n2 = 2;
+          return fruit::createComponent()
+            .addInstanceMultibinding(n1)
+            .addInstanceMultibinding(n2)
+            .addMultibindingProvider([](){ return 3; });
+        }
+
+        int main() {
+          fruit::Injector<> injector(getComponent);
+
+          fruit::Span<int* const> multibindings = injector.getMultibindingsSpan<int>();
+          Assert(multibindings.size() == 3);
+          Assert(!multibindings.empty());
+          int sum = 0;
+          for (int* p : multibindings) {
+            sum += *p;
+          }
+          Assert(sum == 6);
+
+          fruit::Span<int* const> multibindings2 = injector.getMultibindingsSpan<int>();
+          Assert(multibindings2.size() == 3);
+          Assert(multibindings2.data() == multibindings.data());
+          for (std::size_t i = 0; i < multibindings.size(); ++i) {
+            Assert(multibindings2[i] == multibindings[i]);
+          }
+
+          const std::vector<int*>& vector = injector.getMultibindings<int>();
+          Assert(&injector.getMultibindings<int>() == &vector);
+          Assert(std::vector<int*>(multibindings) == vector);
+
+          Assert(injector.getMultibindingsSpan<double>().empty());
+          Assert(injector.getMultibindings<double>().empty());
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source)
+
 def test_multiple_various_kinds():
     source = '''
         static int numNotificationsToListener1 = 0;
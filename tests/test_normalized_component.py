@@ -202,5 +202,157 @@ def test_injector_from_normalized_component_nonconst_requirements_provided_as_co
         source,
         locals())
 
+@pytest.mark.parametrize('XAnnot,X_ANNOT,XPtrAnnot', [
+    ('X', 'X&', 'X*'),
+    ('fruit::Annotated<Annotation1, X>', 'ANNOTATED(Annotation1, X&)', 'fruit::Annotated<Annotation1, X*>'),
+])
+def test_shared_singletons(XAnnot, X_ANNOT, XPtrAnnot):
+    source = '''
+        struct X : public ConstructionTracker<X> {
+          INJECT(X()) = default;
+        };
+
+        struct Request {
+          int id;
+        };
+
+        struct Y : public ConstructionTracker<Y> {
+          X& x;
+          Request& request;
+          INJECT(Y(X_ANNOT x, Request& request)) : x(x), request(request) {}
+        };
+
+        fruit::Component<fruit::Required<Request>, XAnnot, Y> getComponent() {
+          return fruit::createComponent();
+        }
+
+        fruit::Component<Request> getRequestComponent(Request* request) {
+          return fruit::createComponent()
+            .bindInstance(*request);
+        }
+
+        int main() {
+          fruit::NormalizedComponent<fruit::Required<Request>, XAnnot, Y> normalizedComponent(
+              fruit::SharedSingletons<XAnnot>(), getComponent);
+          Assert(X::num_objects_constructed == 1);
+
+          X* x = nullptr;
+          for (int i = 0; i < 3; ++i) {
+            Request request{i};
+            fruit::Injector<XAnnot, Y> injector(normalizedComponent, getRequestComponent, &request);
+            Y& y = injector.get<Y&>();
+            Assert(y.request.id == i);
+            if (x == nullptr) {
+              x = injector.get<XPtrAnnot>();
+            }
+            Assert(&(y.x) == x);
+          }
+
+          Assert(X::num_objects_constructed == 1);
+          Assert(Y::num_objects_constructed == 3);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_shared_singletons_with_interface_binding_and_impl_injected_in_injector():
+    source = '''
+        struct I {
+          virtual ~I() = default;
+        };
+
+        struct CImpl : public I, public ConstructionTracker<CImpl> {
+          INJECT(CImpl()) = default;
+        };
+
+        struct Y {
+          CImpl* c;
+          INJECT(Y(CImpl* c)) : c(c) {}
+        };
+
+        fruit::Component<I> getComponent() {
+          return fruit::createComponent()
+            .bind<I, CImpl>();
+        }
+
+        fruit::Component<Y> getYComponent() {
+          return fruit::createComponent();
+        }
+
+        int main() {
+          fruit::NormalizedComponent<I> normalizedComponent(fruit::SharedSingletons<I>(), getComponent);
+          Assert(CImpl::num_objects_constructed == 1);
+
+          I* i = nullptr;
+          for (int n = 0; n < 3; ++n) {
+            fruit::Injector<I, Y> injector(normalizedComponent, getYComponent);
+            if (i == nullptr) {
+              i = injector.get<I*>();
+            }
+            Assert(injector.get<I*>() == i);
+            Assert(injector.get<Y&>().c == static_cast<CImpl*>(i));
+          }
+
+          Assert(CImpl::num_objects_constructed == 1);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source)
+
+@pytest.mark.parametrize('XAnnot', [
+    'X',
+    'fruit::Annotated<Annotation1, X>',
+])
+def test_shared_singletons_error_type_not_provided(XAnnot):
+    source = '''
+        struct X {};
+        struct Y {};
+
+        fruit::Component<fruit::Required<XAnnot>, Y> getComponent();
+
+        int main() {
+          fruit::NormalizedComponent<fruit::Required<XAnnot>, Y> normalizedComponent(
+              fruit::SharedSingletons<XAnnot>(), getComponent);
+          (void) normalizedComponent;
+        }
+        '''
+    expect_compile_error(
+        'SharedSingletonsNotProvidedError<XAnnot>',
+        'The types in TypesNotProvided are marked as shared singletons of a NormalizedComponent, but the NormalizedComponent doesn.t provide them.',
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+@pytest.mark.parametrize('XAnnot,X_ANNOT,XAnnotRegex', [
+    ('X', 'X', '(struct )?X'),
+    ('fruit::Annotated<Annotation1, X>', 'ANNOTATED(Annotation1, X)', '(struct )?fruit::Annotated<(struct )?Annotation1, ?(struct )?X>'),
+])
+def test_shared_singletons_error_depends_on_requirement(XAnnot, X_ANNOT, XAnnotRegex):
+    source = '''
+        struct X {};
+
+        struct Y {
+          INJECT(Y(X_ANNOT)) {}
+        };
+
+        fruit::Component<fruit::Required<XAnnot>, Y> getComponent() {
+          return fruit::createComponent();
+        }
+
+        int main() {
+          fruit::NormalizedComponent<fruit::Required<XAnnot>, Y> normalizedComponent(
+              fruit::SharedSingletons<Y>(), getComponent);
+          (void) normalizedComponent;
+        }
+        '''
+    expect_runtime_error(
+        'Fatal injection error: the type XAnnotRegex is needed to construct the shared singletons of a NormalizedComponent, but it.s a requirement of that NormalizedComponent.',
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
 if __name__== '__main__':
     main(__file__)
@@ -585,6 +585,125 @@ def test_register_constructor_with_param_error_type_not_injectable(YVariant, YVa
         source,
         locals())
 
+@pytest.mark.parametrize('XAnnot,XPtrAnnot,intAnnot', [
+    ('X', 'X*', 'int'),
+    ('fruit::Annotated<Annotation1, X>', 'fruit::Annotated<Annotation1, X*>', 'fruit::Annotated<Annotation2, int>'),
+])
+def test_register_thread_local_success(XAnnot, XPtrAnnot, intAnnot):
+    source = '''
+        #include <thread>
+
+        struct X : public ConstructionTracker<X> {
+          static std::atomic<int> num_objects_destroyed;
+          int n;
+          X(int n) : n(n) {}
+          ~X() {
+            ++num_objects_destroyed;
+          }
+        };
+
+        std::atomic<int> X::num_objects_destroyed(0);
+
+        fruit::Component<XAnnot> getComponent() {
+          static int n = 5;
+          return fruit::createComponent()
+            .bindInstance<intAnnot, int>(n)
+            .registerThreadLocal<XAnnot(intAnnot)>();
+        }
+
+        int main() {
+          X* x = nullptr;
+          X* threadX = nullptr;
+          {
+            fruit::Injector<XAnnot> injector(getComponent);
+            x = injector.get<XPtrAnnot>();
+            Assert(x->n == 5);
+            Assert(injector.get<XPtrAnnot>() == x);
+
+            std::thread thread([&]() {
+              threadX = injector.get<XPtrAnnot>();
+              Assert(injector.get<XPtrAnnot>() == threadX);
+            });
+            thread.join();
+
+            Assert(threadX != x);
+            Assert(X::num_objects_constructed == 2);
+            // The object of the thread is destroyed when the thread exits.
+            Assert(X::num_objects_destroyed == 1);
+            Assert(injector.get<XPtrAnnot>() == x);
+          }
+          Assert(X::num_objects_destroyed == 2);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_register_thread_local_bound_to_interface():
+    source = '''
+        #include <thread>
+
+        struct I {
+          virtual ~I() = default;
+        };
+
+        struct X : public I {
+        };
+
+        struct Y {
+          fruit::Provider<I> provider;
+          INJECT(Y(fruit::Provider<I> provider)) : provider(provider) {}
+        };
+
+        fruit::Component<I, Y> getComponent() {
+          return fruit::createComponent()
+            .registerThreadLocal<X()>()
+            .bind<I, X>();
+        }
+
+        int main() {
+          fruit::Injector<I, Y> injector(getComponent);
+          Y* y = injector.get<Y*>();
+          I* i = injector.get<I*>();
+          Assert(y->provider.get<I*>() == i);
+
+          I* threadI = nullptr;
+          std::thread thread([&]() {
+            threadI = y->provider.get<I*>();
+            Assert(injector.get<I*>() == threadI);
+          });
+          thread.join();
+
+          Assert(threadI != i);
+          Assert(injector.get<I*>() == i);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source)
+
+@pytest.mark.parametrize('charPtrAnnot', [
+    'char*',
+    'fruit::Annotated<Annotation1, char*>',
+])
+def test_register_thread_local_constructor_does_not_exist_error(charPtrAnnot):
+    source = '''
+        struct X {
+          X(int*) {}
+        };
+
+        fruit::Component<X> getComponent() {
+          return fruit::createComponent()
+            .registerThreadLocal<X(charPtrAnnot)>();
+        }
+        '''
+    expect_compile_error(
+        'NoConstructorMatchingInjectSignatureError<X,X\(char\*\)>',
+        'contains an Inject typedef but it.s not constructible with the specified types',
+        COMMON_DEFINITIONS,
+        source,
+        locals())
 
 if __name__== '__main__':
     main(__file__)
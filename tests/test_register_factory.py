@@ -881,6 +881,264 @@ def test_autoinject_with_binding2_returning_value():
         COMMON_DEFINITIONS,
         source)
 
+def test_factory_ref_create_batch():
+    source = '''
+        struct Y {
+          INJECT(Y()) = default;
+        };
+
+        struct X {
+          Y* y;
+          int n;
+          std::string name;
+
+          INJECT(X(Y* y, ASSISTED(int) n, ASSISTED(const std::string&) name))
+            : y(y), n(n), name(name) {
+          }
+        };
+
+        struct Z {
+          INJECT(Z(ASSISTED(int) n))
+            : n(n) {
+          }
+
+          int n;
+        };
+
+        fruit::Component<std::function<X(int, const std::string&)>, std::function<Z(int)>> getComponent() {
+          return fruit::createComponent();
+        }
+
+        int main() {
+          fruit::Injector<std::function<X(int, const std::string&)>, std::function<Z(int)>> injector(getComponent);
+          fruit::FactoryRef<X(int, const std::string&)> xFactory = injector.get<fruit::FactoryRef<X(int, const std::string&)>>();
+          std::vector<X> xs = xFactory.createBatch(10, [](std::size_t i) {
+            return std::make_tuple(int(i), std::string(i, 'a'));
+          });
+          Assert(xs.size() == 10);
+          for (std::size_t i = 0; i < 10; ++i) {
+            Assert(xs[i].y == xs[0].y);
+            Assert(xs[i].n == int(i));
+            Assert(xs[i].name == std::string(i, 'a'));
+          }
+
+          fruit::FactoryRef<Z(int)> zFactory = injector.get<fruit::FactoryRef<Z(int)>>();
+          std::vector<Z> zs = zFactory.createBatch(3, [](std::size_t i) { return int(i) * 2; });
+          Assert(zs.size() == 3);
+          Assert(zs[2].n == 4);
+          Assert(zFactory.createBatch(0, [](std::size_t i) { return int(i); }).empty());
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_factory_ref_create_batch_with_std_function_instance():
+    source = '''
+        struct X {
+          int n;
+        };
+
+        std::function<X(int)> xFunction = [](int n) { return X{n * 3}; };
+
+        fruit::Component<std::function<X(int)>> getComponent() {
+          return fruit::createComponent()
+            .bindInstance(xFunction);
+        }
+
+        int main() {
+          fruit::Injector<std::function<X(int)>> injector(getComponent);
+          fruit::FactoryRef<X(int)> xFactory = injector.get<fruit::FactoryRef<X(int)>>();
+          std::vector<X> xs = xFactory.createBatch(4, [](std::size_t i) { return int(i); });
+          Assert(xs.size() == 4);
+          for (std::size_t i = 0; i < 4; ++i) {
+            Assert(xs[i].n == int(i) * 3);
+          }
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source)
+
+@pytest.mark.parametrize('XPooledFactoryAnnot,X_POOLED_FACTORY_PARAM', [
+    ('std::function<fruit::PooledPtr<X>(int)>',
+     'std::function<fruit::PooledPtr<X>(int)>'),
+    ('fruit::Annotated<Annotation1, std::function<fruit::PooledPtr<X>(int)>>',
+     'ANNOTATED(Annotation1, std::function<fruit::PooledPtr<X>(int)>)'),
+    ('fruit::Annotated<Annotation1, fruit::FactoryRef<fruit::PooledPtr<X>(int)>>',
+     'ANNOTATED(Annotation1, fruit::FactoryRef<fruit::PooledPtr<X>(int)>)'),
+])
+def test_register_factory_pooled_autoinject(XPooledFactoryAnnot, X_POOLED_FACTORY_PARAM):
+    source = '''
+        struct Y {
+          INJECT(Y()) = default;
+          int value = 5;
+        };
+
+        struct X {
+          Y* y;
+          int n;
+
+          INJECT(X(Y* y, ASSISTED(int) n))
+            : y(y), n(n) {
+          }
+
+          ~X() {
+            ++num_objects_destroyed;
+          }
+
+          static int num_objects_destroyed;
+        };
+
+        int X::num_objects_destroyed = 0;
+
+        struct Z {
+          std::function<fruit::PooledPtr<X>(int)> xFactory;
+
+          INJECT(Z(X_POOLED_FACTORY_PARAM xFactory))
+            : xFactory(xFactory) {
+          }
+        };
+
+        fruit::Component<Z> getComponent() {
+          return fruit::createComponent();
+        }
+
+        int main() {
+          fruit::Injector<Z> injector(getComponent);
+          Z* z = injector.get<Z*>();
+          X* p;
+          {
+            fruit::PooledPtr<X> x1 = z->xFactory(3);
+            fruit::PooledPtr<X> x2 = z->xFactory(4);
+            Assert(x1->y->value == 5);
+            Assert(x1->n == 3);
+            Assert(x2->n == 4);
+            Assert(x1.get() != x2.get());
+            p = x1.get();
+          }
+          Assert(X::num_objects_destroyed == 2);
+
+          // The slots of the destroyed objects are reused.
+          fruit::PooledPtr<X> x3 = z->xFactory(6);
+          fruit::PooledPtr<X> x4 = z->xFactory(7);
+          Assert(x3.get() == p || x4.get() == p);
+          Assert(x3->n == 6);
+          Assert(x4->n == 7);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+def test_register_factory_pooled_constructs_in_place():
+    source = '''
+        struct X {
+          int n;
+
+          INJECT(X(ASSISTED(int) n))
+            : n(n) {
+#if __cpp_exceptions
+            if (n < 0) {
+              throw 42;
+            }
+#endif
+          }
+
+          X(X&& other)
+            : n(other.n) {
+            ++num_moves;
+          }
+
+          static int num_moves;
+        };
+
+        int X::num_moves = 0;
+
+        fruit::Component<std::function<fruit::PooledPtr<X>(int)>> getComponent() {
+          return fruit::createComponent();
+        }
+
+        int main() {
+          fruit::Injector<std::function<fruit::PooledPtr<X>(int)>> injector(getComponent);
+          std::function<fruit::PooledPtr<X>(int)> xFactory(injector);
+          X* p;
+          {
+            fruit::PooledPtr<X> x = xFactory(3);
+            Assert(x->n == 3);
+            p = x.get();
+          }
+          Assert(X::num_moves == 0);
+
+#if __cpp_exceptions
+          // The slot allocated for an object whose constructor threw is reused.
+          bool thrown = false;
+          try {
+            xFactory(-1);
+          } catch (int) {
+            thrown = true;
+          }
+          Assert(thrown);
+          fruit::PooledPtr<X> x1 = xFactory(4);
+          fruit::PooledPtr<X> x2 = xFactory(5);
+          Assert(x1.get() == p || x2.get() == p);
+#endif
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+@pytest.mark.parametrize('XAnnot,XPooledFactoryAnnot', [
+    ('X',
+     'std::function<fruit::PooledPtr<X>(int)>'),
+    ('fruit::Annotated<Annotation1, X>',
+     'fruit::Annotated<Annotation1, std::function<fruit::PooledPtr<X>(int)>>'),
+])
+def test_register_factory_pooled_with_explicit_factory(XAnnot, XPooledFactoryAnnot):
+    source = '''
+        struct Y {
+          INJECT(Y()) = default;
+        };
+
+        struct alignas(64) X {
+          Y* y;
+          int n;
+
+          X(Y* y, int n)
+            : y(y), n(n) {
+          }
+          X(X&&) = default;
+          X(const X&) = delete;
+        };
+
+        fruit::Component<XPooledFactoryAnnot> getComponent() {
+          return fruit::createComponent()
+            .registerFactory<XAnnot(Y*, fruit::Assisted<int>)>([](Y* y, int n) { return X(y, n); });
+        }
+
+        int main() {
+          fruit::Injector<XPooledFactoryAnnot> injector(getComponent);
+          std::function<fruit::PooledPtr<X>(int)> xFactory = injector.get<XPooledFactoryAnnot>();
+          std::vector<fruit::PooledPtr<X>> xs;
+          for (int i = 0; i < 100; ++i) {
+            xs.push_back(xFactory(i));
+          }
+          for (int i = 0; i < 100; ++i) {
+            Assert(xs[i]->n == i);
+            Assert(xs[i]->y == xs[0]->y);
+            Assert(std::uintptr_t(xs[i].get()) % 64 == 0);
+          }
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
 @pytest.mark.parametrize('ScalerAnnot,ScalerImplAnnot,ScalerFactoryAnnot', [
     ('Scaler',
      'ScalerImpl',
@@ -1011,6 +1269,135 @@ def test_register_factory_with_different_annotation():
         source)
 
 
+@pytest.mark.parametrize('XFactoryAnnot,XFactoryRefAnnot,X_FACTORY_REF_PARAM,XAnnot', [
+    ('std::function<X(int)>',
+     'fruit::FactoryRef<X(int)>',
+     'fruit::FactoryRef<X(int)>',
+     'X'),
+    ('fruit::Annotated<Annotation1, std::function<X(int)>>',
+     'fruit::Annotated<Annotation1, fruit::FactoryRef<X(int)>>',
+     'ANNOTATED(Annotation1, fruit::FactoryRef<X(int)>)',
+     'fruit::Annotated<Annotation1, X>'),
+])
+def test_register_factory_injected_as_factory_ref(XFactoryAnnot, XFactoryRefAnnot, X_FACTORY_REF_PARAM, XAnnot):
+    source = '''
+        struct Y {
+          INJECT(Y()) = default;
+          int value = 5;
+        };
+
+        struct X {
+          Y* y;
+          int n;
+
+          X(Y* y, int n)
+            : y(y), n(n) {
+          }
+        };
+
+        struct Z {
+          fruit::FactoryRef<X(int)> xFactory;
+
+          INJECT(Z(X_FACTORY_REF_PARAM xFactory))
+            : xFactory(xFactory) {
+          }
+        };
+
+        fruit::Component<Z, XFactoryAnnot> getComponent() {
+          return fruit::createComponent()
+            .registerFactory<XAnnot(Y*, fruit::Assisted<int>)>([](Y* y, int n) { return X(y, n); });
+        }
+
+        int main() {
+          fruit::Injector<Z, XFactoryAnnot> injector(getComponent);
+          Z* z = injector.get<Z*>();
+          X x1 = z->xFactory(3);
+          Assert(x1.y->value == 5);
+          Assert(x1.n == 3);
+
+          fruit::FactoryRef<X(int)> xFactory = injector.get<XFactoryRefAnnot>();
+          X x2 = xFactory(4);
+          Assert(x2.y == x1.y);
+          Assert(x2.n == 4);
+
+          std::function<X(int)> xFunction = injector.get<XFactoryAnnot>();
+          Assert(xFunction(6).n == 6);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+@pytest.mark.parametrize('XFactoryAnnot,XFactoryRefAnnot', [
+    ('std::function<std::unique_ptr<X>(int)>',
+     'fruit::FactoryRef<std::unique_ptr<X>(int)>'),
+    ('fruit::Annotated<Annotation1, std::function<std::unique_ptr<X>(int)>>',
+     'fruit::Annotated<Annotation1, fruit::FactoryRef<std::unique_ptr<X>(int)>>'),
+])
+def test_factory_ref_for_bound_std_function(XFactoryAnnot, XFactoryRefAnnot):
+    source = '''
+        struct X {
+          int n;
+        };
+
+        std::function<std::unique_ptr<X>(int)> xFunction = [](int n) {
+          return std::unique_ptr<X>(new X{n});
+        };
+
+        fruit::Component<XFactoryAnnot> getComponent() {
+          return fruit::createComponent()
+            .bindInstance<XFactoryAnnot, std::function<std::unique_ptr<X>(int)>>(xFunction);
+        }
+
+        int main() {
+          fruit::Injector<XFactoryAnnot> injector(getComponent);
+          fruit::FactoryRef<std::unique_ptr<X>(int)> xFactory = injector.get<XFactoryRefAnnot>();
+          Assert(xFactory(3)->n == 3);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+@pytest.mark.parametrize('X_FACTORY_REF_PARAM', [
+    'fruit::FactoryRef<std::unique_ptr<X>(int)>',
+    'ANNOTATED(Annotation1, fruit::FactoryRef<std::unique_ptr<X>(int)>)',
+])
+def test_factory_ref_autoinject(X_FACTORY_REF_PARAM):
+    source = '''
+        struct X {
+          int n;
+
+          INJECT(X(ASSISTED(int) n))
+            : n(n) {
+          }
+        };
+
+        struct Z {
+          fruit::FactoryRef<std::unique_ptr<X>(int)> xFactory;
+
+          INJECT(Z(X_FACTORY_REF_PARAM xFactory))
+            : xFactory(xFactory) {
+          }
+        };
+
+        fruit::Component<Z> getComponent() {
+          return fruit::createComponent();
+        }
+
+        int main() {
+          fruit::Injector<Z> injector(getComponent);
+          Z* z = injector.get<Z*>();
+          Assert(z->xFactory(3)->n == 3);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
 @pytest.mark.parametrize('ScalerAnnot,ScalerImplAnnot,ScalerFactoryAnnot', [
     ('Scaler',
      'ScalerImpl',
@@ -181,6 +181,82 @@ def test_register_provider_error_returned_nullptr(XAnnot, XPtrAnnot, XAnnotRegex
         source,
         locals())
 
+@pytest.mark.parametrize('WithAnnot', [
+    'WithNoAnnot',
+    'WithAnnot1',
+])
+def test_register_provider_emplacer_success(WithAnnot):
+    source = '''
+        struct Y {
+          int value = 5;
+        };
+
+        struct X {
+          X(Y* y, int n) : value(y->value + n) {}
+          X(X&&) = delete;
+          X(const X&) = delete;
+          ~X() {
+            ++num_objects_destroyed;
+          }
+
+          int value;
+          static int num_objects_destroyed;
+        };
+
+        int X::num_objects_destroyed = 0;
+
+        fruit::Component<WithAnnot<X>> getComponent() {
+          return fruit::createComponent()
+            .registerProvider([](){return Y();})
+            .registerProvider<WithAnnot<X>(Y*)>([](fruit::Emplacer<X> emplace, Y* y) {
+              X* x = emplace(y, 10);
+              x->value++;
+              return x;
+            });
+        }
+
+        int main() {
+          {
+            fruit::Injector<WithAnnot<X>> injector(getComponent);
+            X* x = injector.get<WithAnnot<X*>>();
+            Assert(x->value == 16);
+            Assert(injector.get<WithAnnot<X*>>() == x);
+          }
+          Assert(X::num_objects_destroyed == 1);
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
+@pytest.mark.parametrize('XAnnot,XPtrAnnot,XAnnotRegex', [
+    ('X', 'X*', '(struct )?X'),
+    ('fruit::Annotated<Annotation1, X>', 'fruit::Annotated<Annotation1, X*>', '(struct )?fruit::Annotated<(struct )?Annotation1, ?(struct )?X>'),
+])
+def test_register_provider_emplacer_error_returned_other_pointer(XAnnot, XPtrAnnot, XAnnotRegex):
+    source = '''
+        struct X {};
+
+        fruit::Component<XAnnot> getComponent() {
+          return fruit::createComponent()
+              .registerProvider<XAnnot()>([](fruit::Emplacer<X>) {
+                static X x;
+                return &x;
+              });
+        }
+
+        int main() {
+          fruit::Injector<XAnnot> injector(getComponent);
+          injector.get<XPtrAnnot>();
+        }
+        '''
+    expect_runtime_error(
+        'Fatal injection error: attempting to get an instance for the type XAnnotRegex but the provider returned a pointer that wasn.t constructed with its fruit::Emplacer',
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
 @pytest.mark.parametrize('ConstructX,XPtr', [
     ('X()', 'X'),
     ('new X()', 'X*'),
@@ -56,5 +56,52 @@ def test_everything():
         source,
         locals())
 
+def test_isolated_in_cache_line():
+    source = '''
+        struct Stats1 {
+          int n = 0;
+          INJECT(Stats1()) = default;
+        };
+
+        struct Stats2 {
+          int n = 0;
+          INJECT(Stats2()) = default;
+        };
+
+        namespace fruit {
+        template <>
+        struct IsolatedInCacheLine<Stats1> : public std::true_type {};
+        template <>
+        struct IsolatedInCacheLine<Stats2> : public std::true_type {};
+        }
+
+        std::uintptr_t getCacheLine(const void* p) {
+          return reinterpret_cast<std::uintptr_t>(p) / FRUIT_CACHE_LINE_SIZE;
+        }
+
+        fruit::Component<X, Y, Stats1, Stats2> getComponent() {
+          return fruit::createComponent();
+        }
+
+        int main() {
+          fruit::Injector<X, Y, Stats1, Stats2> injector(getComponent);
+
+          X* x = injector.get<X*>();
+          Stats1* stats1 = injector.get<Stats1*>();
+          Stats2* stats2 = injector.get<Stats2*>();
+          Y* y = injector.get<Y*>();
+
+          Assert(reinterpret_cast<std::uintptr_t>(stats1) % FRUIT_CACHE_LINE_SIZE == 0);
+          Assert(reinterpret_cast<std::uintptr_t>(stats2) % FRUIT_CACHE_LINE_SIZE == 0);
+          Assert(getCacheLine(x) != getCacheLine(stats1));
+          Assert(getCacheLine(stats1) != getCacheLine(stats2));
+          Assert(getCacheLine(stats2) != getCacheLine(y));
+        }
+        '''
+    expect_success(
+        COMMON_DEFINITIONS,
+        source,
+        locals())
+
 if __name__== '__main__':
     main(__file__)